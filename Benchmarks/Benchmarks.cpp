@@ -0,0 +1,578 @@
+///////////////////////////////////////////////////////////////////////////
+// Benchmarks.cpp : times the publisher's kernels - see Benchmarks.h     //
+// ver 1.2                                                               //
+//                                                                       //
+// Author:      Sneha Giranje					                         //
+///////////////////////////////////////////////////////////////////////////
+
+#include "Benchmarks.h"
+#include "../CppParser/PerfStats/MemStats.h"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <cmath>
+
+namespace Benchmarks
+{
+	namespace
+	{
+		volatile size_t sink = 0;
+
+		// -----< heap allocations so far, in all stages >--------------------
+		void heapCounts(uint64_t& allocations, uint64_t& bytes)
+		{
+			allocations = bytes = 0;
+			for (size_t stage = 0; stage <= PerfStats::stageCount; ++stage)
+			{
+				PerfStats::MemStats::StageMemory memory =
+					PerfStats::MemStats::instance().stage(PerfStats::Stage(stage));
+				allocations += memory.allocations;
+				bytes += memory.bytesAllocated;
+			}
+		}
+	}
+
+	void keep(size_t value)
+	{
+		sink = sink + value;
+	}
+
+	// -----< QuietCout - swaps std::cout's buffer for one that discards >----
+	QuietCout::QuietCout() : pSaved_(std::cout.rdbuf(&null_)) {}
+
+	QuietCout::~QuietCout()
+	{
+		std::cout.rdbuf(pSaved_);
+	}
+
+	// -----< Runner ctor - at least one timed iteration >--------------------
+	Runner::Runner(size_t warmups, size_t iterations)
+		: warmups_(warmups), iterations_(std::max<size_t>(iterations, 1)) {}
+
+	void Runner::filter(const std::string& text)
+	{
+		filter_ = text;
+	}
+
+	bool Runner::selected(const std::string& name) const
+	{
+		return filter_.size() == 0 || name.find(filter_) != std::string::npos;
+	}
+
+	// -----< warm up, then keep one sample per iteration >------------------
+	/* returns false when the filter skips the benchmark */
+	bool Runner::run(const std::string& name, const Kernel& kernel,
+		uint64_t items, const std::string& unit)
+	{
+		if (!selected(name))
+			return false;
+		Result result;
+		result.name = name;
+		result.unit = unit;
+		result.items = items;
+		result.warmups = warmups_;
+		for (size_t i = 0; i < warmups_; ++i)
+			kernel();
+		result.samplesNs.reserve(iterations_);
+		uint64_t allocations = 0, bytes = 0;
+		for (size_t i = 0; i < iterations_; ++i)
+		{
+			heapCounts(allocations, bytes);
+			result.samplesNs.push_back(kernel());
+			heapCounts(result.allocations, result.allocatedBytes);
+			result.allocations -= allocations;
+			result.allocatedBytes -= bytes;
+		}
+		summarize(result);
+		results_.push_back(std::move(result));
+		return true;
+	}
+
+	const std::vector<Result>& Runner::results() const
+	{
+		return results_;
+	}
+
+	// -----< private - median, mean, variance, min and max of samples >-----
+	void Runner::summarize(Result& result)
+	{
+		std::vector<uint64_t> sorted = result.samplesNs;
+		std::sort(sorted.begin(), sorted.end());
+		size_t n = sorted.size();
+		result.medianNs = n % 2 ? double(sorted[n / 2]) : (sorted[n / 2 - 1] + sorted[n / 2]) / 2.0;
+		result.minNs = double(sorted.front());
+		result.maxNs = double(sorted.back());
+		double sum = 0;
+		for (uint64_t ns : sorted)
+			sum += double(ns);
+		result.meanNs = sum / n;
+		double squares = 0;
+		for (uint64_t ns : sorted)
+			squares += (ns - result.meanNs) * (ns - result.meanNs);
+		result.varianceNs = n > 1 ? squares / (n - 1) : 0;
+	}
+
+	// -----< table of results, for people >---------------------------------
+	void Runner::show(std::ostream& out) const
+	{
+		std::ios::fmtflags flags = out.flags();
+		std::streamsize precision = out.precision();
+		out << std::fixed << std::setprecision(3);
+		out << "\n  " << std::left << std::setw(32) << "benchmark" << std::right
+			<< std::setw(12) << "median ms" << std::setw(10) << "stddev %"
+			<< std::setw(12) << "min ms" << std::setw(12) << "max ms";
+		if (PerfStats::allocationsTracked())
+			out << std::setw(14) << "allocations" << std::setw(12) << "heap MB";
+		out << std::setw(16) << "rate";
+		for (const Result& result : results_)
+		{
+			double stddev = std::sqrt(result.varianceNs);
+			out << "\n  " << std::left << std::setw(32) << result.name << std::right
+				<< std::setw(12) << result.medianNs / 1e6
+				<< std::setw(10) << std::setprecision(1) << (result.medianNs > 0 ? 100 * stddev / result.medianNs : 0)
+				<< std::setprecision(3)
+				<< std::setw(12) << result.minNs / 1e6
+				<< std::setw(12) << result.maxNs / 1e6;
+			if (PerfStats::allocationsTracked())
+				out << std::setw(14) << result.allocations << std::setw(12) << result.allocatedBytes / 1e6;
+			if (result.items > 0 && result.medianNs > 0)
+			{
+				double perSec = result.items / (result.medianNs / 1e9);
+				if (result.unit == "bytes")
+					out << std::setw(11) << std::setprecision(1) << perSec / 1e6 << " MB/s";
+				else
+					out << std::setw(11) << std::setprecision(0) << perSec << " " << result.unit << "/s";
+				out << std::setprecision(3);
+			}
+		}
+		out << "\n";
+		out.flags(flags);
+		out.precision(precision);
+	}
+
+	// -----< results as JSON, one benchmark per line >----------------------
+	void Runner::writeJson(std::ostream& out) const
+	{
+		std::ios::fmtflags flags = out.flags();
+		std::streamsize precision = out.precision();
+		out << std::fixed << std::setprecision(1);
+#ifdef NDEBUG
+		out << "{\n  \"build\": \"release\",";
+#else
+		out << "{\n  \"build\": \"debug\",";
+#endif
+		out << "\n  \"warmups\": " << warmups_ << ",\n  \"iterations\": " << iterations_
+			<< ",\n  \"benchmarks\": [";
+		for (size_t i = 0; i < results_.size(); ++i)
+		{
+			const Result& result = results_[i];
+			out << (i == 0 ? "\n" : ",\n");
+			out << "    { \"name\": \"" << result.name << "\", \"unit\": \"" << result.unit
+				<< "\", \"items\": " << result.items
+				<< ", \"medianNs\": " << result.medianNs
+				<< ", \"meanNs\": " << result.meanNs
+				<< ", \"varianceNs\": " << result.varianceNs
+				<< ", \"stddevNs\": " << std::sqrt(result.varianceNs)
+				<< ", \"minNs\": " << result.minNs
+				<< ", \"maxNs\": " << result.maxNs
+				<< ", \"itemsPerSec\": " << (result.medianNs > 0 ? result.items / (result.medianNs / 1e9) : 0)
+				<< ", \"allocations\": " << result.allocations
+				<< ", \"allocatedBytes\": " << result.allocatedBytes
+				<< ", \"samplesNs\": [";
+			for (size_t j = 0; j < result.samplesNs.size(); ++j)
+				out << (j == 0 ? "" : ", ") << result.samplesNs[j];
+			out << "] }";
+		}
+		out << "\n  ]\n}\n";
+		out.flags(flags);
+		out.precision(precision);
+	}
+
+	bool Runner::writeJson(const std::string& path) const
+	{
+		std::ofstream out(path);
+		if (!out.good())
+			return false;
+		writeJson(out);
+		return out.good();
+	}
+
+	// -----< medians of a file written by writeJson >-----------------------
+	/* relies on writeJson's one-benchmark-per-line layout; an unreadable
+	   file gives an empty baseline */
+	Runner::Baseline Runner::readBaseline(const std::string& path)
+	{
+		Baseline baseline;
+		std::ifstream in(path);
+		std::string line;
+		const std::string nameKey = "\"name\": \"";
+		const std::string medianKey = "\"medianNs\": ";
+		while (std::getline(in, line))
+		{
+			size_t namePos = line.find(nameKey);
+			size_t medianPos = line.find(medianKey);
+			if (namePos == std::string::npos || medianPos == std::string::npos)
+				continue;
+			namePos += nameKey.size();
+			size_t nameEnd = line.find('"', namePos);
+			std::istringstream median(line.substr(medianPos + medianKey.size()));
+			double medianNs = 0;
+			if (nameEnd != std::string::npos && (median >> medianNs))
+				baseline[line.substr(namePos, nameEnd - namePos)] = medianNs;
+		}
+		return baseline;
+	}
+
+	// -----< each median against the baseline's >---------------------------
+	/* negative change is faster; the noise column is the current run's
+	   relative standard deviation, below which a change means little */
+	void Runner::compare(const Baseline& baseline, std::ostream& out) const
+	{
+		std::ios::fmtflags flags = out.flags();
+		std::streamsize precision = out.precision();
+		out << std::fixed << std::setprecision(3);
+		out << "\n  " << std::left << std::setw(32) << "benchmark" << std::right
+			<< std::setw(14) << "baseline ms" << std::setw(12) << "median ms"
+			<< std::setw(10) << "change" << std::setw(9) << "noise";
+		for (const Result& result : results_)
+		{
+			out << "\n  " << std::left << std::setw(32) << result.name << std::right;
+			auto iter = baseline.find(result.name);
+			if (iter == baseline.end() || iter->second <= 0)
+			{
+				out << std::setw(14) << "-" << std::setw(12) << result.medianNs / 1e6;
+				continue;
+			}
+			double change = 100 * (result.medianNs - iter->second) / iter->second;
+			double noise = result.medianNs > 0 ? 100 * std::sqrt(result.varianceNs) / result.medianNs : 0;
+			out << std::setw(14) << iter->second / 1e6 << std::setw(12) << result.medianNs / 1e6
+				<< std::setprecision(1) << std::setw(9) << std::showpos << change << "%"
+				<< std::noshowpos << std::setw(8) << noise << "%" << std::setprecision(3);
+		}
+		out << "\n";
+		out.flags(flags);
+		out.precision(precision);
+	}
+}
+
+#ifdef TEST_BENCHMARKS
+
+#include "../Converter/Converter.h"
+#include "../Loader/Loader.h"
+#include "../CppParser/FileSystem/FileSystem.h"
+#include "../DependencyTable/DependencyTable.h"
+#include "../CppParser/Parser/ConfigureParser.h"
+#include "../CppParser/Parser/ActionsAndRules.h"
+#include "../CppParser/SemiExpression/Semi.h"
+#include "../CppParser/Tokenizer/Toker.h"
+#include "../CppParser/PerfStats/PerfStats.h"
+
+using namespace Benchmarks;
+using namespace CodeAnalysis;
+
+#ifdef _WIN32
+const char* nullDevice = "NUL";
+#else
+const char* nullDevice = "/dev/null";
+#endif
+
+///////////////////////////////////////////////////////////////////////////
+// ConverterBenchmarks class
+// - friend of CodeConverter, to time its private escaping and highlighting
+
+class ConverterBenchmarks
+{
+public:
+	// -----< appendEscaped over a file's tokens, a line at a time >--------
+	static uint64_t escape(const std::vector<std::string>& toks)
+	{
+		QuietCout quiet;
+		CodeConverter cc;
+		std::string line;
+		size_t chars = 0;
+		uint64_t ns = timeNs([&]() {
+			for (const std::string& tok : toks)
+			{
+				if (tok == "\n")
+				{
+					chars += line.size();
+					line.clear();
+				}
+				else
+					cc.appendEscaped(line, tok);
+			}
+		});
+		keep(chars + line.size());
+		return ns;
+	}
+
+	// -----< highlight pass of convertFile, writing to the null device >---
+	/* the scope parse and opening the toker are not timed */
+	static uint64_t highlight(const std::vector<std::string>& files)
+	{
+		QuietCout quiet;
+		CodeConverter cc;
+		std::filebuf nullPage;
+		nullPage.open(nullDevice, std::ios::out);
+		cc.out_.rdbuf(&nullPage);
+		uint64_t ns = 0;
+		for (const std::string& file : files)
+		{
+			Scopes scopes = cc.getScopes(file);
+			Lexer::Toker toker;
+			toker.doReturnComments(true);
+			toker.doReturnWhiteSpace(true);
+			if (!toker.open(file))
+				continue;
+			ns += timeNs([&]() { cc.highlight(toker, file, scopes); });
+		}
+		cc.out_.rdbuf(nullptr);
+		return ns;
+	}
+
+	// -----< table and page list handling of convert(), for every file >--
+	/* the converter shares the table, links each file's dependencies into
+	   a stream with no buffer and lists its page, as convertFile does, but no
+	   file is parsed, read or written */
+	static uint64_t publish(const DependencyTable& table, const std::vector<std::string>& files)
+	{
+		QuietCout quiet;
+		size_t pages = 0;
+		uint64_t ns = timeNs([&]() {
+			CodeConverter cc;
+			cc.setDepTable(table);
+			cc.setPages(files);
+			for (const auto& entry : cc.dt_)
+			{
+				cc.addDependencyLinks(entry.first);
+				cc.convertedFiles_.push_back(cc.outputDir_ + FileSystem::Path::getName(entry.first) + ".html");
+			}
+			pages = cc.convertedFiles().size();
+		});
+		keep(pages);
+		return ns;
+	}
+};
+
+// -----< all tokens of a file, comments, whitespace and newlines too >------
+std::vector<std::string> tokensOf(const std::string& file)
+{
+	QuietCout quiet;
+	std::vector<std::string> toks;
+	Lexer::Toker toker;
+	toker.doReturnComments(true);
+	toker.doReturnWhiteSpace(true);
+	if (!toker.open(file))
+		return toks;
+	while (!toker.isDone())
+		toks.push_back(toker.getTok());
+	return toks;
+}
+
+// -----< Toker::getTok over whole files >-----------------------------------
+uint64_t tokerKernel(const std::vector<std::string>& files)
+{
+	QuietCout quiet;
+	uint64_t ns = 0;
+	size_t chars = 0;
+	for (const std::string& file : files)
+	{
+		Lexer::Toker toker;
+		if (!toker.open(file))
+			continue;
+		ns += timeNs([&]() {
+			while (!toker.isDone())
+				chars += toker.getTok().size();
+		});
+	}
+	keep(chars);
+	return ns;
+}
+
+// -----< Semi::get over whole files >---------------------------------------
+uint64_t semiKernel(const std::vector<std::string>& files)
+{
+	QuietCout quiet;
+	uint64_t ns = 0;
+	size_t toks = 0;
+	for (const std::string& file : files)
+	{
+		Lexer::Semi semi(true);
+		if (!semi.open(file))
+			continue;
+		ns += timeNs([&]() {
+			while (!semi.isDone())
+			{
+				semi.get();
+				toks += semi.size();
+			}
+		});
+	}
+	keep(toks);
+	return ns;
+}
+
+// -----< Parser::parse, streaming scopes as the converter does >------------
+/* only the parse() calls are timed, not the next() that collects each
+   semi-expression */
+uint64_t parseKernel(const std::vector<std::string>& files)
+{
+	QuietCout quiet;
+	uint64_t ns = 0;
+	for (const std::string& file : files)
+	{
+		Scopes scopes;
+		ParserPool::Lease lease = ParserPool::forThisThread().acquire();
+		Parser* pParser = lease->parser();
+		if (pParser == nullptr || !lease->Attach(file))
+			continue;
+		ScopeListener listener(scopes, allScopes);
+		lease->repository()->listener(&listener);
+		while (pParser->next())
+			ns += timeNs([&]() { pParser->parse(); });
+		lease->repository()->endOfFile();
+		keep(scopes.size());
+	}
+	return ns;
+}
+
+// -----< Loader::match_regexes on a copy of a searched loader >-------------
+uint64_t matchKernel(const FileSystem::Loader& searched, const std::vector<std::string>& regexes)
+{
+	QuietCout quiet;
+	FileSystem::Loader loader = searched;
+	uint64_t ns = timeNs([&]() { keep(loader.match_regexes(regexes)); });
+	keep(loader.filesList().size());
+	return ns;
+}
+
+// -----< DependencyTable::addDependency into an empty table >---------------
+uint64_t dependencyKernel(const std::vector<std::pair<std::string, std::string>>& deps)
+{
+	QuietCout quiet;
+	DependencyTable dt;
+	uint64_t ns = timeNs([&]() {
+		for (const auto& dep : deps)
+			dt.addDependency(dep.first, dep.second);
+	});
+	keep(dt.getFiles().size());
+	return ns;
+}
+
+// -----< files with a fan-out of includes, a quarter of them repeated >-----
+std::vector<std::pair<std::string, std::string>> dependencies(size_t files, size_t fanOut)
+{
+	std::vector<std::pair<std::string, std::string>> deps;
+	for (size_t i = 0; i < files; ++i)
+	{
+		std::string file = "../Package" + std::to_string(i) + "/Package" + std::to_string(i) + ".cpp";
+		for (size_t j = 0; j < fanOut; ++j)
+		{
+			size_t target = (i * 31 + (j % (fanOut - fanOut / 4)) * 17) % files;
+			deps.push_back({ file, "../Package" + std::to_string(target) + "/Package" + std::to_string(target) + ".h" });
+		}
+	}
+	return deps;
+}
+
+// -----< test stub - runs every kernel, or those matching /f >---------------
+int main(int argc, char* argv[])
+{
+	size_t warmups = 3, iterations = 15, publishFiles = 100000;
+	std::string filter, outPath = "benchmarks.json", baselinePath, root = "../";
+	std::vector<std::string> files;
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		if (arg == "/n" && hasValue)
+			iterations = std::stoul(argv[++i]);
+		else if (arg == "/w" && hasValue)
+			warmups = std::stoul(argv[++i]);
+		else if (arg == "/f" && hasValue)
+			filter = argv[++i];
+		else if (arg == "/o" && hasValue)
+			outPath = argv[++i];
+		else if (arg == "/b" && hasValue)
+			baselinePath = argv[++i];
+		else if (arg == "/r" && hasValue)
+			root = argv[++i];
+		else if (arg == "/p" && hasValue)
+			publishFiles = std::stoul(argv[++i]);
+		else
+			files.push_back(arg);
+	}
+	if (files.size() == 0)
+		files = { "../Converter/Converter.cpp", "../CppParser/Parser/ActionsAndRules.h",
+			"../CppParser/Tokenizer/Toker.cpp", "../DependencyTable/DependencyTable.cpp" };
+
+	uint64_t bytes = 0;
+	for (const std::string& file : files)
+		bytes += PerfStats::fileSize(file);
+	std::cout << "\n  Benchmarking " << files.size() << " files, " << bytes << " bytes, "
+		<< warmups << " warmups and " << iterations << " iterations each";
+
+	Runner runner(warmups, iterations);
+	runner.filter(filter);
+
+	runner.run("toker.getTok", [&]() { return tokerKernel(files); }, bytes);
+	runner.run("semi.get", [&]() { return semiKernel(files); }, bytes);
+	runner.run("parser.parse", [&]() { return parseKernel(files); }, bytes);
+
+	if (runner.selected("converter.appendEscaped"))
+	{
+		std::vector<std::string> toks;
+		for (const std::string& file : files)
+		{
+			std::vector<std::string> fileToks = tokensOf(file);
+			toks.insert(toks.end(), fileToks.begin(), fileToks.end());
+		}
+		runner.run("converter.appendEscaped", [&]() { return ConverterBenchmarks::escape(toks); }, bytes);
+	}
+	runner.run("converter.highlight", [&]() { return ConverterBenchmarks::highlight(files); }, bytes);
+
+	if (runner.selected("loader.match_regexes"))
+	{
+		QuietCout quiet;
+		FileSystem::Loader loader(root);
+		loader.addPattern("*.h");
+		loader.addPattern("*.cpp");
+		loader.recurse();
+		loader.search();
+		std::vector<std::string> regexes = { "[A-C](.*)", "(.*)Table(.*)", "(.*)Parser(.*)" };
+		size_t count = loader.filesList().size();
+		runner.run("loader.match_regexes", [&]() { return matchKernel(loader, regexes); }, count, "files");
+	}
+
+	std::vector<std::pair<std::string, std::string>> deps = dependencies(500, 8);
+	runner.run("dependencyTable.addDependency", [&]() { return dependencyKernel(deps); }, deps.size(), "deps");
+
+	if (runner.selected("publish.tables"))
+	{
+		QuietCout quiet;
+		DependencyTable table;
+		std::vector<std::string> published;
+		for (const auto& dep : dependencies(publishFiles, 8))
+		{
+			if (!table.has(dep.first))
+				published.push_back(dep.first);
+			table.addDependency(dep.first, dep.second);
+		}
+		for (size_t i = 0; i < publishFiles; ++i)
+			published.push_back("../Package" + std::to_string(i) + "/Package" + std::to_string(i) + ".h");
+		runner.run("publish.tables", [&]() { return ConverterBenchmarks::publish(table, published); },
+			publishFiles, "files");
+	}
+
+	runner.show(std::cout);
+	if (baselinePath.size() > 0)
+		runner.compare(Runner::readBaseline(baselinePath), std::cout);
+	if (runner.writeJson(outPath))
+		std::cout << "\n  Results written to: " << outPath << "\n\n";
+	else
+		std::cout << "\n  Error -- unable to write results to " << outPath << "\n\n";
+	return 0;
+}
+
+#endif
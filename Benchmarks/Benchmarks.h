@@ -0,0 +1,165 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////
+// Benchmarks.h  : repeatable timing of the publisher's hot kernels      //
+// ver 1.2                                                               //
+//                                                                       //
+// Application   : Project Code Publisher                                //
+// Author        : Sneha Giranje                  						 //
+///////////////////////////////////////////////////////////////////////////
+/*
+*  Package Operations:
+* =======================
+*  This package defines a small benchmark Runner and, in Benchmarks.cpp,
+*  the kernels it times: Toker::getTok, Semi::get, Parser::parse, the
+*  CodeConverter escaping and highlighting passes, Loader::match_regexes,
+*  DependencyTable::addDependency, and the handling of the dependency
+*  table and page list in a publish of 100,000 files, without parsing
+*  or writing them.
+*
+*  A kernel does its own setup and returns the nanoseconds spent in the
+*  part being measured, so opening files or copying inputs is not timed.
+*  The Runner calls each kernel a few times to warm caches and the
+*  allocator, discarding those samples, then keeps one sample per
+*  iteration and reports median, mean, variance, min and max.  The
+*  median is the figure to compare; variance tells whether a difference
+*  is larger than the noise of the machine.
+*
+*  In a build with TRACK_ALLOCATIONS defined, see MemStats.h, the Runner
+*  also counts the heap allocations and bytes of one iteration, setup
+*  included, and shows them beside the times.
+*
+*  Results are written as JSON, one benchmark per line, and can be read
+*  back as a baseline: compare() shows each median against the baseline's
+*  so a change can be judged against the tree it started from.
+*
+*  Public Interface:
+* =======================
+*  Benchmarks::Runner runner(warmups, iterations);
+*  runner.run("name", kernel, items, "bytes");  // kernel returns ns timed
+*  runner.show(std::cout);
+*  runner.writeJson(out);
+*  runner.compare(Benchmarks::Runner::readBaseline(path), std::cout);
+*  uint64_t ns = Benchmarks::timeNs([&]() { ... });
+*  Benchmarks::QuietCout quiet;                 // discards std::cout output
+*
+*  Required Files:
+* =======================
+*  Benchmarks.h Benchmarks.cpp Converter.h Converter.cpp Loader.h
+*  Loader.cpp DependencyTable.h DependencyTable.cpp ConfigureParser.h
+*  ConfigureParser.cpp Parser.h Parser.cpp Semi.h Semi.cpp Toker.h
+*  Toker.cpp MemStats.h MemStats.cpp and their dependencies
+*
+*  Build Process:
+* =======================
+*  Build the Benchmarks project in Release; it defines TEST_BENCHMARKS.
+*  Benchmarks [/n iterations] [/w warmups] [/f filter] [/o results.json]
+*             [/b baseline.json] [/r loaderRoot] [/p publishFiles] [files...]
+*
+*  Maintainence History:
+* =======================
+*  ver 1.2 - 19 Oct 2026
+*  - the highlight benchmark gives the converter's page stream a buffer
+*    on the null device, as the stream is no longer a file stream
+*  ver 1.1 - 19 Oct 2026
+*  - added heap allocation counts and the publish.tables benchmark
+*  ver 1.0 - 19 Oct 2026
+*  - first release
+*/
+
+#include <string>
+#include <vector>
+#include <map>
+#include <functional>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <streambuf>
+
+namespace Benchmarks
+{
+	// a kernel returns the nanoseconds spent in its measured part
+	using Kernel = std::function<uint64_t()>;
+
+	struct Result
+	{
+		std::string name;
+		std::string unit;            // what items counts, e.g., bytes
+		uint64_t items = 0;          // processed by one iteration
+		size_t warmups = 0;
+		std::vector<uint64_t> samplesNs;
+		double medianNs = 0;
+		double meanNs = 0;
+		double varianceNs = 0;       // in ns squared
+		double minNs = 0;
+		double maxNs = 0;
+		uint64_t allocations = 0;    // of the last iteration, if tracked
+		uint64_t allocatedBytes = 0;
+	};
+
+	// -----< time a callable, in nanoseconds >------------------------------
+	template<typename F>
+	uint64_t timeNs(F f)
+	{
+		auto start = std::chrono::steady_clock::now();
+		f();
+		return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now() - start).count();
+	}
+
+	// keeps a result alive so the optimizer can't drop the work producing it
+	void keep(size_t value);
+
+	///////////////////////////////////////////////////////////////////////
+	// QuietCout class
+	// - discards what std::cout is given while in scope, for kernels that log
+
+	class QuietCout
+	{
+	public:
+		QuietCout();
+		~QuietCout();
+	private:
+		struct NullBuffer : std::streambuf
+		{
+			int overflow(int ch) override { return traits_type::not_eof(ch); }
+			std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+		};
+		NullBuffer null_;
+		std::streambuf* pSaved_;
+		QuietCout(const QuietCout&) = delete;
+		QuietCout& operator=(const QuietCout&) = delete;
+	};
+
+	///////////////////////////////////////////////////////////////////////
+	// Runner class
+	// - warms up and times kernels, and reports their statistics
+
+	class Runner
+	{
+	public:
+		using Baseline = std::map<std::string, double>;  // name to median ns
+
+		Runner(size_t warmups = 3, size_t iterations = 15);
+
+		void filter(const std::string& text);   // run only names containing text
+		bool selected(const std::string& name) const;
+
+		bool run(const std::string& name, const Kernel& kernel,
+			uint64_t items = 0, const std::string& unit = "bytes");
+		const std::vector<Result>& results() const;
+
+		void show(std::ostream& out) const;
+		void writeJson(std::ostream& out) const;
+		bool writeJson(const std::string& path) const;
+		static Baseline readBaseline(const std::string& path);
+		void compare(const Baseline& baseline, std::ostream& out) const;
+
+	private:
+		static void summarize(Result& result);
+
+		size_t warmups_;
+		size_t iterations_;
+		std::string filter_;
+		std::vector<Result> results_;
+	};
+}
@@ -1,6 +1,6 @@
 ///////////////////////////////////////////////////////////////////////////
 // Converter.cpp : implements and provides test stub for Converter.h     //
-// ver 1.1                                                               //
+// ver 2.5                                                               //
 //                                                                       // 
 // Application   : Project Code Publisher                                //
 // Author        : Sneha Giranje                  						 //
@@ -14,8 +14,14 @@
 #include "../CppParser/Parser/ConfigureParser.h"
 #include "../CppParser/Parser/ActionsAndRules.h"
 #include "../CppParser/Utilities/Utilities.h"
+#include "../CppParser/Tokenizer/Toker.h"
+#include "../CppParser/PerfStats/PerfStats.h"
 #include <iostream>
+#include <fstream>
+#include <sstream>
 #include <algorithm>
+#include <cctype>
+#include <unordered_set>
 
 using namespace FileSystem;
 using namespace CodeAnalysis;
@@ -25,31 +31,48 @@ CodeConverter::CodeConverter()
 {
 }
 
-// -----< ctor to set dep table >-----------------------------------------
+// -----< ctor to set dep table - shares its graph >----------------------
 CodeConverter::CodeConverter(const DependencyTable & dt) : dt_(dt)
 {
 	std::cout << "\n  CodeConverter initialized with DependencyTable\n";
 }
 
-// -----< set dependency table function >---------------------------------
+// -----< set dependency table function - shares its graph >--------------
 void CodeConverter::setDepTable(const DependencyTable & dt)
 {
 	dt_ = dt;
 }
 
+void CodeConverter::setDepTable(DependencyTable && dt)
+{
+	dt_ = std::move(dt);
+}
+
+// -----< set symbol table used for cross-reference links >---------------
+void CodeConverter::setSymbolTable(const SymbolTable & st)
+{
+	st_ = st;
+}
+
+void CodeConverter::setSymbolTable(SymbolTable && st)
+{
+	st_ = std::move(st);
+}
+
 // -----< convert pre-set dependency table >------------------------------
-std::vector<std::string> CodeConverter::convert()
+const std::vector<std::string>& CodeConverter::convert()
 {
+	static const std::vector<std::string> none;
 	if (!createOutpurDir()) {
 		std::cout << "\n\n  Failed to start conversion due to inability to create output directory";
 		std::cout << "\n  -- Output Directory: " + Path::getFullFileSpec(outputDir_);
-		return std::vector<std::string>();
+		return none;
 	}
 
 	std::cout << "\n\n  Converting files to webpages";
 
 	std::cout << "\n  Output directory: " + Path::getFullFileSpec(outputDir_);
-	for (auto entry : dt_) {
+	for (const auto& entry : dt_) {
 		if (convertFile(entry.first)) {
 			std::cout << "\n  -- Converted: ";
 		}
@@ -74,7 +97,7 @@ std::string CodeConverter::convert(const std::string & filepath)
 	}
 
 	std::cout << "\n\n  Converting files to webpages";
-	filesToConvert_.push_back(Path::getName(filepath));
+	pageNames_.insert(Path::getName(filepath));
 	std::cout << "\n  Output directory: " + Path::getFullFileSpec(outputDir_);
 
 	if (convertFile(filepath)) {
@@ -90,14 +113,24 @@ std::string CodeConverter::convert(const std::string & filepath)
 	return filename + ".html";
 }
 
-std::vector<std::string> CodeConverter::convert(const std::vector<std::string>& files)
+const std::vector<std::string>& CodeConverter::convert(const std::vector<std::string>& files)
 {
 	clear();
 	dt_ = DependencyTable(files);
-	filesToConvert_ = files;
+	st_ = SymbolTable(files);
+	setPages(files);
 	return convert();
 }
 
+// -----< private - names of the pages dependency links may point to >---
+void CodeConverter::setPages(const std::vector<std::string>& files)
+{
+	pageNames_.clear();
+	pageNames_.reserve(files.size());
+	for (const auto& file : files)
+		pageNames_.insert(Path::getName(file));
+}
+
 // -----< get set output directory >----------------------------------------
 const std::string & CodeConverter::outputDir() const
 {
@@ -110,6 +143,17 @@ void CodeConverter::outputDir(const std::string & dir)
 	outputDir_ = dir;
 }
 
+// -----< output directory moved to dir, with its pages >------------------
+/* the list of converted files is changed to name the pages there */
+void CodeConverter::outputMoved(const std::string & dir)
+{
+	for (auto& page : convertedFiles_) {
+		if (page.compare(0, outputDir_.size(), outputDir_) == 0)
+			page = dir + page.substr(outputDir_.size());
+	}
+	outputDir_ = dir;
+}
+
 // -----< create output directory >-----------------------------------------
 /* returns success of creation. it could fail if dir is sys protected */
 bool CodeConverter::createOutpurDir()
@@ -123,7 +167,7 @@ bool CodeConverter::createOutpurDir()
 }
 
 // -----< get list of converted files >-------------------------------------
-const std::vector<std::string> CodeConverter::convertedFiles() const
+const std::vector<std::string>& CodeConverter::convertedFiles() const
 {
 	return convertedFiles_;
 }
@@ -132,52 +176,230 @@ void CodeConverter::clear()
 {
 	convertedFiles_.clear();
 	dt_.clear();
+	st_.clear();
+	pagesUsing_.clear();
+}
+
+// -----< record the identifiers each page uses, for update >-------------
+void CodeConverter::keepIdentifiers(bool keep)
+{
+	keepIdentifiers_ = keep;
+	if (!keep)
+		pagesUsing_.clear();
+}
+
+// -----< bring pages up to date with changed and removed files >---------
+/* a changed file not in the dependency table is a new page. Pages of
+  removed files are deleted, and the pages stalePages names are written
+  again. Returns the pages written. */
+std::vector<std::string> CodeConverter::update(const std::vector<std::string>& changed,
+	const std::vector<std::string>& removed)
+{
+	std::vector<std::string> written;
+	if (!Directory::exists(outputDir_) && !Directory::create(outputDir_))
+		return written;
+
+	std::unordered_set<std::string> added;
+	for (const auto& file : changed) {
+		if (!dt_.has(file))
+			added.insert(file);
+	}
+	std::vector<std::string> toWrite = stalePages(changed, removed);
+
+	for (const auto& file : removed) {
+		if (fileNamed(Path::getName(file)).size() > 0)
+			continue;  // the page is another file's now
+		std::string page = pagePath(file);
+		convertedFiles_.erase(std::remove(convertedFiles_.begin(), convertedFiles_.end(), page),
+			convertedFiles_.end());
+		File::remove(page);
+	}
+
+	size_t listed = convertedFiles_.size();
+	std::vector<std::string> addedPages;
+	for (const auto& file : toWrite) {
+		if (!convertFile(file))
+			continue;
+		written.push_back(convertedFiles_.back());
+		if (added.find(file) != added.end())
+			addedPages.push_back(convertedFiles_.back());
+	}
+	convertedFiles_.resize(listed);
+	for (const auto& page : addedPages) {
+		if (std::find(convertedFiles_.begin(), convertedFiles_.end(), page) == convertedFiles_.end())
+			convertedFiles_.push_back(page);
+	}
+	return written;
+}
+
+// -----< take changed and removed files into the tables >----------------
+/* returns the files whose pages are stale: those that changed, those
+  whose dependency links name a page that appeared or went away, and
+  those using a symbol whose definition changed. Only files with an
+  entry in the dependency table - the pages converted or rendered so
+  far - are named. */
+std::vector<std::string> CodeConverter::stalePages(const std::vector<std::string>& changed,
+	const std::vector<std::string>& removed)
+{
+	bool hadSymbols = st_.size() > 0;
+	std::unordered_set<std::string> stale;
+	std::unordered_set<std::string> linkNames;  // of pages that appeared or went away
+	std::vector<std::string> moved;             // symbols defined elsewhere now
+
+	for (const auto& file : removed) {
+		dt_.removeEntry(file);
+		std::vector<std::string> symbols = st_.removeFile(file);
+		moved.insert(moved.end(), symbols.begin(), symbols.end());
+
+		std::string name = Path::getName(file);
+		std::string other = fileNamed(name);
+		if (other.size() > 0)
+			stale.insert(other);   // shared the page's name
+		else if (pageNames_.erase(name) > 0)
+			linkNames.insert(name);
+	}
+
+	for (const auto& file : changed) {
+		if (pageNames_.insert(Path::getName(file)).second)
+			linkNames.insert(Path::getName(file));
+		dt_.removeEntry(file);
+		dt_.getFileDependencies(file);
+		std::vector<std::string> symbols = st_.updateFile(file);
+		moved.insert(moved.end(), symbols.begin(), symbols.end());
+		stale.insert(file);
+	}
+
+	if (linkNames.size() > 0) {
+		for (const auto& entry : dt_) {
+			for (const auto& dep : entry.second) {
+				if (linkNames.find(Path::getName(dep)) != linkNames.end()) {
+					stale.insert(entry.first);
+					break;
+				}
+			}
+		}
+	}
+
+	// line anchors are written only when there are symbols to link
+	bool allPages = (st_.size() > 0) != hadSymbols || (!keepIdentifiers_ && moved.size() > 0);
+	if (allPages) {
+		for (const auto& entry : dt_)
+			stale.insert(entry.first);
+	}
+	else {
+		for (const auto& symbol : moved) {
+			auto iter = pagesUsing_.find(SymbolTable::nameOf(symbol));  // pages note names, not keys
+			if (iter == pagesUsing_.end())
+				continue;
+			for (const auto& file : iter->second) {
+				if (dt_.has(file))  // pages of removed files are left in the index
+					stale.insert(file);
+			}
+		}
+	}
+	return std::vector<std::string>(stale.begin(), stale.end());
+}
+
+// -----< symbol table and page names for files, no pages written >-------
+/* dependencies are parsed by render, for the pages requested */
+void CodeConverter::prepare(const std::vector<std::string>& files)
+{
+	clear();
+	st_ = SymbolTable(files);
+	setPages(files);
+}
+
+// -----< page of a file as a string, not written to the output dir >-----
+/* the file's dependencies are parsed the first time its page is
+  rendered. Returns "" when the file can't be read; the list of
+  converted files is left as it is. */
+std::string CodeConverter::render(const std::string& file)
+{
+	PerfStats::Timer timer(PerfStats::convert, file);
+	if (!dt_.has(file))
+		dt_.getFileDependencies(file);
+	std::stringbuf page;
+	if (!writePage(file, page))
+		return "";
+	return page.str();
+}
+
+// -----< private - a file whose page has the given name, or "" >---------
+std::string CodeConverter::fileNamed(const std::string& name) const
+{
+	for (const auto& entry : dt_) {
+		if (Path::getName(entry.first) == name)
+			return entry.first;
+	}
+	return "";
+}
+
+// -----< private - page written for file >-------------------------------
+std::string CodeConverter::pagePath(const std::string& file) const
+{
+	return outputDir_ + Path::getName(file) + ".html";
 }
 
 // -----< private - read file and create webpage >--------------------------
-bool CodeConverter::convertFile(std::string file)
+bool CodeConverter::convertFile(const std::string& file)
 {
+	PerfStats::Timer timer(PerfStats::convert, file);
 	std::ifstream in(file);
 	if (!in.is_open() || !in.good()) {
 		std::cout << "\n\nError -- unable to read file, path may be invalid.";
 		in.close();
 		return false;
 	}
+	in.close();
 
-	std::string filename = Path::getName(file);
-	std::string outputPath = outputDir_ + filename + ".html";
-	out_.open(outputPath, std::ofstream::out);
-	if (!out_.is_open() || !out_.good()) {
+	std::string outputPath = pagePath(file);
+	std::filebuf page;
+	if (!page.open(outputPath, std::ios::out)) {
 		std::cout << "Error -- unable to open output file for writing.";
-		in.close();
 		return false;
 	}
-	// write everything to file 
-	addPreCodeHTML(filename);
+	bool written = writePage(file, page);
+	page.close();
+	if (!written)
+		return false;
+
+	convertedFiles_.push_back(outputPath);
+	return true;
+}
+
+// -----< private - write the webpage of file to page >-------------------
+bool CodeConverter::writePage(const std::string& file, std::streambuf& page)
+{
+	out_.rdbuf(&page);
+	// write everything to page
+	addPreCodeHTML(Path::getName(file));
 	addDependencyLinks(file);
 
 	addButtons();
 	addPreTag();
-	// vectors to get scope of functions and classes
-	std::vector<std::vector<int>> functionLines = getFunctionLines(file);
-	std::vector<std::vector<int>> classLines = getClassLines(file);
-	int lineCount = 1;
-	while (in.good()) {
-		std::string line;
-		while (std::getline(in, line)) {
-			skipSpecialChars(line);
-			handleComment(line);
-			handleClass(line, lineCount, classLines);
-			handleFunction(line, lineCount, functionLines);
-			out_ << line << std::endl;
-			lineCount++;
-		}
+	// scopes of classes and functions, collected in one parse
+	Scopes scopes = getScopes(file);
+
+	// toker is created after the scope parses, as its states share a static context
+	Lexer::Toker toker;
+	toker.doReturnComments(true);
+	toker.doReturnWhiteSpace(true);
+	if (!toker.open(file)) {
+		std::cout << "\n\nError -- unable to tokenize file.";
+		out_.rdbuf(nullptr);
+		return false;
 	}
+	pageIdentifiers_.clear();
+	{
+		PerfStats::Timer highlightTimer(PerfStats::highlight, file);
+		highlight(toker, file, scopes);
+	}
+	for (const auto& identifier : pageIdentifiers_)
+		pagesUsing_[identifier].insert(file);
 
 	addClosingTags();
-	out_.close();
-
-	convertedFiles_.push_back(outputPath);
+	out_.flush();
+	out_.rdbuf(nullptr);
 	return true;
 }
 
@@ -195,6 +417,10 @@ void CodeConverter::addPreCodeHTML(const std::string& title)
 	out_ << "        font-size: 1.25em;" << std::endl;
 	out_ << "        font-weight: normal;" << std::endl;
 	out_ << "      }" << std::endl;
+	out_ << "      .keyword { color: blue; }" << std::endl;
+	out_ << "      .string { color: brown; }" << std::endl;
+	out_ << "      .comments { color: green; }" << std::endl;
+	out_ << "      .preproc { color: gray; }" << std::endl;
 	out_ << "      </style>" << std::endl;
 	out_ << "		 <script src =\"../script.js\"></script>" << std::endl;
 	out_ << "  </head>" << std::endl << std::endl;
@@ -218,7 +444,7 @@ void CodeConverter::addButtons()
 	out_ << "         </div>" << std::endl;
 }
 // -----< private - add depedency links markup code >----------------------
-void CodeConverter::addDependencyLinks(std::string file)
+void CodeConverter::addDependencyLinks(const std::string& file)
 {
 	std::string filename = Path::getName(file);
 	if (!dt_.has(file)) { // in case of single file conversion
@@ -230,22 +456,12 @@ void CodeConverter::addDependencyLinks(std::string file)
 		std::cout << "\n    No dependencies found for [" + filename + "]. Skipping dependency links..";
 		return;
 	}
-	std::unordered_set<std::string> setFile;
-
-	for (auto f : filesToConvert_) {
-		setFile.insert(Path::getName(f));
-	}
-	std::unordered_set<std::string> ::iterator itr;
 	out_ << "    <h3>Dependencies: " << std::endl;
-	for (auto dep : dt_[file]) {
-		std::string str = Path::getFullFileSpec(dep);
-		//str.pop_back();
-		auto iter = setFile.find(Path::getName(str));
-		if (iter != setFile.end()) {
-			std::string temp = "../ConvertedWebpages/" + Path::getName(str);
-			out_ << "      <a href=\"" << temp << ".html\">" << Path::getName(str) << "</a>" << std::endl;
+	for (const auto& dep : dt_[file]) {
+		std::string name = Path::getName(dep);  // includes are named as written, no need to resolve
+		if (pageNames_.find(name) != pageNames_.end()) {
+			out_ << "      <a href=\"../ConvertedWebpages/" << name << ".html\">" << name << "</a>" << std::endl;
 			out_ << "&nbsp;";
-			//}
 		}
 	}
 	out_ << "    </h3>";
@@ -259,57 +475,193 @@ void CodeConverter::addClosingTags()
 	out_ << "</html>" << std::endl;
 }
 
-// -----< private - replace HTML special chars >---------------------------
-/* note: the function uses while loop to make sure ALL special characters
-  are replaced instead of just the first encounter. */
-void CodeConverter::skipSpecialChars(std::string & line)
+// -----< private - writes html for the token stream of a file >----------
+/* Single pass over the tokens. Whitespace and newlines are returned by the
+  toker, so the source is reproduced exactly. Comments, strings, keywords
+  and preprocessor lines are wrapped in spans with css classes. Comments
+  and preprocessor spans are closed at the end of each line and reopened
+  on the next, so every output line is well formed on its own. */
+void CodeConverter::highlight(Lexer::Toker& toker, const std::string& file,
+	const Scopes& scopes)
 {
-	size_t pos = line.npos;
-	while ((pos = line.find('<')) != line.npos)
-		line.replace(pos, 1, "&lt;");
+	using Lexer::Toker;
+	std::string line;
+	int lineCount = 1;
+	bool lineStart = true;    // only whitespace seen so far on this line
+	bool preproc = false;     // inside a preprocessor directive
+	bool continued = false;   // directive ends with a line continuation
+	std::string before;       // last token other than whitespace or comment
+	std::string qualifier;    // the one before that, X when before is ::
+
+	while (!toker.isDone()) {
+		std::string tok = toker.getTok();
+		if (tok.size() == 0)
+			continue;
+		if (Toker::isNewLine(tok)) {
+			bool open = preproc;
+			preproc = preproc && continued;
+			writeLine(line, lineCount++, open, preproc, scopes);
+			lineStart = true;
+			continue;
+		}
+		if (Toker::isWhiteSpace(tok)) {
+			line += tok;
+			continue;
+		}
+		continued = false;
+		if (Toker::isSingleLineComment(tok) || Toker::isMultipleLineComment(tok)) {
+			lineCount = appendSpanLines(line, "comments", tok, lineCount, preproc, scopes);
+			lineStart = false;
+			continue;
+		}
+		else if (Toker::isDoubleQuote(tok) || Toker::isSingleQuote(tok)) {
+			lineCount = appendSpanLines(line, "string", tok, lineCount, preproc, scopes);  // may be continued
+		}
+		else if (lineStart && tok[0] == '#') {
+			preproc = true;
+			line += "<span class=\"preproc\">";
+			appendEscaped(line, tok);
+		}
+		else if (Toker::isAlphaNum(tok) && !preproc) {
+			if (isKeyword(tok))
+				appendSpan(line, "keyword", tok);
+			else
+				appendIdentifier(line, tok, before, qualifier, file, lineCount);
+		}
+		else {
+			appendEscaped(line, tok);
+			continued = (tok.back() == '\\');
+		}
+		lineStart = false;
+		qualifier = before;
+		before = tok;
+	}
+	if (line.size() > 0)
+		writeLine(line, lineCount, preproc, false, scopes);
+}
 
-	while ((pos = line.find('>')) != line.npos)
-		line.replace(pos, 1, "&gt;");
+// -----< private - finishes markup of one line and writes it >------------
+/* closes an open preprocessor span, and reopens it on the next line when
+  the directive continues there */
+void CodeConverter::writeLine(std::string& line, int lineCount, bool closePreproc, bool reopenPreproc,
+	const Scopes& scopes)
+{
+	if (closePreproc)
+		line += "</span>";
+	handleClass(line, lineCount, scopes);
+	handleFunction(line, lineCount, scopes);
+	addLineAnchor(line, lineCount);
+	out_ << line << "\n";
+	line.clear();
+	if (reopenPreproc)
+		line += "<span class=\"preproc\">";
 }
 
-//-----< Applies the <div> to hide/show comments >---------------------------
-void CodeConverter::handleComment(std::string & line)
+// -----< private - replace HTML special chars >---------------------------
+/* appends text to line, replacing characters that would be taken as
+  markup by the browser */
+void CodeConverter::appendEscaped(std::string & line, const std::string & text)
 {
-	size_t pos = line.find('/');
-	if (line.npos == pos)
-	{
-		if (line.npos - 1 == '*')
-		{
-			line += "</div>";
+	for (char ch : text) {
+		switch (ch) {
+		case '<': line += "&lt;"; break;
+		case '>': line += "&gt;"; break;
+		case '&': line += "&amp;"; break;
+		default: line += ch;
 		}
 	}
-	else if (line[pos + 1] == '/') {
-		line.replace(pos, 1, "<div class =\"comments\">/");
-		line += "</div>";
+}
+
+// -----< private - appends text wrapped in span of given css class >------
+void CodeConverter::appendSpan(std::string & line, const char* cssClass, const std::string & text)
+{
+	if (text.size() == 0)
+		return;
+	line += "<span class=\"";
+	line += cssClass;
+	line += "\">";
+	appendEscaped(line, text);
+	line += "</span>";
+}
+
+// -----< private - appends a span for a token that may hold newlines >----
+/* the span is closed at each newline in text, the line written, and the
+  span reopened on the next, as for a line of a preprocessor directive.
+  Returns the line count after text */
+int CodeConverter::appendSpanLines(std::string & line, const char* cssClass, const std::string & text,
+	int lineCount, bool preproc, const Scopes& scopes)
+{
+	size_t start = 0, pos;
+	while ((pos = text.find('\n', start)) != text.npos) {
+		appendSpan(line, cssClass, text.substr(start, pos - start));
+		writeLine(line, lineCount++, preproc, preproc, scopes);
+		start = pos + 1;
 	}
+	appendSpan(line, cssClass, text.substr(start));
+	return lineCount;
+}
 
-	else if (line[pos + 1] == '*') {
-		line.replace(pos, 1, "<div class =\"comments\">/");
-		if (line[line.length() - 2] == '*' && line[line.length() - 1] == '/')
-		{
-			line += "</div>";
-		}
+// -----< private - links identifiers that have a known definition >-------
+/* a hashed lookup or two in the symbol table per identifier, by the
+  tokens written before it: a member named after . or -> isn't linked,
+  its object's class being unknown here, and one named after X:: links
+  only to a member of X when X is a class. The definition's own line is
+  not linked to itself. With keepIdentifiers on, identifiers are noted,
+  linked or not, so update finds the pages a new or moved definition
+  changes */
+void CodeConverter::appendIdentifier(std::string & line, const std::string & tok, const std::string & before,
+	const std::string & qualifier, const std::string & file, int lineCount)
+{
+	const SymbolTable::Definition* pDef = nullptr;
+	if (!std::isdigit((unsigned char)tok[0])) {
+		if (before != "." && before != "->")
+			pDef = st_.lookup(tok, before == "::" ? qualifier : "");
+		if (keepIdentifiers_)
+			pageIdentifiers_.insert(tok);  // may name a definition later
 	}
-	size_t pos2 = line.find('*');
-	if (line.npos != pos)
-	{
-		if (line[pos2 + 1] == '/')
-		{
-			line += "</div>";
-		}
+	if (pDef == nullptr || (pDef->line_ == (size_t)lineCount && pDef->file_ == file)) {
+		line += tok;
+		return;
 	}
+	line += "<a href=\"" + SymbolTable::linkTo(*pDef) + "\">" + tok + "</a>";
+}
+
+//-----< adds the anchor that cross-reference links point to >-----------
+void CodeConverter::addLineAnchor(std::string& line, int lineCount)
+{
+	if (st_.size() == 0)
+		return;
+	line.insert(0, "<a id=\"L" + std::to_string(lineCount) + "\"></a>");
+}
+
+// -----< private - is token a C++ or C# keyword >-------------------------
+bool CodeConverter::isKeyword(const std::string & tok)
+{
+	static const std::unordered_set<std::string> keywords
+	{
+		"alignas", "alignof", "auto", "bool", "break", "case", "catch", "char",
+		"class", "const", "constexpr", "const_cast", "continue", "decltype",
+		"default", "delete", "do", "double", "dynamic_cast", "else", "enum",
+		"explicit", "extern", "false", "float", "for", "friend", "goto", "if",
+		"inline", "int", "long", "mutable", "namespace", "new", "noexcept",
+		"nullptr", "operator", "private", "protected", "public", "register",
+		"reinterpret_cast", "return", "short", "signed", "sizeof", "static",
+		"static_assert", "static_cast", "struct", "switch", "template", "this",
+		"throw", "true", "try", "typedef", "typeid", "typename", "union",
+		"unsigned", "using", "virtual", "void", "volatile", "wchar_t", "while",
+		"override", "final", "interface", "abstract", "foreach", "null",
+		"readonly", "sealed"
+	};
+	return keywords.find(tok) != keywords.end();
 }
 
 //-----< Applies the <div> to hide/show functions >---------------------------
-void CodeConverter::handleFunction(std::string& line, int lineCount, std::vector<std::vector<int>> functionLines)
+void CodeConverter::handleFunction(std::string& line, int lineCount, const Scopes& scopes)
 {
-	for (auto funline : functionLines) {
-		if (lineCount == funline[0]) {
+	for (const ScopeLines& scope : scopes) {
+		if (scope.kind != functionScope)
+			continue;
+		if ((size_t)lineCount == scope.begin) {
 			size_t pos = line.find('{');
 			if (line.npos != pos) {
 				line.insert(pos + 1, "<div class =\"function\">");
@@ -317,7 +669,7 @@ void CodeConverter::handleFunction(std::string& line, int lineCount, std::vector
 			else
 				line += "<div class =\"function\">";
 		}
-		else if (lineCount == funline[1]) {
+		else if ((size_t)lineCount == scope.end) {
 			size_t pos = line.find('}');
 			if (line.npos != pos)
 				line.insert(pos, "</div>");
@@ -326,10 +678,12 @@ void CodeConverter::handleFunction(std::string& line, int lineCount, std::vector
 }
 
 //-----< Applies the <div> to hide/show class >---------------------------
-void CodeConverter::handleClass(std::string& line, int lineCount, std::vector<std::vector<int>> classLines)
+void CodeConverter::handleClass(std::string& line, int lineCount, const Scopes& scopes)
 {
-	for (auto clline : classLines) {
-		if (lineCount == clline[0]) {
+	for (const ScopeLines& scope : scopes) {
+		if (scope.kind != classScope)
+			continue;
+		if ((size_t)lineCount == scope.begin) {
 			size_t pos = line.find('{');
 			if (line.npos != pos) {
 				line.insert(pos + 1, "<div class =\"class\">");
@@ -337,94 +691,55 @@ void CodeConverter::handleClass(std::string& line, int lineCount, std::vector<st
 			else
 				line += "<div class =\"class\">";
 		}
-		else if (lineCount == clline[1]) {
+		else if ((size_t)lineCount == scope.end) {
 			size_t pos = line.find('}');
 			line.insert(pos, "</div>");
 		}
 	}
 }
 
-//-----< Fetches scope of class by using Parser >---------------------------
-std::vector<std::vector<int>> CodeConverter::getClassLines(std::string file)
-{
-	try {
-		ConfigParseForCodeAnal configure;
-		Parser* pParser = configure.Build();
-		std::string fileSpec = FileSystem::Path::getFullFileSpec(file);
-		std::string name;
-		std::vector<std::vector<int>> classScope;
-		if (pParser)
-		{
-			name = FileSystem::Path::getName(file);
-			if (!configure.Attach(fileSpec))
-			{
-				std::cout << "\n  could not open file " << name << std::endl;
-			}
-		}
-		else
-		{
-			std::cout << "\n\n  Parser not built\n\n";
-		}
-		Repository* pRepo = Repository::getInstance();
-		pRepo->package() = name;
-		while (pParser->next())
-		{
-			pParser->parse();
-		}
-		std::cout << "\n";
-		ASTNode* pGlobalScope = pRepo->getGlobalScope();
-
-		classScope = CodeAnalysis::TreeWalkToGetLineCountOfClass(pGlobalScope, classScope);
-		std::cout << "\n";
-		return classScope;
-
-	}
-	catch (std::exception& ex)
-	{
-		std::cout << "\n\n    " << ex.what() << "\n\n";
-		std::cout << "\n  exception caught at line " << __LINE__ << " ";
-		return { {0, 0} };
-	}
-}
-
-//-----< Fetches scope of funtion by using Parser >---------------------------
-std::vector<std::vector<int>> CodeConverter::getFunctionLines(std::string file)
+//-----< Fetches scopes of classes and functions by using Parser >--------
+/* the parser streams scopes to a ScopeListener, building no AST, so
+   memory holds only the scopes still open */
+Scopes CodeConverter::getScopes(const std::string& file)
 {
+	Scopes scopes;
 	try {
-		ConfigParseForCodeAnal configure;
-		Parser* pParser = configure.Build();
+		ParserPool::Lease lease = ParserPool::forThisThread().acquire();
+		Parser* pParser = lease->parser();
 		std::string fileSpec = FileSystem::Path::getFullFileSpec(file);
 		std::string name;
-		std::vector<std::vector<int>> functionScope;
 		if (pParser)
 		{
 			name = FileSystem::Path::getName(file);
-			if (!configure.Attach(fileSpec))
+			if (!lease->Attach(fileSpec))
 			{
 				std::cout << "\n  could not open file " << name << std::endl;
+				return scopes;
 			}
 		}
 		else
 		{
 			std::cout << "\n\n  Parser not built\n\n";
+			return scopes;
 		}
-		Repository* pRepo = Repository::getInstance();
+		Repository* pRepo = lease->repository();
 		pRepo->package() = name;
+		ScopeListener listener(scopes, classScope | functionScope);
+		pRepo->listener(&listener);
 		while (pParser->next())
 		{
 			pParser->parse();
 		}
+		pRepo->endOfFile();
 		std::cout << "\n";
-		ASTNode* pGlobalScope = pRepo->getGlobalScope();
-
-		functionScope = CodeAnalysis::TreeWalkToGetLineCountOfFunction(pGlobalScope, functionScope);
-		return functionScope;
+		return scopes;
 	}
 	catch (std::exception& ex)
 	{
 		std::cout << "\n\n    " << ex.what() << "\n\n";
 		std::cout << "\n  exception caught at line " << __LINE__ << " ";
-		return { {0, 0} };
+		return Scopes();
 	}
 }
 
@@ -440,11 +755,19 @@ int main() {
 	dt.getFileDependencies("../DependencyTable/DependencyTable.h");
 	dt.display();
 
+	SymbolTable st({ "Converter.h", "Converter.cpp",
+		"../DependencyTable/DependencyTable.cpp", "../DependencyTable/DependencyTable.h" });
+	st.display();
+
 	CodeConverter cc(dt);
+	cc.setSymbolTable(st);
 
 	std::cout << "\n";
 
 	cc.convert();
+
+	std::string page = cc.render("Converter.h");
+	std::cout << "\n  Rendered Converter.h without writing it: " << page.size() << " chars\n";
 	return 0;
 }
 
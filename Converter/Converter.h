@@ -1,7 +1,7 @@
 #pragma once
 ///////////////////////////////////////////////////////////////////////////
 // Converter.h   : defines source code conversion to webpage functions   //
-// ver 1.1                                                               //
+// ver 2.5                                                               //
 //                                                                       // 
 // Application   : Project Code Publisher                                //
 // Author        : Sneha Giranje                  						 //
@@ -13,17 +13,43 @@
 *  and uses its relationships to create linked webpages that point to each
 *  other based on dependencies. It can also convert single files if needed.
 *  The conversion process filters HTML special characters before printing
-*  them into output files. The resulting output of this converter is a list
+*  them into output files. Pages are written from the Toker token stream,
+*  with keywords, strings, comments and preprocessor lines highlighted. The resulting output of this converter is a list
 *  of files (vector<string>) of the created webpages.
+*
+*  After a convert, update brings the pages up to date with a set of
+*  changed and removed source files without converting the rest: their
+*  dependency and symbol entries are parsed again, their pages written
+*  or deleted, and the pages linking to them are written again - pages
+*  whose dependency links name a file that appeared or went away, and,
+*  when keepIdentifiers is on, pages using a symbol whose definition
+*  moved.  Without keepIdentifiers a moved definition rewrites every
+*  page.
+*
+*  A server renders pages on demand instead: prepare builds the symbol
+*  table and page names, render returns one page as a string, parsing
+*  its dependencies the first time, and stalePages takes changed and
+*  removed files into the tables and names the pages they make stale,
+*  without writing any.
 *  
 *  Public Interface:
 * =======================
 *  convertFile(file);
+*  setDepTable(dt);                // shares dt's graph, no copy
+*  convertedFiles();               // by const reference
+*  outputMoved(dir);               // pages now in dir
+*  keepIdentifiers(true);          // before convert, for update
+*  update(changed, removed);       // pages written again
+*  prepare(files);                 // for render, no pages written
+*  render(file);                   // page as a string
+*  stalePages(changed, removed);   // tables updated, no pages written
 *  addPreCodeHTML(std::string title);
 *  addButtons();
-*  addDependencyLinks(std::string file)
+*  addDependencyLinks(const std::string& file)
 *  addClosingTags();
-*  skipSpecialChars(std::string line);
+*  highlight(toker, file, scopes);
+*  appendEscaped(std::string& line, const std::string& text);
+*  appendIdentifier(line, tok, before, qualifier, file, lineCount);
 *  
 *
 *  Required Files:
@@ -31,10 +57,59 @@
 *  Converter.h Converter.cpp FileSystem.h FileSystem.cpp
 *  ActionAndRules.h ActionAndRules.cpp AbstrSynTree.h
 *  AbstrSynTree.cpp ConfigureParser.h  ConfigureParser.cpp
-*  ScopeStack.h ScopeStack.cpp
+*  ScopeStack.h ScopeStack.cpp SymbolTable.h SymbolTable.cpp
+*  Toker.h Toker.cpp PerfStats.h PerfStats.cpp
 *
 *  Maintainence History:
 * =======================
+*  ver 2.5 - 19 Oct 2026
+*  - identifiers are linked by the tokens before them: not after . or ->,
+*    and after X:: only to a member of X, so a call like v.clear() no
+*    longer links to an unrelated class's clear
+*  ver 2.4 - 19 Oct 2026
+*  - string and char tokens running over lines are split at each newline,
+*    as comments are, so the line count and anchors stay in step
+*  ver 2.3 - 19 Oct 2026
+*  - the default output directory is ../ConvertedWebpages/, which names
+*    the same directory on Windows and POSIX
+*  ver 2.2 - 19 Oct 2026
+*  - added outputMoved, for pages published to a staging directory that
+*    was then moved into place
+*  ver 2.1 - 19 Oct 2026
+*  - added prepare, render and stalePages, for a server rendering pages
+*    when they are requested; pages are written to a stream buffer, a
+*    file for convert and a string for render
+*  ver 2.0 - 19 Oct 2026
+*  - added update, converting only the pages a set of changed files
+*    affects, and keepIdentifiers, recording the identifiers each page
+*    uses so update knows which pages link to a moved definition
+*  ver 1.9 - 19 Oct 2026
+*  - the dependency table is shared rather than copied, convert and
+*    convertedFiles return the page list by const reference, and names
+*    of the pages to link are kept in a set built once per convert
+*    instead of for every file
+*  ver 1.8 - 19 Oct 2026
+*  - ConverterBenchmarks, in Benchmarks.cpp, is a friend so it can time
+*    appendEscaped and highlight
+*  ver 1.7 - 19 Oct 2026
+*  - convertFile is timed as PerfStats' convert stage, and its pass
+*    over the token stream as the highlight stage
+*  ver 1.6 - 19 Oct 2026
+*  - getScopes has the parser stream scopes to a ScopeListener instead
+*    of building an AST and walking it
+*  ver 1.5 - 19 Oct 2026
+*  - getScopes leases a parser from the thread's ParserPool instead of
+*    building a new one for every file
+*  ver 1.4 - 19 Oct 2026
+*  - Class and function scopes are collected with one parse and one
+*    ScopeWalk instead of a parse and a tree walk for each kind
+*  ver 1.3 - 19 Oct 2026
+*  - Replaced the getline and handleComment loop with a single pass over
+*    the token stream that highlights keywords, strings, comments and
+*    preprocessor lines, and handles comments spanning several lines
+*  ver 1.2 - 19 Oct 2026
+*  - Added cross-reference links from identifiers to the page and line of
+*    their definition, using SymbolTable, and a line anchor on every line
 *  ver 1.1 - 3 Mar 2019
 *  - Added functionality of getting function and class scopes and adding <div> to hide/show 
 *    comments, class and functions
@@ -43,9 +118,15 @@
 */
 
 #include "../DependencyTable/DependencyTable.h"
+#include "../SymbolTable/SymbolTable.h"
+#include "../CppParser/ScopeStack/ScopeStack.h"
 #include <vector>
 #include <string>
-#include <fstream>
+#include <ostream>
+#include <unordered_set>
+#include <unordered_map>
+
+namespace Lexer { class Toker; }
 
 class CodeConverter
 {
@@ -55,39 +136,74 @@ public:
 
 	const std::string& outputDir() const;
 	void outputDir(const std::string& dir);
+	void outputMoved(const std::string& dir);
 	bool createOutpurDir();
 
 	void setDepTable(const DependencyTable& dt);
+	void setDepTable(DependencyTable&& dt);
+	void setSymbolTable(const SymbolTable& st);
+	void setSymbolTable(SymbolTable&& st);
 
-	std::vector<std::string> convert();
+	const std::vector<std::string>& convert();
 	std::string convert(const std::string& filepath);
-	std::vector<std::string> convert(const std::vector<std::string>& files);
+	const std::vector<std::string>& convert(const std::vector<std::string>& files);
+
+	const std::vector<std::string>& convertedFiles() const;
 
-	const std::vector<std::string> convertedFiles() const;
+	void keepIdentifiers(bool keep = true);
+	std::vector<std::string> update(const std::vector<std::string>& changed,
+		const std::vector<std::string>& removed);
+
+	void prepare(const std::vector<std::string>& files);
+	std::string render(const std::string& file);
+	std::vector<std::string> stalePages(const std::vector<std::string>& changed,
+		const std::vector<std::string>& removed);
 
 	void clear();
 
+	friend class ConverterBenchmarks;  // times the private kernels
+
 private:
-	bool convertFile(std::string file);
+	bool convertFile(const std::string& file);
+	bool writePage(const std::string& file, std::streambuf& page);
+	void setPages(const std::vector<std::string>& files);
+	std::string fileNamed(const std::string& name) const;
+	std::string pagePath(const std::string& file) const;
 	void addPreCodeHTML(const std::string& title);
 	void addPreTag();
 	void addButtons();
-	void addDependencyLinks(std::string file);
+	void addDependencyLinks(const std::string& file);
 	void addClosingTags();
-	void skipSpecialChars(std::string& line);
+	void addLineAnchor(std::string& line, int lineCount);
+
+	// writes highlighted html from the token stream of a file
+	void highlight(Lexer::Toker& toker, const std::string& file,
+		const CodeAnalysis::Scopes& scopes);
+	void writeLine(std::string& line, int lineCount, bool closePreproc, bool reopenPreproc,
+		const CodeAnalysis::Scopes& scopes);
+	void appendEscaped(std::string& line, const std::string& text);
+	void appendSpan(std::string& line, const char* cssClass, const std::string& text);
+	int appendSpanLines(std::string& line, const char* cssClass, const std::string& text,
+		int lineCount, bool preproc, const CodeAnalysis::Scopes& scopes);
+	void appendIdentifier(std::string& line, const std::string& tok, const std::string& before,
+		const std::string& qualifier, const std::string& file, int lineCount);
+	static bool isKeyword(const std::string& tok);
 
 	// handles adding <div> by fetching scopes of functions and classes
-	void handleComment(std::string& line);
-	void handleClass(std::string& line, int, std::vector < std::vector<int>>);
-	void handleFunction(std::string& line, int, std::vector<std::vector<int>>);
+	void handleClass(std::string& line, int, const CodeAnalysis::Scopes&);
+	void handleFunction(std::string& line, int, const CodeAnalysis::Scopes&);
 
-	std::vector<std::vector<int>> getClassLines(std::string file);
-	std::vector<std::vector<int>> getFunctionLines(std::string file);
+	CodeAnalysis::Scopes getScopes(const std::string& file);
 private:
 	DependencyTable dt_;
-	std::string outputDir_ = "..\\ConvertedWebpages\\";
+	SymbolTable st_;
+	std::string outputDir_ = "../ConvertedWebpages/";  // both platforms accept /
 	std::vector<std::string> convertedFiles_;
-	std::vector<std::string> filesToConvert_;
-	std::ofstream out_;
+	std::unordered_set<std::string> pageNames_;  // of files being converted
+	std::ostream out_{ nullptr };  // on the buffer of the page being written
+
+	bool keepIdentifiers_ = false;
+	std::unordered_set<std::string> pageIdentifiers_;  // of the page being written
+	std::unordered_map<std::string, std::unordered_set<std::string>> pagesUsing_;  // identifier to files
 };
 
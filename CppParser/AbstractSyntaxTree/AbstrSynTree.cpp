@@ -1,6 +1,6 @@
 /////////////////////////////////////////////////////////////////////////////
 // AbstrSynTree.cpp - Represents an Abstract Syntax Tree                   //
-// ver 1.5                                                                 //
+// ver 1.8                                                                 //
 // ----------------------------------------------------------------------- //
 // Application: Project 2 - Project Code Publisher                         //
 //              CSE687 Object Oriented Design, Spring 2019                 //
@@ -62,44 +62,36 @@ std::string ASTNode::show(bool details)
 	temp << ")";
 	return temp.str();
 }
-std::vector<int> CodeAnalysis::ASTNode::getClassScope(bool details)
-{
-	std::vector<int> classScope;
-	if (type_ == "class") {
-		classScope.push_back(startLineCount_);
-		classScope.push_back(endLineCount_-1);
-	}
-	else {
-		classScope.push_back(0);
-		classScope.push_back(0);
-	}
-	return classScope;
-}
-std::vector<int> CodeAnalysis::ASTNode::getFunctionScope(bool details)
-{
-	std::vector<int> functionScope;
-	if (type_ == "function") {
-		functionScope.push_back(startLineCount_);
-		functionScope.push_back(endLineCount_);
-	}
-	else {
-		functionScope.push_back(0);
-		functionScope.push_back(0);
-	}
-	return functionScope;
-}
 //----< create instance and initialize first element >---------------
 /*
 *  - Every AST holds an ASTNode representing the global namespace
 *  - Its children will be namespaces, classes, and global data
 */
 AbstrSynTree::AbstrSynTree(ScopeStack<ASTNode*>& stack) : stack_(stack)
+{
+	addGlobalNamespace();
+}
+//----< private - create global namespace and push on scope stack >--
+
+void AbstrSynTree::addGlobalNamespace()
 {
 	pGlobalNamespace_ = new ASTNode("namespace", "Global Namespace");
 	pGlobalNamespace_->startLineCount_ = 1;
 	pGlobalNamespace_->endLineCount_ = 1;
 	stack_.push(pGlobalNamespace_);
 }
+//----< discard tree and start a new one, as if just constructed >---
+/*
+*  - lets a parser be reused for the next file without rebuilding it
+*/
+void AbstrSynTree::reset()
+{
+	discardOpenNodes();
+	delete pGlobalNamespace_;
+	typeMap_.clear();
+	stack_.clear();
+	addGlobalNamespace();
+}
 //----< destroy instance and all it's ASTNodes >---------------------
 /*
 *  AST destructor only has to delete its root.  The root will then
@@ -108,8 +100,25 @@ AbstrSynTree::AbstrSynTree(ScopeStack<ASTNode*>& stack) : stack_(stack)
 */
 AbstrSynTree::~AbstrSynTree()
 {
+	discardOpenNodes();
 	delete pGlobalNamespace_;
 }
+//----< private - delete unlinked nodes left on the stack >----------
+/*
+*  - when nodes aren't retained, nodes of scopes never closed belong
+*    to no parent, so are deleted here
+*/
+void AbstrSynTree::discardOpenNodes()
+{
+	if (retainNodes_)
+		return;
+	while (stack_.size() > 0)
+	{
+		ASTNode* pNode = stack_.pop();
+		if (pNode != pGlobalNamespace_)
+			delete pNode;
+	}
+}
 //----< return or accept pointer to global namespace >---------------
 
 ASTNode*& AbstrSynTree::root()
@@ -136,7 +145,8 @@ void AbstrSynTree::add(ASTNode* pNode)
 	if (stack_.size() > 0)
 	{
 		pNode->parentType_ = stack_.top()->type_;
-		stack_.top()->children_.push_back(pNode);  // add as child of stack top
+		if (retainNodes_)
+			stack_.top()->children_.push_back(pNode);  // add as child of stack top
 	}
 	else
 	{
@@ -149,13 +159,21 @@ void AbstrSynTree::add(ASTNode* pNode)
 //----< pop stack's top element >------------------------------------
 /*
  *  - called at end of scope
- *  - pop'd ASTNode is still linked to AST
+ *  - pop'd ASTNode is still linked to AST, unless nodes aren't retained,
+ *    when it is dropped from typeMap, as the client will delete it
  */
 ASTNode* AbstrSynTree::pop()
 {
-	if (stack_.size() > 0)
-		return stack_.pop();
-	return nullptr;
+	if (stack_.size() == 0)
+		return nullptr;
+	ASTNode* pNode = stack_.pop();
+	if (!retainNodes_)
+	{
+		auto iter = typeMap_.find(pNode->name_);
+		if (iter != typeMap_.end() && iter->second == pNode)
+			typeMap_.erase(iter);
+	}
+	return pNode;
 }
 //----< find a type node using typeMap >-----------------------------
 /*
@@ -171,6 +189,20 @@ ASTNode* AbstrSynTree::find(const ClassName& className)
 	return nullptr;
 }
 
+//----< link added nodes into the tree, the default? >--------------
+/*
+*  - set before the first add, e.g., right after reset()
+*/
+void AbstrSynTree::retainNodes(bool retain)
+{
+	retainNodes_ = retain;
+}
+
+bool AbstrSynTree::retainsNodes() const
+{
+	return retainNodes_;
+}
+
 //----< Test Stub >--------------------------------------------------
 /*
 *  Demonstrates that AbstrSynTree can build a simple Abstract
@@ -1,7 +1,7 @@
 #pragma once
 /////////////////////////////////////////////////////////////////////
 //  AbstrSynTree.h - Represents an Abstract Syntax Tree            //
-//  ver 1.4                                                        //
+//  ver 1.8                                                        //
 // Author:      Sneha Giranje					                   //
 /////////////////////////////////////////////////////////////////////
 /*
@@ -18,8 +18,9 @@
   ast.add(pNode);                     // add ASTNode to tree, linked to current scope
   ASTNode* pNode = ast.find(myType);  // retrieve ptr to ASTNode representing myType
   ast.pop();                          // close current scope by poping top of scopeStack
-  getClassScope();                    // returns scope of class
-  getFunctionScope();                 // returns scope of function
+  ast.reset();                        // discard tree, start new one for next file
+  ast.retainNodes(false);             // don't link nodes into the tree, the
+                                      // client deletes each one it pops
   Build Process:
   ==============
   Required files
@@ -32,6 +33,14 @@
 
   Maintenance History:
   ====================
+  ver 1.8 : 19 Oct 2026
+  - added retainNodes(false), used when parsing streams scopes to a
+    listener, so only the scopes still open are held in memory
+  ver 1.7 : 19 Oct 2026
+  - added reset(), so one AST can be reused for many files
+  ver 1.6 : 19 Oct 2026
+  - removed getClassScope and getFunctionScope, scopes are now collected
+    for the whole tree in one walk by ScopeCollector in ScopeStack.h
   ver 1.5 : 2 Mar 2019
   - added functions to fetch class and function scopes
   ver 1.4 : 26 Feb 2017
@@ -100,8 +109,6 @@ namespace CodeAnalysis
 		std::vector<DeclarationNode> decl_;
 		std::vector<Lexer::ITokenCollection*> statements_;
 		std::string show(bool details = false);
-		std::vector<int> getClassScope(bool details = false);
-		std::vector<int> getFunctionScope(bool details = false);
 	};
 
 	class AbstrSynTree
@@ -114,15 +121,19 @@ namespace CodeAnalysis
 		~AbstrSynTree();
 		ASTNode*& root();
 		void add(ASTNode* pNode);
-		std::vector<std::pair<int, int>> getClassScope;
-		std::vector<std::pair<int, int>> getFunctionScope;
 		ASTNode* find(const ClassName& type);
 		ASTNode* pop();
+		void reset();
 		TypeMap& typeMap();
+		void retainNodes(bool retain);
+		bool retainsNodes() const;
 	private:
+		void addGlobalNamespace();
+		void discardOpenNodes();
 		TypeMap typeMap_;
 		ScopeStack<ASTNode*>& stack_;
 		ASTNode* pGlobalNamespace_;
+		bool retainNodes_ = true;
 	};
 	//----< traverse AST and execute callobj on every node >-------------
 
@@ -1,7 +1,7 @@
 #pragma once
 /////////////////////////////////////////////////////////////////////
 // Properties.h - provides getter and setter methods               //
-// ver 1.1                                                         //
+// ver 1.2                                                         //
 // Jim Fawcett, CSE687 - Object Oriented Design, Fall 2018         //
 /////////////////////////////////////////////////////////////////////
 /*
@@ -22,6 +22,15 @@
 *    to the underlying stored value.  That lets us call member functions
 *    directly on the stored type.  However, that lets users bypass
 *    setter logic, so use it with caution.
+*  - FastProperty<T, Policy> has the same syntax, but nothing is virtual
+*    and all methods are constexpr, so calls inline to a plain member
+*    access.  Constraints are supplied at compile time by a Policy class
+*    with a static validate(t) function instead of by overriding.  It is
+*    intended for fields used on hot paths, e.g., the tokenizer's line
+*    count, which is incremented for every newline.
+*      FastProperty<size_t> count;
+*      ++count.ref();
+*      FastProperty<int, Clamp> clamped;  // Clamp::validate limits value
 *
 *  Required Files:
 *  ---------------
@@ -29,6 +38,8 @@
 *
 *  Maintenance History:
 *  --------------------
+*  ver 1.2 : 19 Oct 2026
+*  - added FastProperty and NoValidation policy
 *  ver 1.1 : 30 Jan 2019
 *  - added ref()
 *  ver 1.0 : 11 Oct 2018
@@ -70,4 +81,56 @@ namespace Utilities
   private:
     T t_;
   };
+
+  ///////////////////////////////////////////////////////////////////
+  // NoValidation policy
+  // - default policy for FastProperty, accepts every value
+
+  template <typename T>
+  struct NoValidation
+  {
+    static constexpr const T& validate(const T& t) { return t; }
+  };
+
+  ///////////////////////////////////////////////////////////////////
+  // FastProperty class
+  // - non-virtual Property, setter logic is provided by Policy
+
+  template <typename T, typename Policy = NoValidation<T>>
+  class FastProperty
+  {
+  public:
+    constexpr FastProperty() : t_() {}
+    constexpr FastProperty(const T& t) : t_(Policy::validate(t)) {}
+
+    //----< setter passes t through the policy to the internal store >
+
+    constexpr void operator()(const T& t)
+    {
+      t_ = Policy::validate(t);
+    }
+    //----< getter returns the value of the internal store >---------
+    /*
+    *  - Returns const reference, so large stored types, like sets,
+    *    are not copied by every call.
+    */
+    constexpr const T& operator()() const
+    {
+      return t_;
+    }
+    //----< getter that returns reference >--------------------------
+    /*
+    *  - As with Property, bypasses the policy.
+    */
+    constexpr T& ref()
+    {
+      return t_;
+    }
+    constexpr const T& ref() const
+    {
+      return t_;
+    }
+  private:
+    T t_;
+  };
 }
@@ -1,6 +1,6 @@
 /////////////////////////////////////////////////////////////////////////////
 // FileSystem.cpp - Support file and directory operations                  //
-// ver 3.0                                                                 //
+// ver 3.3                                                                 //
 // ----------------------------------------------------------------------- //
 // copyright  Jim Fawcett, 2012                                           //
 // All rights granted provided that this notice is retained                //
@@ -19,10 +19,25 @@
 #include <utility>
 #include <clocale>
 #include <locale>
+#include <algorithm>
+#include <cctype>
+#ifndef _WIN32
+#include <climits>
+#include <cstdlib>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+#endif
 #include "FileSystem.h"
 
 using namespace FileSystem;
 
+#ifdef _WIN32
 /////////////////////////////////////////////////////////
 // helper FileSystemSearch
 
@@ -45,6 +60,61 @@ private:
 FileSystemSearch::FileSystemSearch() : pFindFileData(&FindFileData) {}
 FileSystemSearch::~FileSystemSearch() { ::FindClose(hFindFile); }
 void FileSystemSearch::close() { ::FindClose(hFindFile); }
+#endif
+
+/////////////////////////////////////////////////////////
+// helpers for Directory::list and Directory::match
+
+namespace
+{
+  bool isDotOrDotDot(const char* name)
+  {
+    return name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'));
+  }
+
+  bool sameChar(char a, char b)
+  {
+#ifdef _WIN32
+    return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b));
+#else
+    return a == b;
+#endif
+  }
+
+#ifndef _WIN32
+  // record layout written by getdents64, see getdents(2)
+
+  struct LinuxDirent64
+  {
+    unsigned long long d_ino;
+    long long d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[1];
+  };
+
+  // only needed when the file system doesn't report d_type, or for links
+
+  bool isDirectoryAt(int dirFd, const char* name)
+  {
+    struct stat info;
+    return ::fstatat(dirFd, name, &info, 0) == 0 && S_ISDIR(info.st_mode);
+  }
+
+  void addEntry(Directory::Listing& listing, int dirFd, const char* name, unsigned char type)
+  {
+    if (isDotOrDotDot(name))
+      return;
+    bool isDir = (type == DT_DIR);
+    if (type == DT_UNKNOWN || type == DT_LNK)
+      isDir = isDirectoryAt(dirFd, name);
+    if (isDir)
+      listing.dirs.emplace_back(name);
+    else
+      listing.files.emplace_back(name);
+  }
+#endif
+}
 
 //----< block constructor taking array iterators >-------------------------
 
@@ -90,6 +160,12 @@ size_t Block::size() const
 {
   return bytes_.size();
 }
+//----< change number of bytes in block >----------------------------------
+
+void Block::resize(size_t size)
+{
+  bytes_.resize(size);
+}
 
 //----< File constructor opens file stream >-------------------------------
 
@@ -165,34 +241,58 @@ std::string File::getLine(bool keepNewLines)
     throw std::runtime_error("reading output file");
 
   std::string store;
-  while (true)
-  {
-    char ch = pIStream->get();
-    if (!isGood())
-      return store;
-    if (ch == '\n')
-    {
-      if (keepNewLines)
-        store += ch;
-      return store;
-    }
-    store += ch;
-  }
+  std::getline(*pIStream, store);
+  if (keepNewLines && !pIStream->eof())
+    store += '\n';
+  return store;
 }
 //----< read all lines of text file into one string >----------------------
-
+/*
+ * Reads the rest of the file with one allocation, sized from the file
+ * length, then edits the line ends in place.  Each line is followed by
+ * a space, unless it ends with white space, or by its newline if
+ * keepNewLines is true.
+ */
 std::string File::readAll(bool keepNewLines)
 {
   std::string store;
-  while (true)
+  if (!isGood())
+    return store;
+  if(typ_ == binary)
+    throw std::runtime_error("getting text from binary file");
+  if(dirn_ == out)
+    throw std::runtime_error("reading output file");
+
+  std::streampos start = pIStream->tellg();
+  pIStream->seekg(0, std::ios::end);
+  std::streamoff length = pIStream->tellg() - start;
+  pIStream->seekg(start);
+  if (length <= 0)
   {
-    if (!isGood())
-      return store;
-    store += getLine(keepNewLines);
-    std::locale loc;
-    if (store.size() > 0 && !std::isspace(store[store.size() - 1], loc))
-      store += ' ';
+    pIStream->setstate(std::ios::eofbit | std::ios::failbit);
+    return store;
   }
+  store.resize(static_cast<size_t>(length) + 1);  // room for trailing space
+  pIStream->read(&store[0], length);
+  size_t count = static_cast<size_t>(pIStream->gcount());  // less than length if CRs dropped
+  pIStream->setstate(std::ios::eofbit | std::ios::failbit);
+
+  std::locale loc;
+  size_t last = 0;
+  for (size_t i = 0; i < count; ++i)
+  {
+    char ch = store[i];
+    if (ch == '\n' && !keepNewLines)
+    {
+      if (last > 0 && !std::isspace(store[last - 1], loc))
+        store[last++] = ' ';
+      continue;
+    }
+    store[last++] = ch;
+  }
+  if (last > 0 && !std::isspace(store[last - 1], loc))
+    store[last++] = ' ';
+  store.resize(last);
   return store;
 }
 //----< writes one line of a text to a file >------------------------------
@@ -221,19 +321,11 @@ Block File::getBlock(size_t size)
     throw std::runtime_error("reading binary from text file");
   if(dirn_ == out)
     throw std::runtime_error("reading output file");
-  Block blk;
-  if(pIStream)
-  {
-    for(size_t i=0; i<size; ++i)
-    {
-      Byte b;
-      pIStream->get(b);
-      if(pIStream->good())
-        blk.push_back(b);
-      else
-        break;
-    }
-  }
+  Block blk(size);
+  if(size == 0)
+    return blk;
+  pIStream->read(&blk[0], size);
+  blk.resize(static_cast<size_t>(pIStream->gcount()));
   return blk;
 }
 //----< writes a block of bytes to binary file >---------------------------
@@ -340,6 +432,194 @@ void File::close()
     good_ = false;
   }
 }
+//----< map whole file for reading, without copying >----------------------
+
+FileView File::mapView()
+{
+  return FileView(name_, 0);
+}
+//----< construct closed view >--------------------------------------------
+
+FileView::FileView() : pData_(nullptr), size_(0), good_(false), mapped_(false)
+#ifdef _WIN32
+  , hMap_(NULL)
+#endif
+{
+}
+//----< construct view of filespec, check isGood() for success >-----------
+
+FileView::FileView(const std::string& filespec, size_t mapThreshold) : FileView()
+{
+  open(filespec, mapThreshold);
+}
+//----< move constructor takes ownership of mapping >----------------------
+
+FileView::FileView(FileView&& view) : FileView()
+{
+  *this = std::move(view);
+}
+//----< move assignment releases our mapping, takes view's >---------------
+
+FileView& FileView::operator=(FileView&& view)
+{
+  if (this == &view)
+    return *this;
+  close();
+  std::swap(pData_, view.pData_);
+  std::swap(size_, view.size_);
+  std::swap(good_, view.good_);
+  std::swap(mapped_, view.mapped_);
+  std::swap(buffer_, view.buffer_);
+  if (good_ && !mapped_ && size_ > 0)
+    pData_ = buffer_.data();  // a short buffer's text moves with it
+#ifdef _WIN32
+  std::swap(hMap_, view.hMap_);
+#endif
+  return *this;
+}
+//----< destructor unmaps >------------------------------------------------
+
+FileView::~FileView()
+{
+  close();
+}
+//----< read file into buffer_, as much of size_ bytes as it still has >---
+
+bool FileView::read(const std::string& filespec)
+{
+  std::ifstream in(filespec, std::ios::in | std::ios::binary);
+  if (!in.good())
+  {
+    size_ = 0;
+    return false;
+  }
+  buffer_.resize(size_);
+  in.read(&buffer_[0], size_);
+  buffer_.resize(static_cast<size_t>(in.gcount()));  // truncated since it was sized
+  size_ = buffer_.size();
+  pData_ = size_ > 0 ? buffer_.data() : "";
+  return (good_ = true);
+}
+#ifdef _WIN32
+//----< map whole file read-only, or read it >-----------------------------
+/*
+ * An empty file can't be mapped, so its view is good, with size zero.
+ * A file smaller than mapThreshold is read, see FileSystem.h.
+ */
+bool FileView::open(const std::string& filespec, size_t mapThreshold)
+{
+  close();
+  HANDLE hFile = ::CreateFileA(
+    filespec.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+    OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL
+  );
+  if (hFile == INVALID_HANDLE_VALUE)
+    return false;
+  LARGE_INTEGER fileSize;
+  if (!::GetFileSizeEx(hFile, &fileSize))
+  {
+    ::CloseHandle(hFile);
+    return false;
+  }
+  size_ = static_cast<size_t>(fileSize.QuadPart);
+  if (size_ == 0)
+  {
+    ::CloseHandle(hFile);
+    pData_ = "";
+    return (good_ = true);
+  }
+  if (size_ < mapThreshold)
+  {
+    ::CloseHandle(hFile);
+    return read(filespec);
+  }
+  hMap_ = ::CreateFileMappingA(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+  ::CloseHandle(hFile);  // mapping keeps the file open
+  if (hMap_ == NULL)
+  {
+    size_ = 0;
+    return false;
+  }
+  pData_ = static_cast<const char*>(::MapViewOfFile(hMap_, FILE_MAP_READ, 0, 0, 0));
+  if (pData_ == nullptr)
+  {
+    close();
+    return false;
+  }
+  mapped_ = true;
+  return (good_ = true);
+}
+//----< unmap, or empty the buffer >---------------------------------------
+
+void FileView::close()
+{
+  if (mapped_)
+    ::UnmapViewOfFile(pData_);
+  if (hMap_ != NULL)
+    ::CloseHandle(hMap_);
+  hMap_ = NULL;
+  buffer_.clear();
+  pData_ = nullptr;
+  size_ = 0;
+  good_ = false;
+  mapped_ = false;
+}
+#else
+//----< map whole file read-only, or read it >-----------------------------
+/*
+ * An empty file can't be mapped, so its view is good, with size zero.
+ * A file smaller than mapThreshold is read, see FileSystem.h.
+ */
+bool FileView::open(const std::string& filespec, size_t mapThreshold)
+{
+  close();
+  int fd = ::open(filespec.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    return false;
+  struct stat info;
+  if (::fstat(fd, &info) != 0 || !S_ISREG(info.st_mode))
+  {
+    ::close(fd);
+    return false;
+  }
+  size_ = static_cast<size_t>(info.st_size);
+  if (size_ == 0)
+  {
+    ::close(fd);
+    pData_ = "";
+    return (good_ = true);
+  }
+  if (size_ < mapThreshold)
+  {
+    ::close(fd);
+    return read(filespec);
+  }
+  void* pMap = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);  // mapping keeps the file open
+  if (pMap == MAP_FAILED)
+  {
+    size_ = 0;
+    return false;
+  }
+  ::madvise(pMap, size_, MADV_SEQUENTIAL);
+  pData_ = static_cast<const char*>(pMap);
+  mapped_ = true;
+  return (good_ = true);
+}
+//----< unmap, or empty the buffer >---------------------------------------
+
+void FileView::close()
+{
+  if (mapped_)
+    ::munmap(const_cast<char*>(pData_), size_);
+  buffer_.clear();
+  pData_ = nullptr;
+  size_ = 0;
+  good_ = false;
+  mapped_ = false;
+}
+#endif
+#ifdef _WIN32
 //----< file exists >--------------------------------------------------
 
 bool File::exists(const std::string& file)
@@ -358,6 +638,38 @@ bool File::remove(const std::string& file)
 {
   return ::DeleteFileA(file.c_str()) != 0;
 }
+#else
+//----< file exists >--------------------------------------------------
+
+bool File::exists(const std::string& file)
+{
+  struct stat info;
+  return ::stat(file.c_str(), &info) == 0;
+}
+//----< copy file >----------------------------------------------------
+
+bool File::copy(const std::string& src, const std::string& dst, bool failIfExists)
+{
+  if (failIfExists && exists(dst))
+    return false;
+  std::ifstream in(src, std::ios::in | std::ios::binary);
+  if (!in.good())
+    return false;
+  std::ofstream out(dst, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!out.good())
+    return false;
+  if (in.peek() != std::ifstream::traits_type::eof())
+    out << in.rdbuf();
+  return out.good();
+}
+//----< remove file >--------------------------------------------------
+
+bool File::remove(const std::string& file)
+{
+  return ::unlink(file.c_str()) == 0;
+}
+#endif
+#ifdef _WIN32
 //----< constructor >--------------------------------------------------
 
 FileInfo::FileInfo(const std::string& fileSpec)
@@ -524,6 +836,7 @@ bool FileInfo::larger(const FileInfo &fi) const
 {
   return size() > fi.size();
 }
+#endif
 //----< convert string to lower case chars >---------------------------
 
 std::string Path::toLower(const std::string& src)
@@ -588,7 +901,7 @@ std::string Path::getExt(const std::string& fileSpec)
   // handle ../ or ..\\ with no extension
   if(pos1 < fileSpec.length() || pos2 < fileSpec.length())
   {
-    if(pos < min(pos1, pos2))
+    if(pos < (std::min)(pos1, pos2))
       return std::string("");
   }
   // only . is extension delimiter
@@ -609,6 +922,7 @@ std::string Path::getPath(const std::string &fileSpec)
     return fileSpec.substr(0,pos+1);
   return fileSpec;
 }
+#ifdef _WIN32
 //----< get absoluth path from fileSpec >------------------------------
 
 std::string Path::getFullFileSpec(const std::string &fileSpec)
@@ -620,6 +934,22 @@ std::string Path::getFullFileSpec(const std::string &fileSpec)
   ::GetFullPathNameA(fileSpec.c_str(),BufSize, buffer, &name);
   return std::string(buffer);
 }
+#else
+//----< get absoluth path from fileSpec >------------------------------
+/*
+ * realpath only resolves names that exist, so a file that is about to
+ * be created is resolved against the current directory instead.
+ */
+std::string Path::getFullFileSpec(const std::string &fileSpec)
+{
+  char buffer[PATH_MAX];
+  if (::realpath(fileSpec.c_str(), buffer) != nullptr)
+    return std::string(buffer);
+  if (fileSpec.size() > 0 && fileSpec[0] == '/')
+    return fileSpec;
+  return Path::fileSpec(Directory::getCurrentDirectory(), fileSpec);
+}
+#endif
 //----< create file spec from path and name >--------------------------
 
 std::string Path::fileSpec(const std::string &path, const std::string &name)
@@ -639,6 +969,7 @@ std::string Path::fileSpec(const std::string &path, const std::string &name)
   }
   return fs;
 }
+#ifdef _WIN32
 //----< return name of the current directory >-----------------------------
 
 std::string Directory::getCurrentDirectory()
@@ -712,6 +1043,177 @@ bool Directory::remove(const std::string& path)
 {
   return ::RemoveDirectoryA(path.c_str()) == 0;
 }
+//----< one scan of path, sorted into files and directories >--------------
+
+bool Directory::list(const std::string& path, Listing& listing)
+{
+  listing.clear();
+  WIN32_FIND_DATAA data;
+  HANDLE hFind = ::FindFirstFileA(Path::fileSpec(path, "*").c_str(), &data);
+  if (hFind == INVALID_HANDLE_VALUE)
+    return false;
+  do
+  {
+    if (isDotOrDotDot(data.cFileName))
+      continue;
+    if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+      listing.dirs.emplace_back(data.cFileName);
+    else
+      listing.files.emplace_back(data.cFileName);
+  } while (::FindNextFileA(hFind, &data));
+  ::FindClose(hFind);
+  return true;
+}
+#else
+//----< return name of the current directory >-----------------------------
+
+std::string Directory::getCurrentDirectory()
+{
+  char buffer[PATH_MAX];
+  if (::getcwd(buffer, PATH_MAX) == nullptr)
+    return "";
+  return std::string(buffer);
+}
+//----< change the current directory to path >-----------------------------
+
+bool Directory::setCurrentDirectory(const std::string& path)
+{
+  return ::chdir(path.c_str()) == 0;
+}
+//----< get names of all the files matching pattern (path:name) >----------
+
+std::vector<std::string> Directory::getFiles(const std::string& path, const std::string& pattern)
+{
+  Listing listing;
+  list(path, listing);
+  filter(listing.files, pattern);
+  return std::move(listing.files);
+}
+//----< get names of all directories matching pattern (path:name) >--------
+/*
+ * Unlike the Windows version, "." and ".." are not returned.
+ */
+std::vector<std::string> Directory::getDirectories(const std::string& path, const std::string& pattern)
+{
+  Listing listing;
+  list(path, listing);
+  filter(listing.dirs, pattern);
+  return std::move(listing.dirs);
+}
+//----< create directory >-------------------------------------------------
+
+bool Directory::create(const std::string& path)
+{
+  return ::mkdir(path.c_str(), 0777) == 0;
+}
+//----< does directory exist? >--------------------------------------------
+
+bool Directory::exists(const std::string& path)
+{
+  struct stat info;
+  return ::stat(path.c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+}
+//----< remove directory >-------------------------------------------------
+
+bool Directory::remove(const std::string& path)
+{
+  return ::rmdir(path.c_str()) == 0;
+}
+//----< one scan of path, sorted into files and directories >--------------
+/*
+ * On Linux the entries are read in large batches with getdents64, and the
+ * d_type of each entry decides whether it is a file or a directory, so a
+ * directory of a million files costs a few dozen system calls rather than
+ * a readdir and a stat per entry.  Other POSIX systems use readdir, which
+ * also reports d_type.
+ */
+bool Directory::list(const std::string& path, Listing& listing)
+{
+  listing.clear();
+  int fd = ::open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (fd < 0)
+    return false;
+#ifdef __linux__
+  const size_t BufSize = 64 * 1024;
+  alignas(LinuxDirent64) char buffer[BufSize];
+  bool ok = true;
+  while (true)
+  {
+    long nread = ::syscall(SYS_getdents64, fd, buffer, BufSize);
+    if (nread <= 0)
+    {
+      ok = (nread == 0);
+      break;
+    }
+    for (long pos = 0; pos < nread; )
+    {
+      const LinuxDirent64* pEntry = reinterpret_cast<const LinuxDirent64*>(buffer + pos);
+      addEntry(listing, fd, pEntry->d_name, pEntry->d_type);
+      pos += pEntry->d_reclen;
+    }
+  }
+  ::close(fd);
+  return ok;
+#else
+  DIR* pDir = ::fdopendir(fd);
+  if (pDir == nullptr)
+  {
+    ::close(fd);
+    return false;
+  }
+  while (dirent* pEntry = ::readdir(pDir))
+    addEntry(listing, ::dirfd(pDir), pEntry->d_name, pEntry->d_type);
+  ::closedir(pDir);
+  return true;
+#endif
+}
+#endif
+//----< remove names that don't match pattern, returns count kept >--------
+
+size_t Directory::filter(std::vector<std::string>& names, const std::string& pattern)
+{
+  if (pattern == "*" || pattern == "*.*")
+    return names.size();
+  auto noMatch = [&](const std::string& name) { return !match(name, pattern); };
+  names.erase(std::remove_if(names.begin(), names.end(), noMatch), names.end());
+  return names.size();
+}
+//----< does name match pattern with * and ? wildcards? >------------------
+/*
+ * "*.*" matches every name, as it does for FindFirstFile, so the default
+ * pattern means all files on every platform.  Case is ignored on Windows.
+ */
+bool Directory::match(const std::string& name, const std::string& pattern)
+{
+  if (pattern == "*" || pattern == "*.*")
+    return true;
+  size_t n = 0, p = 0;
+  size_t starP = std::string::npos, starN = 0;
+  while (n < name.size())
+  {
+    if (p < pattern.size() && pattern[p] == '*')
+    {
+      starP = p++;
+      starN = n;
+    }
+    else if (p < pattern.size() && (pattern[p] == '?' || sameChar(pattern[p], name[n])))
+    {
+      ++p;
+      ++n;
+    }
+    else if (starP != std::string::npos)
+    {
+      p = starP + 1;
+      n = ++starN;
+    }
+    else
+      return false;
+  }
+  while (p < pattern.size() && pattern[p] == '*')
+    ++p;
+  return p == pattern.size();
+}
+#ifdef _WIN32
 //----< find first file >--------------------------------------------------
 
 std::string FileSystemSearch::firstFile(const std::string& path, const std::string& pattern)
@@ -762,17 +1264,98 @@ std::string FileSystemSearch::nextDirectory()
       return pFindFileData->cFileName;
   return "";
 }
+#endif
 //----< test stub >--------------------------------------------------------
 
 #ifdef TEST_FILESYSTEM
 
+#include <chrono>
+#include <cstdio>
+
 void title(const std::string& title, char ch='=')
 {
   std::cout << "\n  " << title;
   std::cout << "\n " << std::string(title.size()+2, ch);
 }
+//----< time one listing against a scan per pattern >----------------------
+/*
+ * FileSystem /benchList path [entries]
+ * Fills path, if it is empty, with entries files and entries/100 dirs,
+ * then compares getFiles and getDirectories, called once per pattern,
+ * with one Directory::list matched against every pattern.  On POSIX the
+ * readdir and stat loop a straight port would use is timed as well.
+ */
+int benchList(const std::string& path, size_t entries)
+{
+  title("Directory listing benchmark");
+  const char* exts[] = { ".h", ".cpp", ".txt", ".html" };
+  Directory::Listing listing;
+  if (!Directory::exists(path))
+    Directory::create(path);
+  if (Directory::list(path, listing) && listing.files.size() + listing.dirs.size() == 0)
+  {
+    std::cout << "\n  creating " << entries << " entries in " << path;
+    char name[32];
+    for (size_t i = 0; i < entries; ++i)
+    {
+      if (i % 100 == 99)
+      {
+        std::snprintf(name, sizeof(name), "dir%07zu", i);
+        Directory::create(Path::fileSpec(path, name));
+        continue;
+      }
+      std::snprintf(name, sizeof(name), "file%07zu%s", i, exts[i % 4]);
+      std::ofstream(Path::fileSpec(path, name));
+    }
+  }
+
+  using Clock = std::chrono::steady_clock;
+  auto millisecs = [](Clock::duration d) { return std::chrono::duration<double, std::milli>(d).count(); };
+  std::vector<std::string> patterns = { "*.h", "*.cpp" };
+
+  Clock::time_point start = Clock::now();
+  size_t perPatternCount = 0;
+  for (auto& patt : patterns)
+    perPatternCount += Directory::getFiles(path, patt).size();
+  perPatternCount += Directory::getDirectories(path).size();
+  double perPatternTime = millisecs(Clock::now() - start);
+
+  start = Clock::now();
+  Directory::list(path, listing);
+  size_t listCount = listing.dirs.size();
+  for (auto& patt : patterns)
+    for (auto& file : listing.files)
+      listCount += Directory::match(file, patt) ? 1 : 0;
+  double listTime = millisecs(Clock::now() - start);
+
+  std::cout << "\n  getFiles per pattern: " << perPatternTime << " ms, " << perPatternCount << " names";
+  std::cout << "\n  one Directory::list:  " << listTime << " ms, " << listCount << " names";
+
+#ifndef _WIN32
+  start = Clock::now();
+  size_t statCount = 0;
+  if (DIR* pDir = ::opendir(path.c_str()))
+  {
+    while (dirent* pEntry = ::readdir(pDir))
+    {
+      struct stat info;
+      if (::stat(Path::fileSpec(path, pEntry->d_name).c_str(), &info) == 0)
+        ++statCount;
+    }
+    ::closedir(pDir);
+  }
+  double statTime = millisecs(Clock::now() - start);
+  std::cout << "\n  readdir and stat:     " << statTime << " ms, " << statCount << " names";
+#endif
+  std::cout << "\n\n";
+  return 0;
+}
+
 int main(int argc, char* argv[])
 {
+  if (argc > 2 && std::string(argv[1]) == "/benchList")
+    return benchList(argv[2], argc > 3 ? std::stoul(argv[3]) : 1000000);
+
   title("Demonstrate Path Class");
 
   std::string fs = Path::fileSpec(".","temp.textbox");
@@ -848,6 +1431,7 @@ int main(int argc, char* argv[])
 
   // Create directory
 
+#ifdef _WIN32
   title("Demonstrate FileInfo Class Operations", '=');
   std::cout << "\n";
 
@@ -955,6 +1539,7 @@ int main(int argc, char* argv[])
   }
   else
     std::cout << "\n  files " << fn1 << " and " << fn2 << " are not valid in this context\n";
+#endif
 
   title("Demonstrate File class operations", '=');
   std::cout << "\n";
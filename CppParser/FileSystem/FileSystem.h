@@ -2,7 +2,7 @@
 #define FILESYSTEM_H
 /////////////////////////////////////////////////////////////////////////////
 // FileSystem.h - Support file and directory operations                    //
-// ver 3.0                                                                 //
+// ver 3.3                                                                 //
 // ----------------------------------------------------------------------- //
 // copyright  Jim Fawcett, 2012                                           //
 // All rights granted provided that this notice is retained                //
@@ -16,14 +16,22 @@
 /*
  * Module Operations:
  * ==================
- * This module provides classes, File, FileInfo, Path, Directory, and 
- * FileSystemSearch.
+ * This module provides classes, File, FileView, FileInfo, Path, Directory,
+ * and FileSystemSearch.
  *
  * The File class supports opening text and binary files for either input 
  * or output.  File objects have names, get and put lines of text, get and
  * put blocks of bytes if binary, can be tested for operational state,
  * cleared of errors, and output File objects can be flushed to their streams.
  *
+ * FileView maps a whole file into memory, read-only, and exposes its bytes
+ * as a pointer and size, so a file can be scanned without copying it into
+ * strings or blocks.  The mapping is released when the view is closed or
+ * destroyed.  Files below the view's map threshold, by default all files,
+ * are read into one buffer instead, as a mapped file truncated by another
+ * process, an editor saving it say, faults when the missing pages are
+ * read.  File::mapView() returns a mapped view of a File's file.
+ *
  * FileInfo class accepts a fully qualified filespec and supports queries
  * concerning name, time and date, size, and attributes.  You can compare
  * FileInfo objects by name, date, and size.
@@ -36,7 +44,15 @@
  * The Directory class supports getting filenames or directories from a 
  * fully qualified filespec, e.g., path + filename pattern using static
  * methods.  It also provides non-static methods to get and set the current
- * directory.
+ * directory.  Directory::list makes one pass over a directory, sorting its
+ * entries into files and subdirectories, and Directory::filter applies a
+ * glob pattern to a name list in place, so callers with several patterns
+ * can scan each directory once.  On Linux the listing is read with
+ * getdents64 and uses the entry type it returns, so no entry is stat'ed
+ * unless the file system does not report types.
+ *
+ * FileInfo wraps the Win32 find data, so is only available on Windows.
+ * The other classes build on Windows and on POSIX systems.
  *
  * Public Interface:
  * =================
@@ -48,6 +64,10 @@
  * }
  * File h(filespec,File::in);
  * h.readLine();
+ * FileView v(filespec);                 // read, v.isMapped() is false
+ * FileView m(filespec, 1 << 20);         // mapped if a MB or more
+ * if(v.isGood())
+ *   for(char ch : v) ...                // v.data(), v.size()
  *
  * FileInfo fi("..\foobar.textbox");
  * if(fi.good())
@@ -69,6 +89,9 @@
  * d.setCurrentDirectory(dir);
  * std::vector<std::string> files = Directory::getFiles(path, pattern);
  * std::vector<std::string> dirs = Directory::getDirectories(path);
+ * Directory::Listing listing;
+ * Directory::list(path, listing);           // one scan, files and dirs
+ * Directory::filter(listing.files, "*.h");  // erases names not matching
  * 
  * Required Files:
  * ===============
@@ -80,6 +103,18 @@
  *
  * Maintenance History:
  * ====================
+ * ver 3.3 : 19 Oct 2026
+ * - FileView maps only files of its mapThreshold bytes or more, none by
+ *   default, and reads smaller ones into a buffer, so a file truncated
+ *   while it is viewed reads short instead of faulting
+ * ver 3.2 : 19 Oct 2026
+ * - added FileView, a read-only mapped view of a file, and File::mapView
+ * - File::readAll reads the rest of the file with one allocation, and
+ *   getLine and getBlock no longer read a byte at a time
+ * ver 3.1 : 19 Oct 2026
+ * - added Directory::list, filter, and match, with a POSIX backend that
+ *   reads entries with getdents64 and sorts them by d_type
+ * - guarded the Win32 parts, including FileInfo, with _WIN32
  * ver 3.0 : 22 Feb 2019
  * - Fixed bugs, found by Ammar Salam and Namen Parakh in Directory::remove
  *   and Directory::create, which returned the wrong boolean value, by
@@ -128,7 +163,9 @@
 #include <fstream>
 #include <string>
 #include <vector>
+#ifdef _WIN32
 #include <windows.h>
+#endif
 
 namespace FileSystem
 {
@@ -148,10 +185,52 @@ namespace FileSystem
     bool operator==(const Block&) const;
     bool operator!=(const Block&) const;
     size_t size() const;
+    void resize(size_t size);
   private:
     std::vector<Byte> bytes_;
   };
 
+  /////////////////////////////////////////////////////////
+  // FileView - read-only view of a whole file
+  // - maps a file of mapThreshold bytes or more into memory, so reading
+  //   it copies nothing, and reads a smaller one into a buffer
+  // - a mapped file truncated by another process while it is viewed
+  //   raises SIGBUS on POSIX, and can't be truncated on Windows, so by
+  //   default no file is mapped
+  // - unmaps when closed or destroyed, and may be moved, not copied
+
+  class FileView
+  {
+  public:
+    static const size_t neverMap = static_cast<size_t>(-1);
+
+    FileView();
+    explicit FileView(const std::string& filespec, size_t mapThreshold = neverMap);
+    FileView(FileView&& view);
+    FileView& operator=(FileView&& view);
+    FileView(const FileView&) = delete;
+    FileView& operator=(const FileView&) = delete;
+    ~FileView();
+    bool open(const std::string& filespec, size_t mapThreshold = neverMap);
+    void close();
+    bool isGood() const { return good_; }
+    bool isMapped() const { return mapped_; }
+    const char* data() const { return pData_; }
+    size_t size() const { return size_; }
+    const char* begin() const { return pData_; }
+    const char* end() const { return pData_ + size_; }
+  private:
+    bool read(const std::string& filespec);
+    const char* pData_;
+    size_t size_;
+    bool good_;
+    bool mapped_;
+    std::string buffer_;  // text of a file read, not mapped, keeps its capacity
+#ifdef _WIN32
+    HANDLE hMap_;
+#endif
+  };
+
   /////////////////////////////////////////////////////////
   // File
   
@@ -167,6 +246,7 @@ namespace FileSystem
     std::string name();
     std::string getLine(bool keepNewLine = false);
     std::string readAll(bool KeepNewLines = false);
+    FileView mapView();
     void putLine(const std::string& line, bool wantReturn=true);
     Block getBlock(size_t size);
     void putBlock(const Block&);
@@ -190,6 +270,7 @@ namespace FileSystem
 
   inline std::string File::name() { return name_; }
 
+#ifdef _WIN32
   /////////////////////////////////////////////////////////
   // FileInfo
 
@@ -228,6 +309,7 @@ namespace FileSystem
     WIN32_FIND_DATAA data;
     HANDLE hFindFile;
   };
+#endif
 
   /////////////////////////////////////////////////////////
   // Path
@@ -250,6 +332,15 @@ namespace FileSystem
   class Directory
   {
   public:
+    // names found by one scan of a directory, "." and ".." excluded
+
+    struct Listing
+    {
+      std::vector<std::string> files;
+      std::vector<std::string> dirs;
+      void clear() { files.clear(); dirs.clear(); }
+    };
+
     static bool create(const std::string& path);
     static bool remove(const std::string& path);
     static bool exists(const std::string& path);
@@ -257,6 +348,9 @@ namespace FileSystem
     static bool setCurrentDirectory(const std::string& path);
     static std::vector<std::string> getFiles(const std::string& path=".", const std::string& pattern="*.*");
     static std::vector<std::string> getDirectories(const std::string& path=".", const std::string& pattern="*.*");
+    static bool list(const std::string& path, Listing& listing);
+    static size_t filter(std::vector<std::string>& names, const std::string& pattern);
+    static bool match(const std::string& name, const std::string& pattern);
   private:
     //static const int BufSize = 255;
     //char buffer[BufSize];
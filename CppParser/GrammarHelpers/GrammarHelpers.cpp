@@ -1,6 +1,6 @@
 /////////////////////////////////////////////////////////////////////////
 // GrammarHelpers.cpp - Functions providing base grammatical analyses  //
-// ver 1.4                                                             //
+// ver 1.5                                                             //
 // Language:    C++, Visual Studio 2015                                //
 // Application: Support for Parsing, CSE687 - Object Oriented Design   //
 // Author:      Jim Fawcett, Syracuse University, CST 4-187            //
@@ -108,14 +108,9 @@ bool GrammarHelper::isFunctionDefinition(const Lexer::ITokenCollection& se)
 
 size_t GrammarHelper::findLast(const Lexer::ITokenCollection& se, const std::string& token)
 {
-  size_t endIndex = se.size() - 1;
-  for (size_t i = 0; i < se.size(); ++i)
-  {
-    std::string debugTok = se[endIndex - i];
-    if (se[endIndex - i] == token)
-      return endIndex - i;
-  }
-  return se.size();
+  size_t index;
+  se.findLast(token, index);  // index is se.size() if not found
+  return index;
 }
 //----< is tok a type qualifier keyword ? >--------------------------
 
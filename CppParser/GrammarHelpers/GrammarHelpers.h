@@ -2,7 +2,7 @@
 #define GRAMMARHELPERS_H
 /////////////////////////////////////////////////////////////////////////
 // GrammarHelpers.h - Functions providing base grammatical analyses    //
-// ver 1.4                                                             //
+// ver 1.5                                                             //
 // Language:    C++, Visual Studio 2015                                //
 // Application: Support for Parsing, CSE687 - Object Oriented Design   //
 // Author:      Jim Fawcett, Syracuse University, CST 4-187            //
@@ -30,6 +30,9 @@
 *
 * Maintenance History:
 * --------------------
+* ver 1.5 : 19 Oct 2026
+* - findLast defers to ITokenCollection::findLast, which answers
+*   indexed tokens without a scan or a copy of each token
 * ver 1.4 : 07 Jun 2017
 * - temporarily disabled finding C# lambdas in isFunction
 * ver 1.3 : 26 Feb 2017
@@ -1,6 +1,6 @@
 /////////////////////////////////////////////////////////////////////
 //  ActionsAndRules.cpp - implements new parsing rules and actions //
-//  ver 3.4                                                        //
+//  ver 3.6                                                        //
 //  Language:      Visual C++ 2008, SP1                            //
 //  Platform:      Dell Precision T7400, Vista Ultimate SP1        //
 //  Application:   Prototype for CSE687 Pr1, Sp09                  //
@@ -13,7 +13,7 @@
 
 using namespace CodeAnalysis;
 
-Repository* Repository::instance;
+thread_local Repository* Repository::instance;
 
 #ifdef TEST_ACTIONSANDRULES
 
@@ -2,7 +2,7 @@
 #define ACTIONSANDRULES_H
 /////////////////////////////////////////////////////////////////////
 //  ActionsAndRules.h - declares new parsing rules and actions     //
-//  ver 3.5                                                        //
+//  ver 3.7                                                        //
 //  Language:      Visual C++ 2008, SP1                            //
 //  Platform:      Dell Precision T7400, Vista Ultimate SP1        //
 //  Application:   Prototype for CSE687 Pr1, Sp09                  //
@@ -26,6 +26,16 @@
 
   Maintenance History:
   ====================
+  ver 3.7 : 19 Oct 2026
+  - added IParseListener and Repository::listener(...), a streaming mode
+    in which scopes and includes are sent to the listener as they are
+    parsed, instead of an AST being built, and no token collections are
+    cloned, so memory holds only the scopes still open
+  - added ScopeListener, which collects the same ScopeLines as a
+    ScopeWalk with ScopeCollector over the AST
+  ver 3.6 : 19 Oct 2026
+  - added Repository::reset() so a built parser can be reused for the
+    next file, and made the current Repository instance per thread
   ver 3.5 : 11 Feb 2019
   - small changes spread over many of the Rule and Action classes, caused
     by changing the lexical scanner, which forced some changes to the
@@ -86,6 +96,40 @@ namespace CodeAnalysis
 
   enum Language { C /* not implemented */, Cpp, CSharp };
 
+  ///////////////////////////////////////////////////////////////////
+  // IParseListener interface
+  // - receives parse events when attached to a Repository
+  // - a scope begins once the statement that opens it has been parsed,
+  //   so its type and name are known, and ends at its closing brace,
+  //   or at endOfFile() if never closed, with endLineCount_ set as the
+  //   AST would hold it
+  // - the ASTNode passed is deleted after endScope returns
+  // - include is sent for each #include, with the file named in quotes
+  //   or angle brackets
+
+  class IParseListener
+  {
+  public:
+    virtual ~IParseListener() {}
+    virtual void beginScope(const ASTNode& /*scope*/) {}
+    virtual void endScope(const ASTNode& /*scope*/) {}
+    virtual void include(const std::string& /*file*/, bool /*isSystem*/, size_t /*line*/) {}
+  };
+
+  ///////////////////////////////////////////////////////////////////
+  // ScopeListener class
+  // - collects the scopes a ScopeWalk with ScopeCollector would, in
+  //   the order they close
+
+  class ScopeListener : public IParseListener
+  {
+  public:
+    ScopeListener(Scopes& scopes, unsigned kinds = allScopes) : collect_(scopes, kinds) {}
+    void endScope(const ASTNode& scope) override { collect_(&scope); }
+  private:
+    ScopeCollector collect_;
+  };
+
   class Repository  // application specific
   {
   public:
@@ -104,7 +148,10 @@ namespace CodeAnalysis
     Package package_;
     Lexer::Toker* p_Toker;
     Access currentAccess_ = Access::publ;
-    static Repository* instance;
+    IParseListener* pListener_ = nullptr;
+    ASTNode* pUnannounced_ = nullptr;   // opened by the last statement
+    bool globalClosed_ = false;         // by an unmatched closing brace
+    static thread_local Repository* instance;
   
   public:
     
@@ -120,6 +167,89 @@ namespace CodeAnalysis
       Dbug::write("\n  deleting repository");
     }
 
+    // discard the AST and per file state, and become the current instance
+
+    void reset()
+    {
+      ast.reset();
+      pGlobalScope = stack.top();
+      language_ = Language::Cpp;
+      path_.clear();
+      package_.clear();
+      currentAccess_ = Access::publ;
+      listener(nullptr);
+      instance = this;
+    }
+
+    // send scopes and includes to pListener, building no AST, until
+    // reset - attach before parsing, and call endOfFile() after
+
+    void listener(IParseListener* pListener)
+    {
+      pListener_ = pListener;
+      pUnannounced_ = nullptr;
+      globalClosed_ = false;
+      ast.retainNodes(pListener == nullptr);
+    }
+
+    bool isStreaming() const { return pListener_ != nullptr; }
+
+    // add scope to AST, or when streaming, hold it until its type is set
+
+    void beginScope(ASTNode* pElem)
+    {
+      announceScope();
+      ast.add(pElem);
+      if (pListener_ != nullptr && !globalClosed_)
+        pUnannounced_ = pElem;
+    }
+
+    // send the scope opened by the last statement, now its rules have run
+
+    void announceScope()
+    {
+      if (pUnannounced_ == nullptr)
+        return;
+      pListener_->beginScope(*pUnannounced_);
+      pUnannounced_ = nullptr;
+    }
+
+    // when streaming, send and delete scope just popped from the AST -
+    // as in the AST, scopes opened after the global scope was closed by
+    // an unmatched brace are dropped
+
+    void endScope(ASTNode* pElem)
+    {
+      if (pListener_ == nullptr)
+        return;
+      announceScope();
+      if (pElem == pGlobalScope)
+      {
+        globalClosed_ = true;
+        return;
+      }
+      if (!globalClosed_)
+        pListener_->endScope(*pElem);
+      delete pElem;
+    }
+
+    // when streaming, end scopes still open at end of file
+
+    void endOfFile()
+    {
+      if (pListener_ == nullptr)
+        return;
+      announceScope();
+      while (stack.size() > 0 && stack.top() != pGlobalScope)
+        endScope(ast.pop());
+    }
+
+    void include(const std::string& file, bool isSystem)
+    {
+      if (pListener_ != nullptr && !globalClosed_)
+        pListener_->include(file, isSystem, lineCount());
+    }
+
     Language& language() { return language_; }
 
     Package& package() { return package_; }
@@ -154,6 +284,10 @@ namespace CodeAnalysis
     {
       GrammarHelper::showParseDemo("Test begin scope", *pTc);
 
+      // first rule run on each statement, so the last one is finished
+
+      Repository::getInstance()->announceScope();
+
       // don't parse Semi with single semicolon token
 
       if (pTc->size() == 1 && (*pTc)[0] == ";")
@@ -193,7 +327,7 @@ namespace CodeAnalysis
        * make this ASTNode child of ASTNode on stack top
        * then push onto stack
        */
-      p_Repos->AST().add(pElem);
+      p_Repos->beginScope(pElem);
     }
   };
 
@@ -247,6 +381,7 @@ namespace CodeAnalysis
         (pElem->endLineCount_)++;
 
       p_Repos->currentAccess() = Access::priv;
+      p_Repos->endScope(pElem);  // when streaming, pElem is sent and deleted
     }
   };
 
@@ -343,6 +478,11 @@ namespace CodeAnalysis
     {
       GrammarHelper::showParseDemo("Handle preproc statement: ", *pTc);
 
+      if (p_Repos->isStreaming())
+      {
+        sendInclude(pTc);
+        return;
+      }
       Lexer::ITokenCollection* pClone = pTc->clone();
       if (p_Repos->scopeStack().size() == 0)
         return;
@@ -351,6 +491,28 @@ namespace CodeAnalysis
 
       GrammarHelper::showParse("Preproc Stmt", *pTc);
     }
+  private:
+    // #include "file" or #include <file>, where the name between
+    // the brackets is split into several tokens
+
+    void sendInclude(const Lexer::ITokenCollection* pTc)
+    {
+      size_t pos;
+      if (!pTc->find("include", pos) || pos == 0 || (*pTc)[pos - 1] != "#" || pos + 1 >= pTc->size())
+        return;
+      const std::string& tok = (*pTc)[pos + 1];
+      if (tok.size() > 1 && tok.front() == '\"' && tok.back() == '\"')
+      {
+        p_Repos->include(tok.substr(1, tok.size() - 2), false);
+      }
+      else if (tok == "<")
+      {
+        std::string file;
+        for (size_t i = pos + 2; i < pTc->size() && (*pTc)[i] != ">"; ++i)
+          file += (*pTc)[i];
+        p_Repos->include(file, true);
+      }
+    }
   };
 
   ///////////////////////////////////////////////////////////////
@@ -663,7 +825,7 @@ namespace CodeAnalysis
         * - leave function ASTNode on stack top as it may have child nodes
         */
         ASTNode* pClassNode = p_Repos->AST().find(className);
-        if (pClassNode == nullptr)
+        if (pClassNode == nullptr || p_Repos->isStreaming())  // no tree when streaming
           return;
         if (p_Repos->scopeStack().size() < 2)
           return;
@@ -1035,9 +1197,9 @@ namespace CodeAnalysis
     {
       GrammarHelper::showParseDemo("Handle C++ declaration: ", *pTc);
 
-      // save declaration info in ASTNode
+      // save declaration info in ASTNode, not kept when streaming
 
-      if (p_Repos->scopeStack().size() == 0)
+      if (p_Repos->scopeStack().size() == 0 || p_Repos->isStreaming())
         return;
 
       ASTNode* pCurrNode = p_Repos->scopeStack().top();
@@ -1152,9 +1314,9 @@ namespace CodeAnalysis
     {
       GrammarHelper::showParseDemo("Handle C# declaration: ", *pTc);
 
-      // store declaration info in ASTNode
+      // store declaration info in ASTNode, not kept when streaming
 
-      if (p_Repos->scopeStack().size() == 0)
+      if (p_Repos->scopeStack().size() == 0 || p_Repos->isStreaming())
         return;
 
       ASTNode* pCurrNode = p_Repos->scopeStack().top();
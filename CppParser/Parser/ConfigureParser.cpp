@@ -1,6 +1,6 @@
 /////////////////////////////////////////////////////////////////////
 //  ConfigureParser.cpp - builds and configures parsers            //
-//  ver 3.3                                                        //
+//  ver 3.6                                                        //
 //                                                                 //
 //  Lanaguage:     Visual C++ 2005                                 //
 //  Platform:      Dell Dimension 9150, Windows XP SP2             //
@@ -69,6 +69,8 @@ bool ConfigParseForCodeAnal::Attach(const std::string& name, bool isFile)
   pToker->close();
   if (!pToker->open(name))
     return false;
+  if (pParser != nullptr)
+    pParser->timeFile(name);
   return true;
   //if (pIn != nullptr)
   //  pIn->close();
@@ -93,6 +95,20 @@ bool ConfigParseForCodeAnal::Attach(const std::string& name, bool isFile)
   //}
   //return pToker->attach(pIn);
 }
+//----< ready a built parser for the next file >------------------
+/*
+ * Discards the AST, scope stack, and tokens left by the last file.
+ * The toker restarts its line count and state when next attached.
+ */
+void ConfigParseForCodeAnal::reset()
+{
+  if (pToker != nullptr)
+    pToker->close();
+  if (pSemi != nullptr)
+    pSemi->clear();
+  if (pRepo != nullptr)
+    pRepo->reset();
+}
 //----< Here's where all the parts get assembled >-----------------
 
 Parser* ConfigParseForCodeAnal::Build()
@@ -196,10 +212,59 @@ Parser* ConfigParseForCodeAnal::Build()
   }
 }
 
+//----< lease takes ownership of a parser until destroyed >--------
+
+ParserPool::Lease::Lease(ParserPool& pool, std::unique_ptr<Config> pConfig)
+  : pPool_(&pool), pConfig_(std::move(pConfig)) {}
+
+ParserPool::Lease::Lease(Lease&& lease)
+  : pPool_(lease.pPool_), pConfig_(std::move(lease.pConfig_)) {}
+
+//----< return parser to its pool >--------------------------------
+
+ParserPool::Lease::~Lease()
+{
+  if (pConfig_)
+    pPool_->release(std::move(pConfig_));
+}
+//----< lend an idle parser, building one only if none are idle >--
+
+ParserPool::Lease ParserPool::acquire()
+{
+  std::unique_ptr<Config> pConfig;
+  if (idle_.size() > 0)
+  {
+    pConfig = std::move(idle_.back());
+    idle_.pop_back();
+    pConfig->reset();
+  }
+  else
+  {
+    pConfig = std::unique_ptr<Config>(new Config);
+    pConfig->Build();
+  }
+  return Lease(*this, std::move(pConfig));
+}
+//----< keep returned parser, unless it failed to build >----------
+
+void ParserPool::release(std::unique_ptr<Config> pConfig)
+{
+  if (pConfig->parser() != nullptr)
+    idle_.push_back(std::move(pConfig));
+}
+//----< each thread has its own pool >-----------------------------
+
+ParserPool& ParserPool::forThisThread()
+{
+  static thread_local ParserPool pool;
+  return pool;
+}
+
 #ifdef TEST_CONFIGUREPARSER
 
 #include <queue>
 #include <string>
+#include <chrono>
 
 int main(int argc, char* argv[])
 {
@@ -250,6 +315,37 @@ int main(int argc, char* argv[])
     }
     std::cout << "\n\n";
   }
+
+  // compare building a parser per file with reusing pooled parsers
+
+  auto parseAll = [&](bool pooled)
+  {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 1; i < argc; ++i)
+    {
+      if (pooled)
+      {
+        ParserPool::Lease lease = ParserPool::forThisThread().acquire();
+        if (lease->parser() && lease->Attach(argv[i]))
+          while (lease->parser()->next())
+            lease->parser()->parse();
+      }
+      else
+      {
+        ConfigParseForCodeAnal configure;
+        Parser* pParser = configure.Build();
+        if (pParser && configure.Attach(argv[i]))
+          while (pParser->next())
+            pParser->parse();
+      }
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  };
+  double built = parseAll(false);
+  double pooled = parseAll(true);
+  std::cout << "\n  parsing " << argc - 1 << " files, parser built per file: " << built << " ms";
+  std::cout << "\n  parsing " << argc - 1 << " files, pooled parser:         " << pooled << " ms";
+  std::cout << "\n  idle parsers in this thread's pool: " << ParserPool::forThisThread().size() << "\n\n";
 }
 
 #endif
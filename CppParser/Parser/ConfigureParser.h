@@ -2,7 +2,7 @@
 #define CONFIGUREPARSER_H
 /////////////////////////////////////////////////////////////////////
 //  ConfigureParser.h - builds and configures parsers              //
-//  ver 3.3                                                        //
+//  ver 3.6                                                        //
 //                                                                 //
 //  Lanaguage:     Visual C++ 2005                                 //
 //  Platform:      Dell Dimension 9150, Windows XP SP2             //
@@ -16,11 +16,33 @@
   This module builds and configures parsers.  It builds the parser
   parts and configures them with application specific rules and actions.
 
+  Building a parser allocates a Toker, a Semi, a Repository and a rule
+  and action for each construct, so a built parser should be reused.
+  reset() discards the AST and token state left by the last file, so
+  the parser can be attached to the next one.  ParserPool keeps built
+  parsers for reuse, one pool per thread, as the tokenizer states and
+  the current Repository are per thread.  Use a parser on the thread
+  that acquired it, and finish one file before attaching another
+  parser of the same thread.
+
   Public Interface:
   =================
   ConfigParseForCodeAnal config;
   config.Build();
   config.Attach(someFileName);
+  config.reset();                    // ready for next Attach
+
+  ParserPool::Lease lease = ParserPool::forThisThread().acquire();
+  if(lease->Attach(someFileName))    // lease returns parser to pool
+    while(lease->parser()->next())   // when it goes out of scope
+      lease->parser()->parse();
+  ASTNode* pGlobal = lease->repository()->getGlobalScope();
+
+  Scopes scopes;                     // or stream scopes, building no AST
+  ScopeListener listener(scopes, classScope | functionScope);
+  lease->repository()->listener(&listener);
+  ... parse as above ...
+  lease->repository()->endOfFile();
 
   Build Process:
   ==============
@@ -36,6 +58,14 @@
 
   Maintenance History:
   ====================
+  ver 3.6 : 19 Oct 2026
+  - Attach() starts the parser's PerfStats timer for the new file
+  ver 3.5 : 19 Oct 2026
+  - documented streaming to an IParseListener; reset() returns the
+    Repository to building an AST
+  ver 3.4 : 19 Oct 2026
+  - added reset(), parser(), and repository() so a built parser can be
+    reused, and ParserPool, which holds built parsers for each thread
   ver 3.3 : 05 Nov 2017
   - modified ConfigureParser to return false on opening empty file
   ver 3.2 : 29 Oct 2016
@@ -55,6 +85,8 @@
 */
 
 #include <fstream>
+#include <memory>
+#include <vector>
 #include "Parser.h"
 #include "ActionsAndRules.h"
 #include "../SemiExpression/Semi.h"
@@ -72,15 +104,18 @@ namespace CodeAnalysis
     ~ConfigParseForCodeAnal();
     bool Attach(const std::string& name, bool isFile = true);
     Parser* Build();
+    void reset();
+    Parser* parser() { return pParser; }
+    Repository* repository() { return pRepo; }
 
   private:
     // Builder must hold onto all the pieces
 
     //std::ifstream* pIn = nullptr;
-    Lexer::Toker* pToker;
-    Lexer::Semi* pSemi;
-    Parser* pParser;
-    Repository* pRepo;
+    Lexer::Toker* pToker = nullptr;
+    Lexer::Semi* pSemi = nullptr;
+    Parser* pParser = nullptr;
+    Repository* pRepo = nullptr;
 
     // add Rules and Actions
 
@@ -132,5 +167,39 @@ namespace CodeAnalysis
     ConfigParseForCodeAnal(const ConfigParseForCodeAnal&) = delete;
     ConfigParseForCodeAnal& operator=(const ConfigParseForCodeAnal&) = delete;
   };
+
+  ///////////////////////////////////////////////////////////////
+  // holds built parsers for reuse by one thread
+
+  class ParserPool
+  {
+  public:
+    using Config = ConfigParseForCodeAnal;
+
+    // returns its parser to the pool when destroyed
+
+    class Lease
+    {
+    public:
+      Lease(ParserPool& pool, std::unique_ptr<Config> pConfig);
+      Lease(Lease&& lease);
+      ~Lease();
+      Config* operator->() { return pConfig_.get(); }
+      Config& operator*() { return *pConfig_; }
+    private:
+      ParserPool* pPool_;
+      std::unique_ptr<Config> pConfig_;
+      Lease(const Lease&) = delete;
+      Lease& operator=(const Lease&) = delete;
+    };
+
+    Lease acquire();
+    size_t size() const { return idle_.size(); }
+    static ParserPool& forThisThread();
+
+  private:
+    void release(std::unique_ptr<Config> pConfig);
+    std::vector<std::unique_ptr<Config>> idle_;
+  };
 }
 #endif
@@ -1,6 +1,6 @@
 /////////////////////////////////////////////////////////////////////
 //  Parser.cpp - Analyzes C++ and C# language constructs           //
-//  ver 1.0                                                        //
+//  ver 1.3                                                        //
 //  Language:      Visual C++, Visual Studio 2015                  //
 //  Platform:      Dell XPS 8920, Windows 10                       //
 //  Application:   Prototype for CSE687 - OOD Projects             //
@@ -17,6 +17,25 @@
 #include "ActionsAndRules.h"
 #include "ConfigureParser.h"
 
+#ifdef PROFILE_RULES
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <mutex>
+#include <typeinfo>
+#if defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define RULE_CYCLES() __rdtsc()
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define RULE_CYCLES() __rdtsc()
+#endif
+#ifdef __GNUG__
+#include <cxxabi.h>
+#include <cstdlib>
+#endif
+#endif
+
 //using namespace CodeAnalysis;
 using namespace Lexer;
 using namespace Utilities;
@@ -24,11 +43,141 @@ using Demo = Logging::StaticLogger<1>;
 
 namespace CodeAnalysis {
 
+#ifdef PROFILE_RULES
+	namespace
+	{
+		// profile of the rule whose doTest is running on this thread
+		thread_local RuleProfile* pActiveProfile = nullptr;
+
+		// profiles of destroyed parsers, and parsers still alive
+		std::mutex profilesMtx;
+		std::vector<RuleProfile> retiredProfiles;
+		std::vector<Parser*> liveParsers;
+
+		//----< time stamp counter, or nanoseconds where there is none >
+
+		inline uint64_t cycles()
+		{
+#ifdef RULE_CYCLES
+			return RULE_CYCLES();
+#else
+			return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+		}
+		//----< readable class name of rule >--------------------------
+
+		std::string ruleName(IRule* pRule)
+		{
+			std::string name = typeid(*pRule).name();
+#ifdef __GNUG__
+			int status = 0;
+			char* pName = abi::__cxa_demangle(name.c_str(), nullptr, nullptr, &status);
+			if (status == 0 && pName != nullptr)
+				name = pName;
+			std::free(pName);
+#endif
+			size_t pos = name.rfind("::");
+			if (pos != std::string::npos)
+				name = name.substr(pos + 2);
+			else if (name.compare(0, 6, "class ") == 0)
+				name = name.substr(6);
+			return name;
+		}
+		//----< add profiles to totals, matching by rule name >--------
+
+		void merge(std::vector<RuleProfile>& totals, const std::vector<RuleProfile>& profiles)
+		{
+			for (const RuleProfile& profile : profiles)
+			{
+				auto iter = std::find_if(totals.begin(), totals.end(),
+					[&](const RuleProfile& total) { return total.rule == profile.rule; });
+				if (iter == totals.end())
+				{
+					totals.push_back(profile);
+					continue;
+				}
+				iter->tests += profile.tests;
+				iter->matches += profile.matches;
+				iter->testCycles += profile.testCycles;
+				iter->actionCycles += profile.actionCycles;
+			}
+		}
+	}
+	//----< profiling parser registers itself for ruleProfiles() >---
+
+	Parser::Parser(Lexer::ITokenCollection* pTokCollection) : pTokColl(pTokCollection)
+	{
+		std::lock_guard<std::mutex> lock(profilesMtx);
+		liveParsers.push_back(this);
+	}
+
+	Parser::~Parser()
+	{
+		std::lock_guard<std::mutex> lock(profilesMtx);
+		merge(retiredProfiles, profiles_);
+		liveParsers.erase(std::remove(liveParsers.begin(), liveParsers.end(), this), liveParsers.end());
+	}
+	//----< profiles of all parsers, merged by rule >----------------
+
+	std::vector<RuleProfile> Parser::ruleProfiles()
+	{
+		std::lock_guard<std::mutex> lock(profilesMtx);
+		std::vector<RuleProfile> totals = retiredProfiles;
+		for (Parser* pParser : liveParsers)
+			merge(totals, pParser->profiles_);
+		return totals;
+	}
+	//----< show rule profiles, costliest first >--------------------
+	/*
+	 * cycles are doTest's, including actions; self excludes them
+	 */
+	void Parser::showRuleProfiles(std::ostream& out)
+	{
+		std::vector<RuleProfile> profiles = ruleProfiles();
+		std::sort(profiles.begin(), profiles.end(),
+			[](const RuleProfile& a, const RuleProfile& b) { return a.testCycles > b.testCycles; });
+		uint64_t total = 0;
+		for (const RuleProfile& profile : profiles)
+			total += profile.testCycles;
+
+		std::ios::fmtflags flags = out.flags();
+		std::streamsize precision = out.precision();
+		out << std::fixed << std::setprecision(1);
+		out << "\n  " << std::left << std::setw(26) << "rule" << std::right
+			<< std::setw(6) << "order" << std::setw(11) << "tests" << std::setw(10) << "matches"
+			<< std::setw(8) << "hit %" << std::setw(11) << "Mcycles" << std::setw(11) << "self"
+			<< std::setw(11) << "actions" << std::setw(10) << "cyc/test" << std::setw(8) << "share";
+		for (const RuleProfile& profile : profiles)
+		{
+			out << "\n  " << std::left << std::setw(26) << profile.rule << std::right
+				<< std::setw(6) << profile.order
+				<< std::setw(11) << profile.tests
+				<< std::setw(10) << profile.matches
+				<< std::setw(8) << (profile.tests ? 100.0 * profile.matches / profile.tests : 0.0)
+				<< std::setw(11) << profile.testCycles / 1e6
+				<< std::setw(11) << (profile.testCycles - profile.actionCycles) / 1e6
+				<< std::setw(11) << profile.actionCycles / 1e6
+				<< std::setw(10) << (profile.tests ? double(profile.testCycles) / profile.tests : 0.0)
+				<< std::setw(7) << (total ? 100.0 * profile.testCycles / total : 0.0) << "%";
+		}
+		out << "\n";
+		out.flags(flags);
+		out.precision(precision);
+	}
+#endif
+
 	//----< register parsing rule >--------------------------------
 
 	void Parser::addRule(IRule* pRule)
 	{
 		rules.push_back(pRule);
+#ifdef PROFILE_RULES
+		RuleProfile profile;
+		profile.rule = ruleName(pRule);
+		profile.order = rules.size() - 1;
+		profiles_.push_back(profile);
+#endif
 	}
 	//----< get next ITokenCollection >------------------------------
 
@@ -37,6 +186,7 @@ namespace CodeAnalysis {
 		bool succeeded = pTokColl->get();
 		if (!succeeded)
 		{
+			fileTimer_.stop();
 			return false;
 		}
 
@@ -51,12 +201,29 @@ namespace CodeAnalysis {
 	{
 		for (size_t i = 0; i < rules.size(); ++i)
 		{
+#ifdef PROFILE_RULES
+			RuleProfile& profile = profiles_[i];
+			RuleProfile* pOuter = pActiveProfile;
+			pActiveProfile = &profile;
+			uint64_t start = cycles();
 			bool doWhat = rules[i]->doTest(pTokColl);
+			profile.testCycles += cycles() - start;
+			++profile.tests;
+			pActiveProfile = pOuter;
+#else
+			bool doWhat = rules[i]->doTest(pTokColl);
+#endif
 			if (doWhat == IRule::Stop)
 				break;
 		}
 		return true;
 	}
+	//----< start timing the parse of a newly attached file >----
+
+	void Parser::timeFile(const std::string& file)
+	{
+		fileTimer_.start(PerfStats::parse, file);
+	}
 	//----< register action with a rule >--------------------------
 
 	void IRule::addAction(IAction *pAction)
@@ -67,9 +234,20 @@ namespace CodeAnalysis {
 
 	void IRule::doActions(const Lexer::ITokenCollection* pTokColl)
 	{
+#ifdef PROFILE_RULES
+		RuleProfile* pProfile = pActiveProfile;
+		uint64_t start = cycles();
+#endif
 		if (actions.size() > 0)
 			for (size_t i = 0; i < actions.size(); ++i)
 				actions[i]->doAction(pTokColl);
+#ifdef PROFILE_RULES
+		if (pProfile != nullptr)
+		{
+			++pProfile->matches;
+			pProfile->actionCycles += cycles() - start;
+		}
+#endif
 	}
 
 	//----< test stub >--------------------------------------------
@@ -80,14 +258,14 @@ namespace CodeAnalysis {
 #include "../FileSystem/FileSystem.h"
 #include <queue>
 #include <string>
-#define Util StringHelper
+#define Util Utilities1::StringHelper
 
 using namespace CodeAnalysis;
 
 int main(int argc, char* argv[])
 {
 	Util::Title("Testing Parser Class");
-	putline();
+	Utilities1::putline();
 
 	// Analyzing files, named on the command line
 
@@ -153,8 +331,9 @@ int main(int argc, char* argv[])
 			// by generation
 			TreeWalk(pGlobalScope);
 
-			std::vector<std::vector<int>> vec;
-			vec = TreeWalkToGetLineCountOfFunction(pGlobalScope, vec);
+			Scopes scopes;
+			ScopeCollector collect(scopes, functionScope);
+			ScopeWalk(pGlobalScope, collect);
 
 			std::cout << "\n";
 		}
@@ -166,7 +345,18 @@ int main(int argc, char* argv[])
 		}
 		std::cout << "\n";
 	}
+
+	// rules' finds answered from each semi's TokenIndex vs scans made
+
+	TokenIndex::Stats& stats = TokenIndex::stats();
+	std::cout << "\n  token index: " << stats.builds << " semis indexed, "
+		<< stats.lookups << " finds answered by index, "
+		<< stats.scans << " scans";
 	std::cout << "\n";
+
+#ifdef PROFILE_RULES
+	Parser::showRuleProfiles();
+#endif
 }
 
 #endif
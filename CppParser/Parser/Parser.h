@@ -2,7 +2,7 @@
 #define PARSER_H
 /////////////////////////////////////////////////////////////////////
 //  Parser.h - Analyzes C++ and C# language constructs             //
-//  ver 1.0                                                        //
+//  ver 1.3                                                        //
 //  Language:      Visual C++, Visual Studio 2015                  //
 //  Platform:      Dell XPS 8920, Windows 10                       //
 //  Application:   Prototype for CSE687 - OOD Projects             //
@@ -17,6 +17,17 @@
   Analysis consists of applying a set of rules to the semi-expression, 
   and for each rule that matches, invoking a set of one or more actions.
 
+  Rule profiling:
+  ===============
+  Define PROFILE_RULES, for every project that compiles the parser, to
+  count for each rule how often doTest ran and matched, and the CPU
+  cycles spent in doTest and in the actions it invoked.  Without it,
+  parse() and doActions() compile to exactly the code they had before.
+    Parser::showRuleProfiles();      // table sorted by cycles
+    std::vector<RuleProfile> profiles = Parser::ruleProfiles();
+  Profiles of all parsers are merged by rule, so call these when no
+  thread is parsing.
+
   Build Process:
   ==============
   Required files
@@ -31,10 +42,20 @@
     - ConfigureParser.h, ConfigureParser.cpp,
     - FileSystem.h, FileSystem.cpp,
     - Logger.h, Logger.cpp,
-    - Utilities.h, Utilities.cpp
+    - Utilities.h, Utilities.cpp,
+    - PerfStats.h, PerfStats.cpp
 
   Maintenance History:
   ===================
+  ver 1.3 : 19 Oct 2026
+  - added rule profiling, compiled only when PROFILE_RULES is defined
+  ver 1.2 : 19 Oct 2026
+  - added timeFile(), which times the parse of the attached file, from
+    the first next() to the one that finds its end, as PerfStats' parse
+    stage
+  ver 1.1 : 19 Oct 2026
+  - test stub reports how many of the rules' token finds were answered
+    from the semi's TokenIndex and how many still scanned
   ver 1.0 : 11 Feb 2019
   - first release
   - This is a modification of the parser used in CodeAnalyzer.
@@ -47,6 +68,10 @@
 #include <iostream>
 #include <vector>
 #include "../SemiExpression/ITokenCollection.h"
+#include "../PerfStats/PerfStats.h"
+#ifdef PROFILE_RULES
+#include <cstdint>
+#endif
 
 namespace CodeAnalysis
 {
@@ -91,6 +116,21 @@ namespace CodeAnalysis
     std::vector<IAction*> actions;
   };
 
+#ifdef PROFILE_RULES
+  ///////////////////////////////////////////////////////////////
+  // tests, matches and cycles of one rule
+
+  struct RuleProfile
+  {
+    std::string rule;
+    size_t order = 0;           // position in the parser's rule list
+    size_t tests = 0;           // doTest calls
+    size_t matches = 0;         // doActions calls
+    uint64_t testCycles = 0;    // in doTest, including actions
+    uint64_t actionCycles = 0;  // in doActions
+  };
+#endif
+
   class Parser
   {
   public:
@@ -99,13 +139,24 @@ namespace CodeAnalysis
     void addRule(IRule* pRule);
     bool parse();
     bool next();
+    void timeFile(const std::string& file);  // no-op unless PerfStats are enabled
+#ifdef PROFILE_RULES
+    static std::vector<RuleProfile> ruleProfiles();
+    static void showRuleProfiles(std::ostream& out = std::cout);
+#endif
   private:
     Lexer::ITokenCollection* pTokColl;
     std::vector<IRule*> rules;
+    PerfStats::Timer fileTimer_;
+#ifdef PROFILE_RULES
+    std::vector<RuleProfile> profiles_;  // parallel to rules
+#endif
   };
 
+#ifndef PROFILE_RULES
   inline Parser::Parser(Lexer::ITokenCollection* pTokCollection) : pTokColl(pTokCollection) {}
 
   inline Parser::~Parser() {}
+#endif
 }
 #endif
@@ -0,0 +1,305 @@
+/////////////////////////////////////////////////////////////////////
+// MemStats.cpp - heap use and peak memory of each publish stage   //
+// ver 1.0                                                         //
+// Sneha Giranje, CSE687 - Object Oriented Design, Spring 2019     //
+/////////////////////////////////////////////////////////////////////
+
+#include "MemStats.h"
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <new>
+
+namespace PerfStats
+{
+  namespace
+  {
+    const size_t slots = stageCount + 1;
+
+    // statics of atomics are zeroed before any code runs, so the
+    // hooks can count allocations made during static initialization
+    std::atomic<uint64_t> allocations_[slots];
+    std::atomic<uint64_t> frees_[slots];
+    std::atomic<uint64_t> bytesAllocated_[slots];
+    std::atomic<uint64_t> bytesFreed_[slots];
+    std::atomic<int64_t> stageLive_[slots];
+    std::atomic<int64_t> stagePeak_[slots];
+    std::atomic<int64_t> live_;
+    std::atomic<int64_t> peak_;
+
+    // keeps blocks aligned as malloc aligns them
+    union Header
+    {
+      struct
+      {
+        size_t size;
+        unsigned stage;
+      } info;
+      std::max_align_t align;
+    };
+
+    const char* slotName(size_t slot)
+    {
+      return slot < stageCount ? stageName(Stage(slot)) : "other";
+    }
+
+    void raise(std::atomic<int64_t>& peak, int64_t value)
+    {
+      int64_t seen = peak.load(std::memory_order_relaxed);
+      while (value > seen && !peak.compare_exchange_weak(seen, value, std::memory_order_relaxed))
+        ;
+    }
+  }
+  //----< heap blocks are counted only in TRACK_ALLOCATIONS builds >--
+
+  bool allocationsTracked()
+  {
+#ifdef TRACK_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  /////////////////////////////////////////////////////////////////////
+  // MemStats
+
+  MemStats::MemStats()
+  {
+    reset();
+  }
+
+  MemStats& MemStats::instance()
+  {
+    static MemStats stats;
+    return stats;
+  }
+  //----< malloc a block with a header, charged to current stage >---
+
+  void* MemStats::allocate(size_t size)
+  {
+    if (size > size_t(-1) - sizeof(Header))
+      return nullptr;
+    Header* pHeader = static_cast<Header*>(std::malloc(sizeof(Header) + size));
+    if (pHeader == nullptr)
+      return nullptr;
+    size_t slot = currentStage();
+    pHeader->info.size = size;
+    pHeader->info.stage = (unsigned)slot;
+
+    allocations_[slot].fetch_add(1, std::memory_order_relaxed);
+    bytesAllocated_[slot].fetch_add(size, std::memory_order_relaxed);
+    raise(stagePeak_[slot], stageLive_[slot].fetch_add(size, std::memory_order_relaxed) + (int64_t)size);
+    raise(peak_, live_.fetch_add(size, std::memory_order_relaxed) + (int64_t)size);
+    return pHeader + 1;
+  }
+  //----< free a block, crediting the stage that allocated it >------
+
+  void MemStats::release(void* pBlock)
+  {
+    if (pBlock == nullptr)
+      return;
+    Header* pHeader = static_cast<Header*>(pBlock) - 1;
+    size_t size = pHeader->info.size;
+    size_t slot = pHeader->info.stage;
+
+    frees_[slot].fetch_add(1, std::memory_order_relaxed);
+    bytesFreed_[slot].fetch_add(size, std::memory_order_relaxed);
+    stageLive_[slot].fetch_sub(size, std::memory_order_relaxed);
+    live_.fetch_sub(size, std::memory_order_relaxed);
+    std::free(pHeader);
+  }
+  //----< record live bytes and peak RSS as a timer starts or stops >-
+
+  void MemStats::boundary(Stage stage, bool end)
+  {
+    size_t slot = stage < stageCount ? stage : stageCount;
+    Boundary mark;
+    mark.atNs = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start_).count();
+    mark.stage = Stage(slot);
+    mark.end = end;
+    mark.liveBytes = live_.load(std::memory_order_relaxed);
+    mark.peakRss = peakRssBytes();
+
+    std::lock_guard<std::mutex> lock(mtx_);
+    ++boundaryCount_[slot];
+    if (mark.liveBytes > maxLiveAtBoundary_[slot])
+      maxLiveAtBoundary_[slot] = mark.liveBytes;
+    if (mark.peakRss > peakRssAtBoundary_[slot])
+      peakRssAtBoundary_[slot] = mark.peakRss;
+    if (timeline_.size() < maxBoundaries)
+      timeline_.push_back(mark);
+    else
+      ++dropped_;
+  }
+
+  MemStats::StageMemory MemStats::stage(Stage stage) const
+  {
+    size_t slot = stage < stageCount ? stage : stageCount;
+    StageMemory memory;
+    memory.allocations = allocations_[slot].load(std::memory_order_relaxed);
+    memory.frees = frees_[slot].load(std::memory_order_relaxed);
+    memory.bytesAllocated = bytesAllocated_[slot].load(std::memory_order_relaxed);
+    memory.bytesFreed = bytesFreed_[slot].load(std::memory_order_relaxed);
+    memory.liveBytes = stageLive_[slot].load(std::memory_order_relaxed);
+    memory.peakLiveBytes = stagePeak_[slot].load(std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(mtx_);
+    memory.boundaries = boundaryCount_[slot];
+    memory.maxLiveAtBoundary = maxLiveAtBoundary_[slot];
+    memory.peakRssAtBoundary = peakRssAtBoundary_[slot];
+    return memory;
+  }
+
+  int64_t MemStats::liveBytes() const
+  {
+    return live_.load(std::memory_order_relaxed);
+  }
+
+  int64_t MemStats::peakLiveBytes() const
+  {
+    return peak_.load(std::memory_order_relaxed);
+  }
+
+  std::vector<MemStats::Boundary> MemStats::boundaries() const
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return timeline_;
+  }
+  //----< clear counts and timeline >--------------------------------
+  /*
+   * Live bytes are kept, since blocks allocated before the reset are
+   * still freed later; peaks restart from what is live now.
+   */
+  void MemStats::reset()
+  {
+    for (size_t slot = 0; slot < slots; ++slot)
+    {
+      allocations_[slot].store(0, std::memory_order_relaxed);
+      frees_[slot].store(0, std::memory_order_relaxed);
+      bytesAllocated_[slot].store(0, std::memory_order_relaxed);
+      bytesFreed_[slot].store(0, std::memory_order_relaxed);
+      stagePeak_[slot].store(stageLive_[slot].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    peak_.store(live_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+    std::vector<Boundary> timeline;
+    timeline.reserve(4096);
+    std::lock_guard<std::mutex> lock(mtx_);
+    for (size_t slot = 0; slot < slots; ++slot)
+    {
+      boundaryCount_[slot] = 0;
+      maxLiveAtBoundary_[slot] = 0;
+      peakRssAtBoundary_[slot] = 0;
+    }
+    timeline_.swap(timeline);
+    dropped_ = 0;
+    start_ = std::chrono::steady_clock::now();
+  }
+  //----< write the report as a JSON object >------------------------
+
+  void MemStats::writeJson(std::ostream& out) const
+  {
+    std::vector<StageMemory> stages;
+    for (size_t slot = 0; slot < slots; ++slot)
+      stages.push_back(stage(Stage(slot)));
+    std::vector<Boundary> timeline = boundaries();
+
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << std::fixed << std::setprecision(3);
+
+    out << "{\n";
+    out << "  \"allocationsTracked\": " << (allocationsTracked() ? "true" : "false") << ",\n";
+    out << "  \"liveBytes\": " << liveBytes() << ",\n";
+    out << "  \"peakLiveBytes\": " << peakLiveBytes() << ",\n";
+    out << "  \"peakRssBytes\": " << peakRssBytes() << ",\n";
+    out << "  \"stages\": [";
+    for (size_t slot = 0; slot < slots; ++slot)
+    {
+      const StageMemory& memory = stages[slot];
+      out << (slot == 0 ? "\n" : ",\n");
+      out << "    { \"stage\": \"" << slotName(slot) << "\"";
+      out << ", \"allocations\": " << memory.allocations;
+      out << ", \"frees\": " << memory.frees;
+      out << ", \"bytesAllocated\": " << memory.bytesAllocated;
+      out << ", \"bytesFreed\": " << memory.bytesFreed;
+      out << ", \"liveBytes\": " << memory.liveBytes;
+      out << ", \"peakLiveBytes\": " << memory.peakLiveBytes;
+      out << ", \"boundaries\": " << memory.boundaries;
+      out << ", \"maxLiveAtBoundary\": " << memory.maxLiveAtBoundary;
+      out << ", \"peakRssAtBoundary\": " << memory.peakRssAtBoundary;
+      out << " }";
+    }
+    out << "\n  ],\n";
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      out << "  \"droppedBoundaries\": " << dropped_ << ",\n";
+    }
+    out << "  \"boundaries\": [";
+    for (size_t i = 0; i < timeline.size(); ++i)
+    {
+      const Boundary& mark = timeline[i];
+      out << (i == 0 ? "\n" : ",\n");
+      out << "    { \"ms\": " << mark.atNs / 1e6;
+      out << ", \"stage\": \"" << slotName(mark.stage) << "\"";
+      out << ", \"edge\": \"" << (mark.end ? "end" : "start") << "\"";
+      out << ", \"liveBytes\": " << mark.liveBytes;
+      out << ", \"peakRssBytes\": " << mark.peakRss << " }";
+    }
+    out << "\n  ]\n}\n";
+
+    out.flags(flags);
+    out.precision(precision);
+  }
+}
+
+#ifdef TRACK_ALLOCATIONS
+
+/////////////////////////////////////////////////////////////////////
+// replacements of the global operator new and delete
+// - array and nothrow forms are replaced too, so every form pairs
+//   with a delete that knows the header
+
+namespace
+{
+  void* allocateOrThrow(size_t size)
+  {
+    for (;;)
+    {
+      void* pBlock = PerfStats::MemStats::allocate(size);
+      if (pBlock != nullptr)
+        return pBlock;
+      std::new_handler handler = std::get_new_handler();
+      if (handler == nullptr)
+        throw std::bad_alloc();
+      handler();
+    }
+  }
+
+  void* allocateOrNull(size_t size) noexcept
+  {
+    try {
+      return allocateOrThrow(size);
+    }
+    catch (...) {
+      return nullptr;
+    }
+  }
+}
+
+void* operator new(size_t size) { return allocateOrThrow(size); }
+void* operator new[](size_t size) { return allocateOrThrow(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return allocateOrNull(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return allocateOrNull(size); }
+
+void operator delete(void* pBlock) noexcept { PerfStats::MemStats::release(pBlock); }
+void operator delete[](void* pBlock) noexcept { PerfStats::MemStats::release(pBlock); }
+void operator delete(void* pBlock, const std::nothrow_t&) noexcept { PerfStats::MemStats::release(pBlock); }
+void operator delete[](void* pBlock, const std::nothrow_t&) noexcept { PerfStats::MemStats::release(pBlock); }
+void operator delete(void* pBlock, size_t) noexcept { PerfStats::MemStats::release(pBlock); }
+void operator delete[](void* pBlock, size_t) noexcept { PerfStats::MemStats::release(pBlock); }
+
+#endif
@@ -0,0 +1,131 @@
+#ifndef MEMSTATS_H
+#define MEMSTATS_H
+/////////////////////////////////////////////////////////////////////
+// MemStats.h - heap use and peak memory of each publish stage     //
+// ver 1.0                                                         //
+// Sneha Giranje, CSE687 - Object Oriented Design, Spring 2019     //
+/////////////////////////////////////////////////////////////////////
+/*
+ * Package Operations:
+ * -------------------
+ * Measures where a publish spends its memory.  Built with
+ * TRACK_ALLOCATIONS defined, MemStats.cpp replaces the global
+ * operator new and delete.  Each block gets a small header holding
+ * its size and the stage of the innermost PerfStats Timer running on
+ * the allocating thread, so every allocation, and its later free, is
+ * charged to the stage that made it.  Blocks allocated outside any
+ * timer are charged to "other".  A stage's live bytes are the bytes
+ * it allocated that are not yet freed, so a stage that builds a
+ * table kept for the rest of the publish shows it there.
+ *
+ * The counters are atomics, updated without locking and without
+ * allocating, so threads don't serialize on the heap hooks.  Blocks
+ * from the aligned forms of new, C++17 only, are not counted.
+ *
+ * While memory tracking is on, trackMemory(true), timers run even if
+ * counting and tracing are off, and each timer's start and stop is a
+ * stage boundary: the process's live heap bytes and peak resident
+ * set size are recorded there, both per stage and, for the first
+ * maxBoundaries of them, as a timeline.  Boundaries are recorded in
+ * every build, so a build without TRACK_ALLOCATIONS still reports
+ * peak RSS at each boundary, with zero heap counts.
+ *
+ * Public Interface:
+ * -----------------
+ * PerfStats::trackMemory(true);
+ * ... publish ...
+ * PerfStats::MemStats::instance().writeJson(std::cout);
+ * PerfStats::MemStats::StageMemory m = PerfStats::MemStats::instance().stage(PerfStats::parse);
+ *
+ * Required Files:
+ * ---------------
+ * MemStats.h, MemStats.cpp, PerfStats.h, PerfStats.cpp
+ *
+ * Build Process:
+ * --------------
+ * Define TRACK_ALLOCATIONS for the whole build, e.g., cl /DTRACK_ALLOCATIONS,
+ * to count heap use.  A normal build keeps the library's operators.
+ *
+ * Maintenance History
+ * -------------------
+ * ver 1.0 : 19 Oct 2026
+ * - first release
+ */
+
+#include "PerfStats.h"
+#include <string>
+#include <vector>
+#include <mutex>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <iosfwd>
+
+namespace PerfStats
+{
+  void trackMemory(bool on = true);  // turning on also clears the counts
+  bool trackingMemory();
+  bool allocationsTracked();         // built with TRACK_ALLOCATIONS
+
+  ///////////////////////////////////////////////////////////////////
+  // MemStats class
+  // - heap counts per stage and memory at stage boundaries
+  // - index stageCount holds allocations made outside any timer
+
+  class MemStats
+  {
+  public:
+    struct StageMemory
+    {
+      uint64_t allocations = 0;
+      uint64_t frees = 0;             // of blocks the stage allocated
+      uint64_t bytesAllocated = 0;
+      uint64_t bytesFreed = 0;
+      int64_t liveBytes = 0;          // allocated by the stage, not yet freed
+      int64_t peakLiveBytes = 0;
+      uint64_t boundaries = 0;        // timer starts and stops
+      int64_t maxLiveAtBoundary = 0;  // process live bytes
+      uint64_t peakRssAtBoundary = 0;
+    };
+
+    struct Boundary
+    {
+      uint64_t atNs = 0;              // since tracking was turned on
+      Stage stage = stageCount;
+      bool end = false;               // timer stop, else start
+      int64_t liveBytes = 0;
+      uint64_t peakRss = 0;
+    };
+
+    static const size_t maxBoundaries = 100000;
+
+    static MemStats& instance();
+
+    // called by the heap hooks, so neither locks nor allocates
+    static void* allocate(size_t size);
+    static void release(void* pBlock);
+
+    void boundary(Stage stage, bool end);   // called by Timer
+    StageMemory stage(Stage stage) const;
+    int64_t liveBytes() const;
+    int64_t peakLiveBytes() const;
+    std::vector<Boundary> boundaries() const;
+    void reset();
+    void writeJson(std::ostream& out) const;
+
+  private:
+    MemStats();
+
+    mutable std::mutex mtx_;
+    uint64_t boundaryCount_[stageCount + 1];
+    int64_t maxLiveAtBoundary_[stageCount + 1];
+    uint64_t peakRssAtBoundary_[stageCount + 1];
+    std::vector<Boundary> timeline_;
+    size_t dropped_ = 0;
+    std::chrono::steady_clock::time_point start_;
+
+    MemStats(const MemStats&) = delete;
+    MemStats& operator=(const MemStats&) = delete;
+  };
+}
+#endif
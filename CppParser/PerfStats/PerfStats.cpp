@@ -0,0 +1,477 @@
+/////////////////////////////////////////////////////////////////////
+// PerfStats.cpp - per-stage timers and counters for a publish     //
+// ver 1.3                                                         //
+// Sneha Giranje, CSE687 - Object Oriented Design, Spring 2019     //
+/////////////////////////////////////////////////////////////////////
+
+#include "PerfStats.h"
+#include "Trace.h"
+#include "MemStats.h"
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <iostream>
+#include <cmath>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <time.h>
+#include <sys/resource.h>
+#endif
+
+namespace PerfStats
+{
+  namespace
+  {
+    const unsigned counting = 1;
+    const unsigned tracingEvents = 2;
+    const unsigned memory = 4;
+    std::atomic<unsigned> activeModes_(0);
+
+    // innermost running timer of this thread, the parent of the next
+    thread_local Timer* pCurrent_ = nullptr;
+
+    const char* stageNames[stageCount] = {
+      "extract", "parse", "dependencies", "symbols", "convert", "highlight"
+    };
+
+    uint64_t elapsedNs(std::chrono::steady_clock::time_point start)
+    {
+      return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    }
+
+    double seconds(uint64_t ns) { return ns / 1e9; }
+
+    double perSecond(uint64_t count, uint64_t ns)
+    {
+      return ns == 0 ? 0.0 : count / seconds(ns);
+    }
+
+#ifdef _WIN32
+    uint64_t fileTimeNs(const FILETIME& ft)
+    {
+      return ((uint64_t(ft.dwHighDateTime) << 32) | ft.dwLowDateTime) * 100;
+    }
+#endif
+  }
+  //----< name of stage as written in the report >-------------------
+
+  const char* stageName(Stage stage)
+  {
+    return stage < stageCount ? stageNames[stage] : "unknown";
+  }
+  //----< start or stop counting, or tracing >-----------------------
+
+  void enable(bool on)
+  {
+    if (on)
+    {
+      Counters::instance().reset();
+      activeModes_.fetch_or(counting, std::memory_order_relaxed);
+    }
+    else
+      activeModes_.fetch_and(~counting, std::memory_order_relaxed);
+  }
+
+  bool enabled()
+  {
+    return (activeModes_.load(std::memory_order_relaxed) & counting) != 0;
+  }
+
+  void setTracing(bool on)
+  {
+    if (on)
+      activeModes_.fetch_or(tracingEvents, std::memory_order_relaxed);
+    else
+      activeModes_.fetch_and(~tracingEvents, std::memory_order_relaxed);
+  }
+
+  bool tracing()
+  {
+    return (activeModes_.load(std::memory_order_relaxed) & tracingEvents) != 0;
+  }
+
+  void trackMemory(bool on)
+  {
+    if (on)
+    {
+      MemStats::instance().reset();
+      activeModes_.fetch_or(memory, std::memory_order_relaxed);
+    }
+    else
+      activeModes_.fetch_and(~memory, std::memory_order_relaxed);
+  }
+
+  bool trackingMemory()
+  {
+    return (activeModes_.load(std::memory_order_relaxed) & memory) != 0;
+  }
+  //----< stage heap blocks allocated now are charged to >-----------
+  /*
+   * Called from operator new in TRACK_ALLOCATIONS builds, so it must
+   * not allocate.  pCurrent_ needs no dynamic initialization.
+   */
+  Stage currentStage()
+  {
+    return pCurrent_ != nullptr ? pCurrent_->stage() : stageCount;
+  }
+  //----< CPU clocks >-----------------------------------------------
+  /*
+   * Windows charges CPU time to a thread at each scheduler tick, so
+   * per-file CPU times there are only good to about 15 ms; totals
+   * over many files are still meaningful.
+   */
+  uint64_t threadCpuNs()
+  {
+#ifdef _WIN32
+    FILETIME created, exited, kernel, user;
+    if (!::GetThreadTimes(::GetCurrentThread(), &created, &exited, &kernel, &user))
+      return 0;
+    return fileTimeNs(kernel) + fileTimeNs(user);
+#else
+    timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0)
+      return 0;
+    return uint64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+#endif
+  }
+
+  uint64_t processCpuNs()
+  {
+#ifdef _WIN32
+    FILETIME created, exited, kernel, user;
+    if (!::GetProcessTimes(::GetCurrentProcess(), &created, &exited, &kernel, &user))
+      return 0;
+    return fileTimeNs(kernel) + fileTimeNs(user);
+#else
+    timespec ts;
+    if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts) != 0)
+      return 0;
+    return uint64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+#endif
+  }
+  //----< largest resident set of the process so far, in bytes >----
+
+  uint64_t peakRssBytes()
+  {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!::GetProcessMemoryInfo(::GetCurrentProcess(), &counters, sizeof(counters)))
+      return 0;
+    return counters.PeakWorkingSetSize;
+#else
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+      return 0;
+#ifdef __APPLE__
+    return uint64_t(usage.ru_maxrss);         // bytes
+#else
+    return uint64_t(usage.ru_maxrss) * 1024;  // kilobytes
+#endif
+#endif
+  }
+  //----< size of file in bytes, zero if it can't be found >---------
+
+  size_t fileSize(const std::string& path)
+  {
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0)
+      return 0;
+    return (size_t)info.st_size;
+  }
+
+  /////////////////////////////////////////////////////////////////////
+  // Counters
+
+  Counters::Counters()
+  {
+    reset();
+  }
+
+  Counters& Counters::instance()
+  {
+    static Counters counters;
+    return counters;
+  }
+  //----< add one measurement to a stage's totals >------------------
+
+  void Counters::record(Stage stage, size_t files, uint64_t bytes,
+    uint64_t wallNs, uint64_t selfNs, uint64_t cpuNs)
+  {
+    if (stage >= stageCount)
+      return;
+    std::lock_guard<std::mutex> lock(mtx_);
+    Totals& totals = stages_[stage];
+    ++totals.calls;
+    totals.files += files;
+    totals.bytes += bytes;
+    totals.wallNs += wallNs;
+    totals.selfNs += selfNs;
+    totals.cpuNs += cpuNs;
+    totals.samplesNs.push_back(wallNs);
+  }
+  //----< files and bytes the whole publish works on >---------------
+
+  void Counters::input(size_t files, uint64_t bytes)
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    inputFiles_ = files;
+    inputBytes_ = bytes;
+  }
+
+  Counters::Totals Counters::totals(Stage stage) const
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return stage < stageCount ? stages_[stage] : Totals();
+  }
+  //----< clear totals and restart the report's clocks >-------------
+
+  void Counters::reset()
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    for (auto& totals : stages_)
+      totals = Totals();
+    inputFiles_ = 0;
+    inputBytes_ = 0;
+    start_ = std::chrono::steady_clock::now();
+    startCpuNs_ = processCpuNs();
+  }
+  //----< nearest-rank percentile, in milliseconds >-----------------
+
+  double Counters::percentileMs(std::vector<uint64_t> samplesNs, double p)
+  {
+    if (samplesNs.size() == 0)
+      return 0.0;
+    size_t rank = (size_t)std::ceil(p * samplesNs.size());
+    size_t index = rank > 0 ? rank - 1 : 0;
+    std::nth_element(samplesNs.begin(), samplesNs.begin() + index, samplesNs.end());
+    return samplesNs[index] / 1e6;
+  }
+  //----< write the report as a JSON object >------------------------
+  /*
+   * wallSeconds and cpuSeconds run from enable(), or the last reset,
+   * to now.  Rates for the whole publish use the input files and
+   * bytes; rates for a stage use what that stage processed.
+   */
+  void Counters::writeJson(std::ostream& out) const
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    uint64_t wallNs = elapsedNs(start_);
+    uint64_t cpuNs = processCpuNs() - startCpuNs_;
+
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << std::fixed << std::setprecision(6);
+
+    out << "{\n";
+    out << "  \"wallSeconds\": " << seconds(wallNs) << ",\n";
+    out << "  \"cpuSeconds\": " << seconds(cpuNs) << ",\n";
+    out << "  \"files\": " << inputFiles_ << ",\n";
+    out << "  \"bytes\": " << inputBytes_ << ",\n";
+    out << "  \"filesPerSecond\": " << perSecond(inputFiles_, wallNs) << ",\n";
+    out << "  \"bytesPerSecond\": " << perSecond(inputBytes_, wallNs) << ",\n";
+    out << "  \"stages\": [";
+    for (size_t i = 0; i < stageCount; ++i)
+    {
+      const Totals& totals = stages_[i];
+      out << (i == 0 ? "\n" : ",\n");
+      out << "    { \"stage\": \"" << stageNames[i] << "\"";
+      out << ", \"calls\": " << totals.calls;
+      out << ", \"files\": " << totals.files;
+      out << ", \"bytes\": " << totals.bytes;
+      out << ", \"wallSeconds\": " << seconds(totals.wallNs);
+      out << ", \"selfSeconds\": " << seconds(totals.selfNs);
+      out << ", \"cpuSeconds\": " << seconds(totals.cpuNs);
+      out << ", \"filesPerSecond\": " << perSecond(totals.files, totals.wallNs);
+      out << ", \"bytesPerSecond\": " << perSecond(totals.bytes, totals.wallNs);
+      out << ", \"p50Ms\": " << percentileMs(totals.samplesNs, 0.50);
+      out << ", \"p99Ms\": " << percentileMs(totals.samplesNs, 0.99);
+      out << " }";
+    }
+    out << "\n  ]\n}\n";
+
+    out.flags(flags);
+    out.precision(precision);
+  }
+
+  /////////////////////////////////////////////////////////////////////
+  // Timer
+
+  Timer::Timer(Stage stage, uint64_t bytes)
+  {
+    start(stage, bytes);
+  }
+
+  Timer::Timer(Stage stage, const std::string& file)
+  {
+    start(stage, file);
+  }
+
+  Timer::~Timer()
+  {
+    stop();
+  }
+  //----< start timing, unless counting and tracing are off >-------
+
+  void Timer::start(Stage stage, uint64_t bytes)
+  {
+    if (running_)
+      cancel();
+    modes_ = activeModes_.load(std::memory_order_relaxed);
+    if (modes_ == 0)
+      return;
+    stage_ = stage;
+    bytes_ = bytes;
+    files_ = 1;
+    childNs_ = 0;
+    pParent_ = pCurrent_;
+    pCurrent_ = this;
+    running_ = true;
+    if (modes_ & memory)
+      MemStats::instance().boundary(stage_, false);
+    cpuStart_ = threadCpuNs();
+    wallStart_ = std::chrono::steady_clock::now();
+  }
+  //----< start timing work on a file, sized only if counting >-----
+
+  void Timer::start(Stage stage, const std::string& file)
+  {
+    start(stage);
+    if (modes_ & counting)
+      bytes_ = fileSize(file);
+    if (modes_ & tracingEvents)
+      file_ = file;
+  }
+  //----< stop timing and record >-----------------------------------
+  /*
+   * Only a timer stopped while it is the innermost one charges its
+   * time to its parent.  One left running by an exception, e.g., a
+   * parse abandoned part way, is unlinked when its parent stops.
+   */
+  void Timer::stop()
+  {
+    if (!running_)
+      return;
+    uint64_t wallNs = elapsedNs(wallStart_);
+    uint64_t cpuNs = threadCpuNs() - cpuStart_;
+    if (pCurrent_ == this && pParent_ != nullptr)
+      pParent_->childNs_ += wallNs;
+    unlink();
+    running_ = false;
+    uint64_t selfNs = wallNs > childNs_ ? wallNs - childNs_ : 0;
+    if (modes_ & counting)
+      Counters::instance().record(stage_, files_, bytes_, wallNs, selfNs, cpuNs);
+    if (modes_ & tracingEvents)
+    {
+      TraceRecorder::instance().record(stageName(stage_), file_, wallStart_, wallNs);
+      file_.clear();
+    }
+    if (modes_ & memory)
+      MemStats::instance().boundary(stage_, true);
+  }
+
+  void Timer::cancel()
+  {
+    if (!running_)
+      return;
+    unlink();
+    running_ = false;
+    file_.clear();
+  }
+  //----< private - remove this and any timers it abandoned >--------
+
+  void Timer::unlink()
+  {
+    for (Timer* pTimer = pCurrent_; pTimer != nullptr; pTimer = pTimer->pParent_)
+    {
+      if (pTimer == this)
+      {
+        pCurrent_ = pParent_;
+        return;
+      }
+    }
+  }
+}
+
+#ifdef TEST_PERFSTATS
+
+#include <thread>
+#include "MemStats.h"
+
+using namespace PerfStats;
+
+std::vector<std::string> kept;   // held, as a parse keeps its tree
+
+//----< busy work standing in for a stage >--------------------------
+
+thread_local volatile double sink;
+
+void work(size_t n)
+{
+  double sum = 0;
+  for (size_t i = 0; i < n; ++i)
+    sum += std::sqrt(double(i));
+  sink = sum;
+}
+//----< convert files, each with a nested parse >--------------------
+
+void publish(const std::string& dir, size_t files)
+{
+  for (size_t i = 0; i < files; ++i)
+  {
+    std::string file = dir + "\\file" + std::to_string(i) + ".cpp";
+    Timer timer(convert, file);   // no such file, so set bytes
+    timer.bytes(1000 * (i + 1));
+    {
+      Timer parseTimer(parse, file);
+      parseTimer.bytes(1000 * (i + 1));
+      kept.push_back(std::string(1000 * (i + 1), 'x'));
+      work(100000 * (i + 1));
+    }
+    work(50000);
+  }
+}
+
+int main()
+{
+  std::cout << "\n  Testing PerfStats";
+  std::cout << "\n =================\n";
+
+  {
+    Timer timer(convert);
+    std::cout << "\n  counting off, timer running: " << std::boolalpha << timer.running();
+  }
+
+  enable();
+  trackMemory();
+  TraceRecorder::instance().start("trace.json");
+  publish("main", 20);
+
+  std::thread other([]() {
+    Timer timer(dependencies, 4096);
+    work(200000);
+  });
+  other.join();
+
+  Counters::instance().input(20, 210000);
+  Counters::Totals totals = Counters::instance().totals(convert);
+  std::cout << "\n  convert files: " << totals.files << ", samples: " << totals.samplesNs.size();
+  std::cout << "\n  convert self time is less than wall time: " << (totals.selfNs < totals.wallNs);
+  std::cout << "\n  trace events: " << TraceRecorder::instance().eventCount();
+  MemStats::StageMemory memory = MemStats::instance().stage(parse);
+  std::cout << "\n  allocations tracked: " << allocationsTracked();
+  std::cout << "\n  parse allocations: " << memory.allocations << ", live bytes: " << memory.liveBytes;
+  std::cout << "\n  memory boundaries: " << MemStats::instance().boundaries().size();
+  std::cout << "\n\n";
+  Counters::instance().writeJson(std::cout);
+  std::cout << "\n  trace.json is written at exit\n";
+  return 0;
+}
+
+#endif
@@ -0,0 +1,165 @@
+#ifndef PERFSTATS_H
+#define PERFSTATS_H
+/////////////////////////////////////////////////////////////////////
+// PerfStats.h - per-stage timers and counters for a publish       //
+// ver 1.3                                                         //
+// Sneha Giranje, CSE687 - Object Oriented Design, Spring 2019     //
+/////////////////////////////////////////////////////////////////////
+/*
+ * Package Operations:
+ * -------------------
+ * Measures where a publish spends its time.  Each stage of the
+ * pipeline - finding files, parsing, building the dependency and
+ * symbol tables, and converting pages - wraps its work for one file
+ * in a scoped Timer.  When the timer stops it adds its wall time,
+ * the CPU time of its thread, and the bytes it processed to the
+ * stage's totals in Counters, and keeps the wall time as one latency
+ * sample, so the report can give p50 and p99 per-file latency.
+ *
+ * Timers nest: parsing a file is timed inside the dependency, symbol
+ * and convert stages that asked for the parse.  A stage's wall time
+ * includes its nested stages, its self time does not.
+ *
+ * Counting is off until enable() is called.  A timer started while
+ * counting, tracing and memory tracking are all off does nothing
+ * beyond one flag test, so the timers can stay in the code of a
+ * normal build.
+ * Counters are shared by all threads, and a timer must be started
+ * and stopped on one thread.  While TraceRecorder, in Trace.h, is
+ * recording, each timer also adds an event to the publish timeline,
+ * and while MemStats, in MemStats.h, is tracking memory, it records
+ * live heap bytes and peak RSS as the timer starts and stops.
+ *
+ * Public Interface:
+ * -----------------
+ * PerfStats::enable();
+ * {
+ *   PerfStats::Timer timer(PerfStats::convert, file);
+ *   ... convert one file ...
+ * }                                     // records when destroyed
+ * PerfStats::Counters::instance().input(files, bytes);
+ * PerfStats::Counters::instance().writeJson(std::cout);
+ *
+ * Required Files:
+ * ---------------
+ * PerfStats.h, PerfStats.cpp, Trace.h, Trace.cpp, MemStats.h, MemStats.cpp
+ *
+ * Maintenance History
+ * -------------------
+ * ver 1.3 : 19 Oct 2026
+ * - timers also mark stage boundaries while tracking memory, and
+ *   added currentStage() for the allocation hooks of MemStats
+ * ver 1.2 : 19 Oct 2026
+ * - added peakRssBytes()
+ * ver 1.1 : 19 Oct 2026
+ * - timers also record trace events while tracing, which is
+ *   independent of counting
+ * ver 1.0 : 19 Oct 2026
+ * - first release
+ */
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+
+namespace PerfStats
+{
+  enum Stage { extract, parse, dependencies, symbols, convert, highlight, stageCount };
+
+  const char* stageName(Stage stage);
+
+  void enable(bool on = true);  // turning on also clears the counters
+  bool enabled();
+  void setTracing(bool on);     // used by TraceRecorder
+  bool tracing();
+  Stage currentStage();         // of the innermost running timer, else stageCount
+
+  uint64_t threadCpuNs();       // CPU time of the calling thread
+  uint64_t processCpuNs();      // CPU time of all threads of the process
+  uint64_t peakRssBytes();      // peak resident set size of the process
+  size_t fileSize(const std::string& path);
+
+  ///////////////////////////////////////////////////////////////////
+  // Counters class
+  // - totals and latency samples for every stage, shared by threads
+
+  class Counters
+  {
+  public:
+    struct Totals
+    {
+      size_t calls = 0;
+      size_t files = 0;
+      uint64_t bytes = 0;
+      uint64_t wallNs = 0;
+      uint64_t selfNs = 0;
+      uint64_t cpuNs = 0;
+      std::vector<uint64_t> samplesNs;
+    };
+
+    static Counters& instance();
+
+    void record(Stage stage, size_t files, uint64_t bytes,
+      uint64_t wallNs, uint64_t selfNs, uint64_t cpuNs);
+    void input(size_t files, uint64_t bytes);  // size of the whole publish
+    Totals totals(Stage stage) const;
+    void reset();
+    void writeJson(std::ostream& out) const;
+
+  private:
+    Counters();
+    static double percentileMs(std::vector<uint64_t> samplesNs, double p);
+
+    mutable std::mutex mtx_;
+    Totals stages_[stageCount];
+    size_t inputFiles_ = 0;
+    uint64_t inputBytes_ = 0;
+    std::chrono::steady_clock::time_point start_;
+    uint64_t startCpuNs_ = 0;
+  };
+
+  ///////////////////////////////////////////////////////////////////
+  // Timer class
+  // - times one file, or one call, of a stage
+  // - start() while running discards the running measurement
+
+  class Timer
+  {
+  public:
+    Timer() {}
+    Timer(Stage stage, uint64_t bytes = 0);
+    Timer(Stage stage, const std::string& file);  // bytes are file's size
+    ~Timer();
+
+    void start(Stage stage, uint64_t bytes = 0);
+    void start(Stage stage, const std::string& file);
+    void stop();              // records, if started while enabled
+    void cancel();            // stops without recording
+    bool running() const { return running_; }
+    Stage stage() const { return stage_; }
+
+    void bytes(uint64_t n) { bytes_ = n; }
+    void files(size_t n) { files_ = n; }
+
+  private:
+    void unlink();
+
+    bool running_ = false;
+    unsigned modes_ = 0;      // counting, tracing and memory, when started
+    Stage stage_ = stageCount;
+    size_t files_ = 1;
+    uint64_t bytes_ = 0;
+    uint64_t childNs_ = 0;
+    uint64_t cpuStart_ = 0;
+    std::chrono::steady_clock::time_point wallStart_;
+    Timer* pParent_ = nullptr;
+    std::string file_;        // kept only while tracing
+
+    Timer(const Timer&) = delete;
+    Timer& operator=(const Timer&) = delete;
+  };
+}
+#endif
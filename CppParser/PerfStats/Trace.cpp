@@ -0,0 +1,248 @@
+/////////////////////////////////////////////////////////////////////
+// Trace.cpp - timeline of PerfStats timers in Chrome trace format //
+// ver 1.0                                                         //
+// Sneha Giranje, CSE687 - Object Oriented Design, Spring 2019     //
+/////////////////////////////////////////////////////////////////////
+
+#include "Trace.h"
+#include "PerfStats.h"
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+namespace PerfStats
+{
+  namespace
+  {
+    // buffer of this thread, registered with its first event
+    thread_local TraceBuffer* pThreadBuffer_ = nullptr;
+
+    //----< write string as JSON string, with quotes >---------------
+
+    void writeJsonString(std::ostream& out, const std::string& str)
+    {
+      out << '"';
+      for (char ch : str)
+      {
+        switch (ch)
+        {
+        case '"':  out << "\\\""; break;
+        case '\\': out << "\\\\"; break;
+        case '\n': out << "\\n"; break;
+        case '\r': out << "\\r"; break;
+        case '\t': out << "\\t"; break;
+        default:
+          if ((unsigned char)ch < 0x20)
+            out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << int(ch)
+                << std::dec << std::setfill(' ');
+          else
+            out << ch;
+        }
+      }
+      out << '"';
+    }
+    //----< name part of path, for the event's label >---------------
+
+    std::string fileName(const std::string& path)
+    {
+      size_t pos = path.find_last_of("/\\");
+      return pos == std::string::npos ? path : path.substr(pos + 1);
+    }
+  }
+
+  /////////////////////////////////////////////////////////////////////
+  // TraceBuffer
+
+  TraceBuffer::TraceBuffer(size_t threadId)
+    : threadId_(threadId), pFirst_(new Block), pLast_(pFirst_) {}
+
+  TraceBuffer::~TraceBuffer()
+  {
+    Block* pBlock = pFirst_;
+    while (pBlock != nullptr)
+    {
+      Block* pNext = pBlock->pNext.load(std::memory_order_relaxed);
+      delete pBlock;
+      pBlock = pNext;
+    }
+  }
+  //----< append event - called only by the owning thread >----------
+  /*
+   * The event is complete before the count that covers it is
+   * released, so a reader never sees a partly written event.
+   */
+  void TraceBuffer::add(TraceEvent&& event)
+  {
+    size_t count = pLast_->count.load(std::memory_order_relaxed);
+    if (count == blockSize)
+    {
+      Block* pBlock = new Block;
+      pLast_->pNext.store(pBlock, std::memory_order_release);
+      pLast_ = pBlock;
+      count = 0;
+    }
+    pLast_->events[count] = std::move(event);
+    pLast_->count.store(count + 1, std::memory_order_release);
+  }
+  //----< copy of the events added so far, from any thread >---------
+
+  std::vector<TraceEvent> TraceBuffer::events() const
+  {
+    std::vector<TraceEvent> events;
+    for (const Block* pBlock = pFirst_; pBlock != nullptr;
+      pBlock = pBlock->pNext.load(std::memory_order_acquire))
+    {
+      size_t count = pBlock->count.load(std::memory_order_acquire);
+      events.insert(events.end(), pBlock->events, pBlock->events + count);
+    }
+    return events;
+  }
+
+  /////////////////////////////////////////////////////////////////////
+  // TraceRecorder
+
+  TraceRecorder::TraceRecorder() : start_(std::chrono::steady_clock::now()) {}
+
+  TraceRecorder& TraceRecorder::instance()
+  {
+    static TraceRecorder recorder;
+    return recorder;
+  }
+  //----< start recording timers, to be written to path at exit >----
+
+  void TraceRecorder::start(const std::string& path)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      path_ = path;
+      start_ = std::chrono::steady_clock::now();
+      if (!atExitRegistered_)
+      {
+        std::atexit(writeAtExit);
+        atExitRegistered_ = true;
+      }
+    }
+    setTracing(true);
+  }
+  //----< stop recording, keeping events for write() >---------------
+
+  void TraceRecorder::stop()
+  {
+    setTracing(false);
+  }
+
+  void TraceRecorder::path(const std::string& path)
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    path_ = path;
+  }
+
+  std::string TraceRecorder::path() const
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return path_;
+  }
+  //----< add one timer's event to the calling thread's buffer >-----
+
+  void TraceRecorder::record(const char* name, const std::string& file,
+    std::chrono::steady_clock::time_point start, uint64_t durationNs)
+  {
+    TraceEvent event;
+    event.name = name;
+    event.file = file;
+    event.startNs = start > start_ ? (uint64_t)std::chrono::duration_cast<
+      std::chrono::nanoseconds>(start - start_).count() : 0;
+    event.durationNs = durationNs;
+    threadBuffer().add(std::move(event));
+  }
+  //----< private - buffer of calling thread, registered once >------
+
+  TraceBuffer& TraceRecorder::threadBuffer()
+  {
+    if (pThreadBuffer_ == nullptr)
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      buffers_.push_back(std::unique_ptr<TraceBuffer>(new TraceBuffer(buffers_.size() + 1)));
+      pThreadBuffer_ = buffers_.back().get();
+    }
+    return *pThreadBuffer_;
+  }
+
+  size_t TraceRecorder::eventCount() const
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    size_t count = 0;
+    for (auto& pBuffer : buffers_)
+      count += pBuffer->events().size();
+    return count;
+  }
+  //----< write trace file, false if it can't be opened >------------
+
+  bool TraceRecorder::write(const std::string& path) const
+  {
+    if (path.size() == 0)
+      return false;
+    std::ofstream out(path);
+    if (!out.good())
+      return false;
+    writeJson(out);
+    return out.good();
+  }
+  //----< write events in Chrome trace JSON format >-----------------
+  /*
+   * Times are in microseconds, with fractions, as the format expects.
+   * Each thread gets a metadata event naming its track.
+   */
+  void TraceRecorder::writeJson(std::ostream& out) const
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << std::fixed << std::setprecision(3);
+
+    out << "{\n  \"displayTimeUnit\": \"ms\",\n  \"traceEvents\": [";
+    bool first = true;
+    for (auto& pBuffer : buffers_)
+    {
+      size_t tid = pBuffer->threadId();
+      out << (first ? "\n" : ",\n");
+      first = false;
+      out << "    { \"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << tid
+          << ", \"args\": { \"name\": \"thread " << tid << "\" } }";
+
+      for (const TraceEvent& event : pBuffer->events())
+      {
+        std::string label = event.name;
+        if (event.file.size() > 0)
+          label += " " + fileName(event.file);
+        out << ",\n    { \"name\": ";
+        writeJsonString(out, label);
+        out << ", \"cat\": \"" << event.name << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << tid;
+        out << ", \"ts\": " << event.startNs / 1e3 << ", \"dur\": " << event.durationNs / 1e3;
+        out << ", \"args\": { \"file\": ";
+        writeJsonString(out, event.file);
+        out << " } }";
+      }
+    }
+    out << "\n  ]\n}\n";
+
+    out.flags(flags);
+    out.precision(precision);
+  }
+  //----< private - flush registered with atexit by start() >--------
+
+  void TraceRecorder::writeAtExit()
+  {
+    TraceRecorder& recorder = instance();
+    std::string path = recorder.path();
+    if (!tracing() || path.size() == 0)
+      return;
+    if (recorder.write(path))
+      std::cout << "\n  Trace written to: " << path << "\n";
+    else
+      std::cout << "\n  Error -- unable to write trace to " << path << "\n";
+  }
+}
+
@@ -0,0 +1,129 @@
+#ifndef TRACE_H
+#define TRACE_H
+/////////////////////////////////////////////////////////////////////
+// Trace.h - timeline of PerfStats timers in Chrome trace format   //
+// ver 1.0                                                         //
+// Sneha Giranje, CSE687 - Object Oriented Design, Spring 2019     //
+/////////////////////////////////////////////////////////////////////
+/*
+ * Package Operations:
+ * -------------------
+ * Counters give totals, which hide stalls, e.g., one huge header
+ * holding back the tail of a run.  While tracing, every PerfStats
+ * Timer that stops also adds an event - its stage, the file it
+ * worked on, when it started and how long it ran - to a buffer owned
+ * by the thread that ran it.  At exit, or when write() is called,
+ * the events of all threads are written as a Chrome trace JSON file,
+ * which chrome://tracing and the Perfetto UI show as a timeline with
+ * one track per thread.
+ *
+ * A thread appends to its own buffer without locking.  The buffer is
+ * a list of fixed size blocks, each publishing its event count with a
+ * release store, so write() can read events while threads still add
+ * more.  Only a thread's first event takes a lock, to register its
+ * buffer, and buffers are kept after their threads end.
+ *
+ * Each timer is written as one complete ("ph": "X") event, holding
+ * both its begin and end times, so a parse abandoned by an exception
+ * leaves no unmatched begin in the trace.
+ *
+ * Public Interface:
+ * -----------------
+ * PerfStats::TraceRecorder& trace = PerfStats::TraceRecorder::instance();
+ * trace.start("trace.json");         // record timers, write at exit
+ * trace.path("../out/trace.json");   // change where it is written
+ * trace.write(trace.path());         // or write it now
+ *
+ * Required Files:
+ * ---------------
+ * Trace.h, Trace.cpp, PerfStats.h, PerfStats.cpp
+ *
+ * Maintenance History
+ * -------------------
+ * ver 1.0 : 19 Oct 2026
+ * - first release
+ */
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+
+namespace PerfStats
+{
+  struct TraceEvent
+  {
+    const char* name = nullptr;  // stage name, a string literal
+    std::string file;
+    uint64_t startNs = 0;        // since the trace started
+    uint64_t durationNs = 0;
+  };
+
+  ///////////////////////////////////////////////////////////////////
+  // TraceBuffer class
+  // - events of one thread, appended only by that thread
+
+  class TraceBuffer
+  {
+  public:
+    static const size_t blockSize = 1024;
+
+    TraceBuffer(size_t threadId);
+    ~TraceBuffer();
+    void add(TraceEvent&& event);
+    std::vector<TraceEvent> events() const;
+    size_t threadId() const { return threadId_; }
+
+  private:
+    struct Block
+    {
+      TraceEvent events[blockSize];
+      std::atomic<size_t> count{ 0 };
+      std::atomic<Block*> pNext{ nullptr };
+    };
+
+    size_t threadId_;
+    Block* pFirst_;
+    Block* pLast_;
+
+    TraceBuffer(const TraceBuffer&) = delete;
+    TraceBuffer& operator=(const TraceBuffer&) = delete;
+  };
+
+  ///////////////////////////////////////////////////////////////////
+  // TraceRecorder class
+  // - owns the buffers of all threads and writes the trace
+
+  class TraceRecorder
+  {
+  public:
+    static TraceRecorder& instance();
+
+    void start(const std::string& path);
+    void stop();
+    void path(const std::string& path);
+    std::string path() const;
+
+    void record(const char* name, const std::string& file,
+      std::chrono::steady_clock::time_point start, uint64_t durationNs);
+    size_t eventCount() const;
+    bool write(const std::string& path) const;
+    void writeJson(std::ostream& out) const;
+
+  private:
+    TraceRecorder();
+    TraceBuffer& threadBuffer();
+    static void writeAtExit();
+
+    mutable std::mutex mtx_;
+    std::vector<std::unique_ptr<TraceBuffer>> buffers_;
+    std::string path_;
+    std::chrono::steady_clock::time_point start_;
+    bool atExitRegistered_ = false;
+  };
+}
+#endif
@@ -1,6 +1,6 @@
 ///////////////////////////////////////////////////////////////////////////////
 // ScopeStack.cpp - implements template stack holding specified element type //
-// ver 2.2                                                                   //
+// ver 3.2                                                                   //
 // Language:      Visual C++ 2010, SP1                                       //
 // Platform:      Dell Precision T7400, Win 7 Pro SP1                        //
 // Application:   Code Analysis Research                                     //
@@ -17,9 +17,27 @@
 #include <vector>
 #include <iostream>
 #include <sstream>
+#include <list>
+#include <chrono>
+#include <cstdlib>
+#include <new>
 
 using namespace CodeAnalysis;
 
+//----< count allocations made by the benchmark >-----------------------
+
+static size_t allocCount = 0;
+
+void* operator new(size_t size)
+{
+	++allocCount;
+	if (void* p = std::malloc(size ? size : 1))
+		return p;
+	throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
 struct element
 {
 	std::string type;
@@ -44,12 +62,56 @@ struct element
 	std::vector<element*> children_;
 };
 
+//----< ScopeStack as it was before ver 3.2, for comparison >-----------
+
+struct ListScopeStack
+{
+	void push(element* item) { stack.push_back(item); LoggedScopeTrace::pushed(stack.size()); }
+	element* pop() { element* item = stack.back(); stack.pop_back(); LoggedScopeTrace::popped(stack.size()); return item; }
+	std::list<element*> stack;
+};
+
+//----< push and pop scopes nested as a parser would see them >---------
+/*
+*  Each round opens a namespace, a class, and depth functions, each
+*  holding a control scope, then closes them all.
+*/
+template<typename Stack>
+void benchStack(const std::string& name, size_t rounds, size_t depth)
+{
+	Stack stack;
+	element item;
+	size_t scopes = 0;
+	size_t allocsBefore = allocCount;
+	auto start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < rounds; ++i)
+	{
+		stack.push(&item);
+		stack.push(&item);
+		for (size_t j = 0; j < depth; ++j)
+		{
+			stack.push(&item);
+			stack.push(&item);
+			stack.pop();
+			stack.pop();
+		}
+		stack.pop();
+		stack.pop();
+		scopes += 2 + 2 * depth;
+	}
+	std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+	size_t allocs = allocCount - allocsBefore;
+	std::cout << "\n  " << name << ": "
+		<< double(allocs) / scopes << " allocations and "
+		<< elapsed.count() / scopes << " ns per scope";
+}
+
 int main()
 {
 	ScopeStack<element*>::Rslt::attach(&std::cout);
 	ScopeStack<element*>::Rslt::start();
 
-	using Utils = Utilities::StringHelper;
+	using Utils = Utilities1::StringHelper;
 
 	Utils::Title("Testing Scope Stack");
 
@@ -119,6 +181,12 @@ int main()
 	Utils::title("walking simulated AST tree:");
 	TreeWalk(pTop);
 	std::cout << "\n\n";
+
+	Utils::title("cost of one scope push and pop");
+	benchStack<ListScopeStack>("list, logged (ver 3.1)", 100000, 8);
+	benchStack<ScopeStack<element*, LoggedScopeTrace>>("vector, logged       ", 100000, 8);
+	benchStack<ScopeStack<element*>>("vector, untraced     ", 100000, 8);
+	std::cout << "\n\n";
 }
 
 #endif
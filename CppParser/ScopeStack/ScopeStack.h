@@ -2,7 +2,7 @@
 #define SCOPESTACK_H
 /////////////////////////////////////////////////////////////////////////////
 // ScopeStack.h - implements template stack holding specified element type //
-// ver 2.2                                                                 //
+// ver 3.2                                                                 //
 // Language:      Visual C++ 2010, SP1                                     //
 // Platform:      Dell Precision T7400, Win 7 Pro SP1                      //
 // Application:   Code Analysis Research                                   //
@@ -18,13 +18,25 @@
 
   Throws std::exception if stack is popped or peeked when empty.
 
+  Elements are held in a std::vector, so pushes and pops don't allocate
+  once the stack has reached its deepest nesting.  Stack size tracing is
+  a policy chosen at compile time.  The default, NoScopeTrace, compiles
+  to nothing.  Define TRACE_SCOPESTACK to make LoggedScopeTrace, which
+  writes each new stack size to the debug logger, the default, or name a
+  policy as the second template argument.
+
   Public Interface:
   =================
   ScopeStack<element> stack;
+  ScopeStack<element, LoggedScopeTrace> tracedStack;
   // define some element type
   element elem;
   stack.push(elem);
   element popped = stack.pop();
+  // collect scopes of an element tree in one walk
+  Scopes scopes;
+  ScopeCollector collect(scopes, classScope | functionScope);
+  ScopeWalk(pGlobalScope, collect);
 
   Required Files:
   ===============
@@ -36,6 +48,14 @@
 
   Maintenance History:
   ====================
+  ver 3.2 : Oct 19 2026
+  - ScopeStack holds its elements in a std::vector instead of a std::list
+  - stack size logging moved into a compile time trace policy, so
+    untraced pushes and pops no longer flush the loggers or format sizes
+  ver 3.1 : Oct 19 2026
+  - replaced TreeWalkToGetLineCountOfClass and TreeWalkToGetLineCountOfFunction
+    with ScopeWalk, a visitor walk, and ScopeCollector, which records every
+    selected scope kind into one flat vector of ScopeLines in a single pass
   ver 3.0 : Mar 5 2019
   - Added functionality to do TreeWalk that returns start and end of functions and classes
   ver 2.2 : 29 Oct 2016
@@ -49,7 +69,8 @@
   ver 1.0 : 31 Jan 2011
   - first release
 */
-#include <list>
+#include <vector>
+#include <string>
 #include "../Logger/Logger.h"
 #include "../Utilities/Utilities.h"
 
@@ -59,52 +80,89 @@
 
 namespace CodeAnalysis
 {
-	template<typename element>
+	//----< trace policies for ScopeStack >-----------------------------
+	/*
+	*  A policy is notified of the stack size after each push and pop.
+	*  NoScopeTrace does nothing, so the calls are optimized away.
+	*/
+	struct NoScopeTrace
+	{
+		static void pushed(size_t) {}
+		static void popped(size_t) {}
+	};
+
+	struct LoggedScopeTrace
+	{
+		using Demo = Logging::StaticLogger<1>;
+		using Dbug = Logging::StaticLogger<2>;
+
+		static void pushed(size_t size)
+		{
+			Demo::flush();
+			popped(size);
+		}
+		static void popped(size_t size)
+		{
+			Dbug::write("\n--- stack size = " + Utilities1::Converter<size_t>::toString(size) + " ---");
+			Dbug::flush();
+		}
+	};
+
+#ifdef TRACE_SCOPESTACK
+	using DefaultScopeTrace = LoggedScopeTrace;
+#else
+	using DefaultScopeTrace = NoScopeTrace;
+#endif
+
+	template<typename element, typename Trace = DefaultScopeTrace>
 	class ScopeStack {
 	public:
 
 		using Rslt = Logging::StaticLogger<0>;    // show program results
 		using Demo = Logging::StaticLogger<1>;    // show demonstration outputs
 		using Dbug = Logging::StaticLogger<2>;    // show debugging outputs
-		typename typedef std::list<element>::iterator iterator;
+		using iterator = typename std::vector<element>::iterator;
 		ScopeStack();
 		void push(const element& item);
 		element pop();
 		element& top();
 		element& predOfTop();
 		size_t size();
+		void clear();
 		iterator begin();
 		iterator end();
 
 	private:
-		std::list<element> stack;
-		element dbElement;
+		std::vector<element> stack;
 	};
 
-	template<typename element>
-	ScopeStack<element>::ScopeStack() {}
+	template<typename element, typename Trace>
+	ScopeStack<element, Trace>::ScopeStack() {}
 
-	template<typename element>
-	typename inline size_t ScopeStack<element>::size() { return stack.size(); }
+	template<typename element, typename Trace>
+	inline size_t ScopeStack<element, Trace>::size() { return stack.size(); }
 
-	template<typename element>
-	typename inline ScopeStack<element>::iterator ScopeStack<element>::begin() { return stack.begin(); }
+	//----< empty the stack, keeping its storage for reuse >-------------
 
-	template<typename element>
-	typename inline ScopeStack<element>::iterator ScopeStack<element>::end() { return stack.end(); }
+	template<typename element, typename Trace>
+	inline void ScopeStack<element, Trace>::clear() { stack.clear(); }
 
+	template<typename element, typename Trace>
+	inline typename ScopeStack<element, Trace>::iterator ScopeStack<element, Trace>::begin() { return stack.begin(); }
 
-	template<typename element>
-	void ScopeStack<element>::push(const element& item)
+	template<typename element, typename Trace>
+	inline typename ScopeStack<element, Trace>::iterator ScopeStack<element, Trace>::end() { return stack.end(); }
+
+
+	template<typename element, typename Trace>
+	void ScopeStack<element, Trace>::push(const element& item)
 	{
-		Demo::flush();
 		stack.push_back(item);
-		Dbug::write("\n--- stack size = " + Utilities1::Converter<size_t>::toString(size()) + " ---");
-		Dbug::flush();
+		Trace::pushed(stack.size());
 	}
 
-	template<typename element>
-	element ScopeStack<element>::pop()
+	template<typename element, typename Trace>
+	element ScopeStack<element, Trace>::pop()
 	{
 		if (stack.size() == 0)
 		{
@@ -112,14 +170,13 @@ namespace CodeAnalysis
 		}
 		element item = stack.back();
 		stack.pop_back();
-		Dbug::write("\n--- stack size = " + Utilities1::Converter<size_t>::toString(size()) + " ---");
-		Dbug::flush();
+		Trace::popped(stack.size());
 
 		return item;
 	}
 
-	template<typename element>
-	element& ScopeStack<element>::top()
+	template<typename element, typename Trace>
+	element& ScopeStack<element, Trace>::top()
 	{
 		if (stack.size() == 0)
 		{
@@ -128,26 +185,25 @@ namespace CodeAnalysis
 		return stack.back();
 	}
 
-	template<typename element>
-	element& ScopeStack<element>::predOfTop()
+	template<typename element, typename Trace>
+	element& ScopeStack<element, Trace>::predOfTop()
 	{
-		if (size() < 2)
+		if (stack.size() < 2)
 		{
 			throw std::exception("-- predOfTop() called on stack with less than two elements --");
 		}
-		iterator iter = --(--end());
-		return *iter;
+		return stack[stack.size() - 2];
 	}
 
-	template<typename element>
-	void showStack(ScopeStack<element>& stack, bool indent = true)
+	template<typename element, typename Trace>
+	void showStack(ScopeStack<element, Trace>& stack, bool indent = true)
 	{
 		if (stack.size() == 0)
 		{
 			std::cout << "\n  ScopeStack is empty";
 			return;
 		}
-		typename ScopeStack<element>::iterator iter = stack.begin();
+		typename ScopeStack<element, Trace>::iterator iter = stack.begin();
 		while (iter != stack.end())
 		{
 			std::string strIndent = std::string(2 * stack.size(), ' ');
@@ -159,15 +215,15 @@ namespace CodeAnalysis
 		}
 	}
 
-	template<typename element>
-	void showStack(ScopeStack<element*>& stack, bool indent = true)
+	template<typename element, typename Trace>
+	void showStack(ScopeStack<element*, Trace>& stack, bool indent = true)
 	{
 		if (stack.size() == 0)
 		{
 			std::cout << "\n  ScopeStack is empty";
 			return;
 		}
-		typename ScopeStack<element*>::iterator iter = stack.begin();
+		typename ScopeStack<element*, Trace>::iterator iter = stack.begin();
 		while (iter != stack.end())
 		{
 			std::string strIndent = std::string(2 * stack.size(), ' ');
@@ -197,38 +253,83 @@ namespace CodeAnalysis
 		--indentLevel;
 	}
 
-	//----< Walk tree of element nodes to get Line counts for class > ---- 
-	template<typename element>
-	std::vector<std::vector<int>> TreeWalkToGetLineCountOfClass(element* pItem, std::vector<std::vector<int>>& vec, bool details = false)
+	//----< kinds of scope recorded by ScopeCollector >------------------
+	/*
+	*  values are bit flags, so a collector can be configured with any
+	*  combination of kinds, e.g., classScope | functionScope
+	*/
+	enum ScopeKind : unsigned
 	{
-		auto iter = pItem->children_.begin();
-		while (iter != pItem->children_.end())
-		{
-			TreeWalkToGetLineCountOfClass(*iter, vec);
-			++iter;
-		}
-		std::vector<int> v = pItem->ASTNode::getClassScope();
-		if (v[0] != 0 || v[1] != 0)
-			vec.push_back(v);
-		return vec;
+		classScope = 1, structScope = 2, functionScope = 4,
+		namespaceScope = 8, controlScope = 16,
+		allScopes = classScope | structScope | functionScope | namespaceScope | controlScope
+	};
+
+	//----< start and end lines of one scope >---------------------------
+
+	struct ScopeLines
+	{
+		ScopeKind kind;
+		size_t begin;
+		size_t end;
+	};
+
+	using Scopes = std::vector<ScopeLines>;
+
+	//----< map element type name to scope kind >------------------------
+
+	inline bool toScopeKind(const std::string& type, ScopeKind& kind)
+	{
+		if (type == "function")
+			kind = functionScope;
+		else if (type == "control")
+			kind = controlScope;
+		else if (type == "class")
+			kind = classScope;
+		else if (type == "struct")
+			kind = structScope;
+		else if (type == "namespace")
+			kind = namespaceScope;
+		else
+			return false;
+		return true;
 	}
 
-	//----< Walk tree of element nodes to get Line counts for class > ---- 
-	template<typename element>
-	std::vector<std::vector<int>> TreeWalkToGetLineCountOfFunction(element* pItem, std::vector<std::vector<int>>& vec, bool details = false)
+	//----< visitor recording scopes of the selected kinds >-------------
+	/*
+	*  Appends to a caller supplied vector, so a walk allocates only when
+	*  that vector grows.  The parser records the end of a class or struct
+	*  one line past its closing brace, so that is corrected here.
+	*/
+	class ScopeCollector
 	{
-		auto iter = pItem->children_.begin();
+	public:
+		ScopeCollector(Scopes& scopes, unsigned kinds = allScopes) : scopes_(scopes), kinds_(kinds) {}
 
-		//std::pair<int, int> v = pItem->ASTNode::getFunctionScope();
-		while (iter != pItem->children_.end())
+		template<typename element>
+		void operator()(element* pItem)
 		{
-			TreeWalkToGetLineCountOfFunction(*iter, vec);
-			++iter;
+			ScopeKind kind;
+			if (!toScopeKind(pItem->type_, kind) || (kinds_ & kind) == 0)
+				return;
+			size_t end = pItem->endLineCount_;
+			if (kind == classScope || kind == structScope)
+				--end;
+			scopes_.push_back({ kind, pItem->startLineCount_, end });
 		}
-		std::vector<int> v = pItem->ASTNode::getFunctionScope();
-		if (v[0] != 0 || v[1] != 0)
-			vec.push_back(v);
-		return vec;
+	private:
+		Scopes& scopes_;
+		unsigned kinds_;
+	};
+
+	//----< walk tree of element nodes, visiting children before parent >
+
+	template<typename element, typename Visitor>
+	void ScopeWalk(element* pItem, Visitor& visit)
+	{
+		for (element* pChild : pItem->children_)
+			ScopeWalk(pChild, visit);
+		visit(pItem);
 	}
 
 }
@@ -2,7 +2,7 @@
 #define ITOKENCOLLECTION_H
 /////////////////////////////////////////////////////////////////////
 // ITokenCollection.h - Lexical Scanner interface                  //
-// ver 1.0   grammatical analysis                                  //
+// ver 1.3   grammatical analysis                                  //
 //                                                                 //
 // Jim Fawcett, CSE687 - Object Oriented Design, Spring 2019       //
 /////////////////////////////////////////////////////////////////////
@@ -17,9 +17,99 @@ namespace Lexer
 
   class Toker;
 
+  ///////////////////////////////////////////////////////////////////
+  // TokenIndex
+  // - first and last positions of the structural tokens and keywords
+  //   the rules search for, built in one pass over a collection so
+  //   that the rules' finds don't each rescan it
+  // - stats() counts, per thread, the finds answered from an index
+  //   and the scans still made, for the parser benchmark
+
+  class TokenIndex
+  {
+  public:
+    enum Key {
+      OpenParen, CloseParen, OpenBrace, CloseBrace, OpenBracket, CloseBracket,
+      Less, Greater, Equal, Comma, Colon, Hash,
+      Class, Struct, Interface, Namespace, Operator, Public, Protected, Private,
+      NumKeys
+    };
+    static const size_t npos = size_t(-1);
+
+    struct Stats
+    {
+      size_t builds = 0;   // collections indexed
+      size_t lookups = 0;  // finds answered from an index
+      size_t scans = 0;    // finds that walked the tokens
+    };
+
+    //----< key of an indexed token, or -1 >-----------------------
+
+    static int keyOf(const std::string& tok)
+    {
+      if (tok.size() == 1)
+      {
+        switch (tok[0])
+        {
+        case '(': return OpenParen;
+        case ')': return CloseParen;
+        case '{': return OpenBrace;
+        case '}': return CloseBrace;
+        case '[': return OpenBracket;
+        case ']': return CloseBracket;
+        case '<': return Less;
+        case '>': return Greater;
+        case '=': return Equal;
+        case ',': return Comma;
+        case ':': return Colon;
+        case '#': return Hash;
+        default: return -1;
+        }
+      }
+      static const std::string words[] = {
+        "class", "struct", "interface", "namespace", "operator", "public", "protected", "private"
+      };
+      for (int i = 0; i < NumKeys - Class; ++i)
+      {
+        if (tok == words[i])
+          return Class + i;
+      }
+      return -1;
+    }
+    //----< record first and last position of each key in toks >---
+
+    void build(const std::vector<std::string>& toks)
+    {
+      for (int k = 0; k < NumKeys; ++k)
+        first_[k] = last_[k] = npos;
+      for (size_t i = 0; i < toks.size(); ++i)
+      {
+        int key = keyOf(toks[i]);
+        if (key < 0)
+          continue;
+        if (first_[key] == npos)
+          first_[key] = i;
+        last_[key] = i;
+      }
+      ++stats().builds;
+    }
+    size_t first(int key) const { return first_[key]; }
+    size_t last(int key) const { return last_[key]; }
+
+    static Stats& stats()
+    {
+      static thread_local Stats stats_;
+      return stats_;
+    }
+  private:
+    size_t first_[NumKeys];
+    size_t last_[NumKeys];
+  };
+
   struct ITokenCollection
   {
     using iterator = std::vector<std::string>::iterator;
+    virtual ~ITokenCollection() {}                        // ASTNode deletes decls through this interface
     virtual Toker* getToker() = 0;
     virtual void setToker(Toker* pToker) = 0;
     virtual bool open(const std::string& src) = 0;        // attach toker to source
@@ -44,13 +134,14 @@ namespace Lexer
     virtual Token last() const = 0;                       // return last token in semi
     virtual void trim() = 0;                              // remove leading whitespace
     virtual Token predecessor(Token tok) = 0;             // find token before tok
-    virtual bool hasSequence(TokColl tokSeq) = 0;         // does semi have this sequence of tokens?
+    virtual bool hasSequence(const TokColl& tokSeq) = 0;  // does semi have this sequence of tokens?
     virtual bool hasTerminator() = 0;                     // does semi have a valid terminator
     virtual bool isDone() = 0;                            // at end of tokenSource?
     virtual size_t lineCount() = 0;                       // get number of lines processed
     virtual std::string ToString() = 0;                   // concatenate tokens with intervening spaces
     virtual std::string show() const = 0;                 // display semi in string
     virtual bool isComment(Token tok) = 0;                // is this token a comment?
+    virtual const TokenIndex& tokenIndex() const = 0;     // positions of structural tokens, built on first use
   };
 }
 #endif
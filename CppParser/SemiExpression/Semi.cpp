@@ -1,12 +1,13 @@
 /////////////////////////////////////////////////////////////////////
 // Semi.cpp - Collects groups of tokens that are useful for        //
-// ver 1.1    grammatical analysis                                 //
+// ver 1.3    grammatical analysis                                 //
 //                                                                 //
 // Jim Fawcett, CSE687 - Object Oriented Design, Spring 2019       //
 /////////////////////////////////////////////////////////////////////
 
 #include "Semi.h"
 #include <sstream>
+#include <iterator>
 
 namespace Lexer
 {
@@ -21,8 +22,7 @@ namespace Lexer
     if (createToker)
       pToker_ = new Toker;
 
-    for (Token tok : list)
-      toks.push_back(tok);
+    toks = std::move(list);
   }
 
   Semi::~Semi()
@@ -45,8 +45,8 @@ namespace Lexer
 
   void Semi::addRange(TokColl coll)
   {
-    for (Token tok : coll)
-      toks.push_back(tok);
+    isIndexed_ = false;
+    toks.insert(toks.end(), std::make_move_iterator(coll.begin()), std::make_move_iterator(coll.end()));
   }
 
   bool Semi::open(const std::string& source)
@@ -68,10 +68,15 @@ namespace Lexer
 
   std::string Semi::ToString()
   {
+    size_t length = 0;
+    for (const Token& tok : toks)
+      length += tok.size() + 1;
     std::string temp;
-    for (Token tok : toks)
+    temp.reserve(length);
+    for (const Token& tok : toks)
     {
-      temp += tok += " ";
+      temp += tok;
+      temp += " ";
     }
     return temp;
   }
@@ -85,7 +90,7 @@ namespace Lexer
 
   bool Semi::isTerminator(Token tok)
   {
-    if (tok == ";" || tok == "{" || tok == "}")
+    if (isEndOfStatement(tok))
       return true;
     if (tok == "\n")
     {
@@ -95,8 +100,17 @@ namespace Lexer
     }
     return false;
   }
-  //----< remove leading newlines >--------------------------------
+  //----< is tok one of the tokens that always end a semi? >------
 
+  bool Semi::isEndOfStatement(const Token& tok)
+  {
+    return tok.size() == 1 && (tok[0] == ';' || tok[0] == '{' || tok[0] == '}');
+  }
+  //----< remove leading newlines >--------------------------------
+  /*
+   * Shifts the remaining tokens down in place, so no storage is
+   * allocated and the common case, no leading newline, costs one test.
+   */
   void Semi::trim()
   {
     size_t count = 0;
@@ -108,24 +122,52 @@ namespace Lexer
     if (count == 0)
       return;
 
-    TokColl temp;
-    for (size_t i = count; i < toks.size(); ++i)
-      temp.push_back(toks[i]);
-    toks = temp;
+    toks.erase(toks.begin(), toks.begin() + count);
+    isIndexed_ = false;
   }
   //----< does semi contain specific token? >----------------------
 
   bool Semi::contains(Token tok) const
   {
-    for (Token test : toks)
+    int key = TokenIndex::keyOf(tok);
+    if (key >= 0)
+    {
+      ++TokenIndex::stats().lookups;
+      return tokenIndex().first(key) != TokenIndex::npos;
+    }
+    ++TokenIndex::stats().scans;
+    for (const Token& test : toks)
       if (test == tok)
         return true;
     return false;
   }
   //----< find token in semi >-------------------------------------
-
+  /*
+   * Indexed tokens are answered from their first and last positions,
+   * unless the offset falls between them, which needs a scan.
+   */
   bool Semi::find(Token tok, size_t& index, size_t offset) const
   {
+    int key = TokenIndex::keyOf(tok);
+    if (key >= 0)
+    {
+      const TokenIndex& positions = tokenIndex();
+      size_t first = positions.first(key);
+      size_t last = positions.last(key);
+      if (last == TokenIndex::npos || last < offset)
+      {
+        ++TokenIndex::stats().lookups;
+        index = size();
+        return false;
+      }
+      if (first >= offset)
+      {
+        ++TokenIndex::stats().lookups;
+        index = first;
+        return true;
+      }
+    }
+    ++TokenIndex::stats().scans;
     for (index = offset; index < size(); ++index)
     {
       if (toks[index] == tok)
@@ -138,6 +180,15 @@ namespace Lexer
 
   bool Semi::findLast(Token tok, size_t& index) const
   {
+    int key = TokenIndex::keyOf(tok);
+    if (key >= 0)
+    {
+      ++TokenIndex::stats().lookups;
+      size_t last = tokenIndex().last(key);
+      index = (last == TokenIndex::npos) ? size() : last;
+      return last != TokenIndex::npos;
+    }
+    ++TokenIndex::stats().scans;
     int pos = -1;
     for (size_t i = 0; i < toks.size(); ++i)
     {
@@ -169,10 +220,10 @@ namespace Lexer
   }
   //----< test for ordered sequence of tokens >--------------------
 
-  bool Semi::hasSequence(TokColl tokSeq)
+  bool Semi::hasSequence(const TokColl& tokSeq)
   {
     int position = 0;
-    for (Token tok : toks)
+    for (const Token& tok : toks)
     {
       if (position == tokSeq.size() - 1)
         return true;
@@ -185,33 +236,51 @@ namespace Lexer
 
   void Semi::fold()
   {
-    TokColl tc1{ "for", "(", ":" };
+    static const TokColl tc1{ "for", "(", ":" };
     if (hasSequence(tc1))
       return;
-    TokColl tc{ "for", "(", ";" };
+    static const TokColl tc{ "for", "(", ";" };
     if (hasSequence(tc))
     {
-      Semi temp;
-      temp.addRange(this->toks);
+      TokColl temp;
+      temp.swap(toks);
       get();  // get i<N;
-      temp.addRange(this->toks);
-      get();
-      temp.addRange(this->toks);  // get ++i) .. {
-      toks = temp.toks;
+      temp.insert(temp.end(), std::make_move_iterator(toks.begin()), std::make_move_iterator(toks.end()));
+      get();  // get ++i) .. {
+      temp.insert(temp.end(), std::make_move_iterator(toks.begin()), std::make_move_iterator(toks.end()));
+      toks.swap(temp);
+      isIndexed_ = false;
     }
   }
   //----< used by parser to get the next collection of tokens >----
-
+  /*
+   * - toks keeps its capacity from one semi to the next and each token
+   *   is moved in from the toker, so a steady state get allocates nothing.
+   * - Newlines are never stored, so a semi starting with "#" is known
+   *   from its first token and is ended by the next newline, without
+   *   the rescan and trim that isTerminator does.
+   */
   bool Semi::get()
   {
     toks.clear();
+    isIndexed_ = false;
+    bool isPreprocessor = false;
 
     while (!pToker_->isDone())
     {
       Token tok = pToker_->getTok();
-      if (tok != "\n")
-        toks.push_back(tok);
-      if (isTerminator(tok))
+      if (tok == "\n")
+      {
+        if (!isPreprocessor)
+          continue;
+        fold();
+        return true;
+      }
+      if (toks.empty())
+        isPreprocessor = (tok == "#");
+      bool isEnd = isEndOfStatement(tok);
+      toks.push_back(std::move(tok));
+      if (isEnd)
       {
         fold();
         return true;
@@ -220,9 +289,27 @@ namespace Lexer
     return false;
   }
   //----< clone replaces tokens in caller with tokens of argument >----
-
+  /*
+   * Copying from another Semi assigns over our existing tokens, reusing
+   * their storage, instead of rebuilding each one through operator[].
+   */
   void Semi::clone(const ITokenCollection& tc, size_t offset)
   {
+    isIndexed_ = false;
+    const Semi* pSemi = dynamic_cast<const Semi*>(&tc);
+    if (pSemi != nullptr && pSemi != this)
+    {
+      if (offset < pSemi->toks.size())
+        toks.assign(pSemi->toks.begin() + offset, pSemi->toks.end());
+      else
+        toks.clear();
+      if (offset == 0 && pSemi->isIndexed_)
+      {
+        index_ = pSemi->index_;
+        isIndexed_ = true;
+      }
+      return;
+    }
     toks.clear();
     for (size_t i = offset; i < tc.size(); ++i)
     {
@@ -239,14 +326,16 @@ namespace Lexer
   ITokenCollection* Semi::clone() const
   {
     Semi* pClone = new Semi;
-    for (size_t i = 0; i < size(); ++i)
-      pClone->add(toks[i]);
+    pClone->toks = toks;
+    pClone->index_ = index_;
+    pClone->isIndexed_ = isIndexed_;
     return pClone;
   }
   //----< indexer allows us to index for a specific token >--------
 
   Token& Semi::operator[](size_t i)
   {
+    isIndexed_ = false;  // caller may assign through the reference
     if (i < 0 || toks.size() <= i)
       throw(std::exception());
     return toks[i];
@@ -263,12 +352,14 @@ namespace Lexer
 
   Semi::iterator Semi::begin()
   {
+    isIndexed_ = false;
     return toks.begin();
   }
   //----< end iterator >-------------------------------------------
 
   Semi::iterator Semi::end()
   {
+    isIndexed_ = false;
     return toks.end();
   }
   //----< add a token to the end of this semi-expression >---------
@@ -276,12 +367,14 @@ namespace Lexer
   ITokenCollection* Semi::add(Token token)
   {
     toks.push_back(token);
+    isIndexed_ = false;
     return this;
   }
   //----< remove element at index >---------------------------------
 
   bool Semi::remove(size_t index)
   {
+    isIndexed_ = false;
     iterator iter = toks.erase(toks.begin() + index);
     return (toks.begin() <= iter && iter < toks.end());
   }
@@ -299,6 +392,7 @@ namespace Lexer
   void Semi::clear()
   {
     toks.clear();
+    isIndexed_ = false;
   }
   //----< are we at the end of the token source stream? >----------
 
@@ -314,6 +408,7 @@ namespace Lexer
       return false;
     TokColl::iterator iter = toks.begin();
     toks.insert(iter + n, tok);
+    isIndexed_ = false;
     return true;
   }
   //----< does this semi-expression contain a terminator? >--------
@@ -332,7 +427,7 @@ namespace Lexer
   {
     std::ostringstream out;
     out << "\n-- ";
-    for (Token tok : toks)
+    for (const Token& tok : toks)
     {
       if (tok != "\n")
         out << tok << " ";
@@ -341,6 +436,17 @@ namespace Lexer
     }
     return out.str();
   }
+  //----< positions of structural tokens, built on first use >------
+
+  const TokenIndex& Semi::tokenIndex() const
+  {
+    if (!isIndexed_)
+    {
+      index_.build(toks);
+      isIndexed_ = true;
+    }
+    return index_;
+  }
   //----< is this token a comment? >---------------------------------
 
   bool Semi::isComment(Token tok)
@@ -2,7 +2,7 @@
 #define SEMI_H
 /////////////////////////////////////////////////////////////////////
 // Semi.h - Collects groups of tokens that are useful for          //
-// ver 1.1   grammatical analysis                                  //
+// ver 1.3   grammatical analysis                                  //
 //                                                                 //
 // Jim Fawcett, CSE687 - Object Oriented Design, Spring 2019       //
 /////////////////////////////////////////////////////////////////////
@@ -29,6 +29,14 @@
  * 
  * Maintenance History
  * -------------------
+ * ver 1.3 : 19 Oct 2026
+ * - find, findLast and contains answer structural tokens and keywords
+ *   from a TokenIndex built on first use, instead of rescanning
+ * ver 1.2 : 19 Oct 2026
+ * - get() moves tokens into storage kept from the last semi and
+ *   tracks a leading "#" as it goes, so it no longer allocates or
+ *   trims per token; trim() erases in place, clone() copies directly
+ *   and hasSequence takes its sequence by reference
  * ver 1.1 : 27 Feb 2019
  * - fixed bug in fold() by returning if range-based for
  * ver 1.0 : 09 Jan 2019
@@ -62,6 +70,8 @@ namespace Lexer
   private:
     TokColl toks;  // private collection of tokens
     Toker* pToker_ = nullptr;
+    mutable TokenIndex index_;        // valid only while isIndexed_
+    mutable bool isIndexed_ = false;  // cleared by every change to toks
 
   public:
     Semi(bool createToker = false);
@@ -84,7 +94,7 @@ namespace Lexer
     virtual bool findLast(Token tok, size_t&index) const override;
     virtual Token predecessor(Token tok) override;
     virtual Token last() const override;
-    virtual bool hasSequence(TokColl tokSeq) override;
+    virtual bool hasSequence(const TokColl& tokSeq) override;
     void fold();
     virtual bool get() override;
     virtual void clone(const ITokenCollection& tc, size_t offset = 0) override;
@@ -102,6 +112,9 @@ namespace Lexer
     virtual bool hasTerminator() override;
     virtual std::string show() const override;
     virtual bool isComment(Token tok) override;
+    virtual const TokenIndex& tokenIndex() const override;
+  private:
+    static bool isEndOfStatement(const Token& tok);
   };
 
   class Factory
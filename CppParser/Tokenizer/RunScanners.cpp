@@ -0,0 +1,420 @@
+/////////////////////////////////////////////////////////////////////
+// RunScanners.cpp - scalar, SSE2 and AVX2 run scanners            //
+// ver 1.1                                                         //
+// Sneha Giranje, CSE687 - Object Oriented Design, Spring 2019     //
+/////////////////////////////////////////////////////////////////////
+
+#include "RunScanners.h"
+#include <atomic>
+#include <cstdint>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define RUNSCANNERS_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define TARGET_SSE2
+#define TARGET_AVX2
+#else
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace Lexer
+{
+  namespace
+  {
+    //----< char tests, matching TableLexer's char classes >---------
+
+    inline bool isAlphaNumChar(char ch)
+    {
+      return ('a' <= ch && ch <= 'z') || ('A' <= ch && ch <= 'Z') || ('0' <= ch && ch <= '9') || ch == '_';
+    }
+
+    inline bool isWhiteSpaceChar(char ch)
+    {
+      return ch == ' ' || ch == '\t' || ch == '\v' || ch == '\f' || ch == '\r';
+    }
+
+    inline bool endsLineComment(char ch)
+    {
+      return ch == '\n' || static_cast<unsigned char>(ch) == 0xFF;
+    }
+
+    inline bool mayStartCommentOrQuote(char ch)
+    {
+      return ch == '/' || ch == '\"' || ch == '\'' || ch == '@';
+    }
+
+    //----< scalar scanners >----------------------------------------
+
+    const char* alphaNumScalar(const char* p, const char* end)
+    {
+      while (p != end && isAlphaNumChar(*p))
+        ++p;
+      return p;
+    }
+
+    const char* whiteSpaceScalar(const char* p, const char* end)
+    {
+      while (p != end && isWhiteSpaceChar(*p))
+        ++p;
+      return p;
+    }
+
+    const char* lineCommentScalar(const char* p, const char* end)
+    {
+      while (p != end && !endsLineComment(*p))
+        ++p;
+      return p;
+    }
+
+    // prevCh is the char before p, or a space at the start of the
+    // comment, as the star of its opening can't also close it
+
+    const char* blockCommentTail(const char* p, const char* end, char prevCh, size_t& newLines)
+    {
+      while (p != end)
+      {
+        char ch = *p++;
+        if (ch == '\n')
+          ++newLines;
+        if ((prevCh == '*' && ch == '/') || static_cast<unsigned char>(ch) == 0xFF)
+          return p;
+        prevCh = ch;
+      }
+      return nullptr;
+    }
+
+    const char* blockCommentScalar(const char* p, const char* end, size_t& newLines)
+    {
+      return blockCommentTail(p, end, ' ', newLines);
+    }
+
+    const char* commentOrQuoteScalar(const char* p, const char* end)
+    {
+      while (p != end && !mayStartCommentOrQuote(*p))
+        ++p;
+      return p;
+    }
+
+#ifdef RUNSCANNERS_X86
+
+    //----< bit helpers for movemask results >-----------------------
+
+    inline unsigned lowestBit(uint32_t mask)
+    {
+#ifdef _MSC_VER
+      unsigned long index;
+      _BitScanForward(&index, mask);
+      return unsigned(index);
+#else
+      return unsigned(__builtin_ctz(mask));
+#endif
+    }
+
+    inline size_t bitCount(uint32_t mask)
+    {
+      size_t count = 0;
+      for (; mask != 0; mask &= mask - 1)
+        ++count;
+      return count;
+    }
+
+    //----< SSE2 scanners, 16 chars per step >-----------------------
+    /*
+     * Signed compares serve as range tests, as every range tested is
+     * in 0x00 - 0x7F and bytes 0x80 - 0xFF compare as negative.
+     */
+    TARGET_SSE2 inline __m128i inRange(__m128i v, char lo, char hi)
+    {
+      return _mm_and_si128(
+        _mm_cmpgt_epi8(v, _mm_set1_epi8(char(lo - 1))),
+        _mm_cmpgt_epi8(_mm_set1_epi8(char(hi + 1)), v)
+      );
+    }
+
+    TARGET_SSE2 const char* alphaNumSSE2(const char* p, const char* end)
+    {
+      while (end - p >= 16)
+      {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+        __m128i hit = _mm_or_si128(inRange(lower, 'a', 'z'), inRange(v, '0', '9'));
+        hit = _mm_or_si128(hit, _mm_cmpeq_epi8(v, _mm_set1_epi8('_')));
+        uint32_t stop = ~uint32_t(_mm_movemask_epi8(hit)) & 0xFFFF;
+        if (stop != 0)
+          return p + lowestBit(stop);
+        p += 16;
+      }
+      return alphaNumScalar(p, end);
+    }
+
+    TARGET_SSE2 const char* whiteSpaceSSE2(const char* p, const char* end)
+    {
+      while (end - p >= 16)
+      {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i hit = _mm_andnot_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')), inRange(v, '\t', '\r'));
+        hit = _mm_or_si128(hit, _mm_cmpeq_epi8(v, _mm_set1_epi8(' ')));
+        uint32_t stop = ~uint32_t(_mm_movemask_epi8(hit)) & 0xFFFF;
+        if (stop != 0)
+          return p + lowestBit(stop);
+        p += 16;
+      }
+      return whiteSpaceScalar(p, end);
+    }
+
+    TARGET_SSE2 const char* lineCommentSSE2(const char* p, const char* end)
+    {
+      while (end - p >= 16)
+      {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i hit = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(v, _mm_set1_epi8(char(0xFF))));
+        uint32_t stop = uint32_t(_mm_movemask_epi8(hit));
+        if (stop != 0)
+          return p + lowestBit(stop);
+        p += 16;
+      }
+      return lineCommentScalar(p, end);
+    }
+
+    // after the first char, each position is tested together with the
+    // char before it, loaded one byte back, to find a star-slash
+
+    TARGET_SSE2 const char* blockCommentSSE2(const char* p, const char* end, size_t& newLines)
+    {
+      if (p == end)
+        return nullptr;
+      if (*p == '\n')
+        ++newLines;
+      if (static_cast<unsigned char>(*p) == 0xFF)
+        return p + 1;
+      ++p;
+      while (end - p >= 16)
+      {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i prev = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p - 1));
+        __m128i close = _mm_and_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('/')), _mm_cmpeq_epi8(prev, _mm_set1_epi8('*')));
+        close = _mm_or_si128(close, _mm_cmpeq_epi8(v, _mm_set1_epi8(char(0xFF))));
+        uint32_t stop = uint32_t(_mm_movemask_epi8(close));
+        uint32_t lines = uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n'))));
+        if (stop != 0)
+        {
+          unsigned i = lowestBit(stop);
+          newLines += bitCount(lines & ((2u << i) - 1));
+          return p + i + 1;
+        }
+        newLines += bitCount(lines);
+        p += 16;
+      }
+      return blockCommentTail(p, end, p[-1], newLines);
+    }
+
+    TARGET_SSE2 const char* commentOrQuoteSSE2(const char* p, const char* end)
+    {
+      while (end - p >= 16)
+      {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i hit = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('/')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\"')));
+        hit = _mm_or_si128(hit, _mm_cmpeq_epi8(v, _mm_set1_epi8('\'')));
+        hit = _mm_or_si128(hit, _mm_cmpeq_epi8(v, _mm_set1_epi8('@')));
+        uint32_t stop = uint32_t(_mm_movemask_epi8(hit));
+        if (stop != 0)
+          return p + lowestBit(stop);
+        p += 16;
+      }
+      return commentOrQuoteScalar(p, end);
+    }
+
+    //----< AVX2 scanners, 32 chars per step >-----------------------
+
+    TARGET_AVX2 inline __m256i inRange256(__m256i v, char lo, char hi)
+    {
+      return _mm256_and_si256(
+        _mm256_cmpgt_epi8(v, _mm256_set1_epi8(char(lo - 1))),
+        _mm256_cmpgt_epi8(_mm256_set1_epi8(char(hi + 1)), v)
+      );
+    }
+
+    TARGET_AVX2 const char* alphaNumAVX2(const char* p, const char* end)
+    {
+      while (end - p >= 32)
+      {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i lower = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+        __m256i hit = _mm256_or_si256(inRange256(lower, 'a', 'z'), inRange256(v, '0', '9'));
+        hit = _mm256_or_si256(hit, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('_')));
+        uint32_t stop = ~uint32_t(_mm256_movemask_epi8(hit));
+        if (stop != 0)
+          return p + lowestBit(stop);
+        p += 32;
+      }
+      return alphaNumScalar(p, end);
+    }
+
+    TARGET_AVX2 const char* whiteSpaceAVX2(const char* p, const char* end)
+    {
+      while (end - p >= 32)
+      {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i hit = _mm256_andnot_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')), inRange256(v, '\t', '\r'));
+        hit = _mm256_or_si256(hit, _mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')));
+        uint32_t stop = ~uint32_t(_mm256_movemask_epi8(hit));
+        if (stop != 0)
+          return p + lowestBit(stop);
+        p += 32;
+      }
+      return whiteSpaceScalar(p, end);
+    }
+
+    TARGET_AVX2 const char* lineCommentAVX2(const char* p, const char* end)
+    {
+      while (end - p >= 32)
+      {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i hit = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8(char(0xFF))));
+        uint32_t stop = uint32_t(_mm256_movemask_epi8(hit));
+        if (stop != 0)
+          return p + lowestBit(stop);
+        p += 32;
+      }
+      return lineCommentScalar(p, end);
+    }
+
+    TARGET_AVX2 const char* blockCommentAVX2(const char* p, const char* end, size_t& newLines)
+    {
+      if (p == end)
+        return nullptr;
+      if (*p == '\n')
+        ++newLines;
+      if (static_cast<unsigned char>(*p) == 0xFF)
+        return p + 1;
+      ++p;
+      while (end - p >= 32)
+      {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i prev = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p - 1));
+        __m256i close = _mm256_and_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('/')), _mm256_cmpeq_epi8(prev, _mm256_set1_epi8('*')));
+        close = _mm256_or_si256(close, _mm256_cmpeq_epi8(v, _mm256_set1_epi8(char(0xFF))));
+        uint32_t stop = uint32_t(_mm256_movemask_epi8(close));
+        uint32_t lines = uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n'))));
+        if (stop != 0)
+        {
+          unsigned i = lowestBit(stop);
+          newLines += bitCount(lines & ((2u << i) - 1));
+          return p + i + 1;
+        }
+        newLines += bitCount(lines);
+        p += 32;
+      }
+      return blockCommentTail(p, end, p[-1], newLines);
+    }
+
+    TARGET_AVX2 const char* commentOrQuoteAVX2(const char* p, const char* end)
+    {
+      while (end - p >= 32)
+      {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i hit = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('/')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\"')));
+        hit = _mm256_or_si256(hit, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\'')));
+        hit = _mm256_or_si256(hit, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('@')));
+        uint32_t stop = uint32_t(_mm256_movemask_epi8(hit));
+        if (stop != 0)
+          return p + lowestBit(stop);
+        p += 32;
+      }
+      return commentOrQuoteScalar(p, end);
+    }
+
+    //----< ask the CPU, and on AVX2 the OS, what is supported >----
+
+    bool cpuHasSSE2()
+    {
+#ifdef _MSC_VER
+      int info[4];
+      __cpuid(info, 1);
+      return (info[3] >> 26) & 1;
+#else
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("sse2") != 0;
+#endif
+    }
+
+    bool cpuHasAVX2()
+    {
+#ifdef _MSC_VER
+      int info[4];
+      __cpuid(info, 0);
+      if (info[0] < 7)
+        return false;
+      __cpuid(info, 1);
+      bool osSavesYmm = ((info[2] >> 27) & 1) && ((info[2] >> 28) & 1) && ((_xgetbv(0) & 6) == 6);
+      __cpuidex(info, 7, 0);
+      return osSavesYmm && ((info[1] >> 5) & 1);
+#else
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("avx2") != 0;
+#endif
+    }
+#endif
+
+    //----< scanner sets, indexed by SimdLevel >---------------------
+
+    const RunScanners scannerSets[] = {
+      { SimdLevel::Scalar, alphaNumScalar, whiteSpaceScalar, lineCommentScalar, blockCommentScalar, commentOrQuoteScalar },
+#ifdef RUNSCANNERS_X86
+      { SimdLevel::SSE2, alphaNumSSE2, whiteSpaceSSE2, lineCommentSSE2, blockCommentSSE2, commentOrQuoteSSE2 },
+      { SimdLevel::AVX2, alphaNumAVX2, whiteSpaceAVX2, lineCommentAVX2, blockCommentAVX2, commentOrQuoteAVX2 },
+#endif
+    };
+
+    std::atomic<const RunScanners*>& selected()
+    {
+      static std::atomic<const RunScanners*> pSelected(&scannerSets[int(bestSimdLevel())]);
+      return pSelected;
+    }
+  }
+
+  //----< best level this CPU supports, tested once >----------------
+
+  SimdLevel bestSimdLevel()
+  {
+    static const SimdLevel level = []() {
+#ifdef RUNSCANNERS_X86
+      if (cpuHasAVX2())
+        return SimdLevel::AVX2;
+      if (cpuHasSSE2())
+        return SimdLevel::SSE2;
+#endif
+      return SimdLevel::Scalar;
+    }();
+    return level;
+  }
+  //----< scanners TableLexer uses >---------------------------------
+
+  const RunScanners& runScanners()
+  {
+    return *selected().load(std::memory_order_relaxed);
+  }
+  //----< choose scanners, e.g., to compare levels >-----------------
+
+  bool selectRunScanners(SimdLevel level)
+  {
+    if (int(level) > int(bestSimdLevel()))
+      return false;
+    selected().store(&scannerSets[int(level)], std::memory_order_relaxed);
+    return true;
+  }
+
+  const char* simdLevelName(SimdLevel level)
+  {
+    switch (level)
+    {
+    case SimdLevel::SSE2: return "SSE2";
+    case SimdLevel::AVX2: return "AVX2";
+    default: return "scalar";
+    }
+  }
+}
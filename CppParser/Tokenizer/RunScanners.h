@@ -0,0 +1,67 @@
+#ifndef RUNSCANNERS_H
+#define RUNSCANNERS_H
+/////////////////////////////////////////////////////////////////////
+// RunScanners.h - find the end of a run of chars, many at a time  //
+// ver 1.1                                                         //
+// Sneha Giranje, CSE687 - Object Oriented Design, Spring 2019     //
+/////////////////////////////////////////////////////////////////////
+/*
+ * Package Operations:
+ * -------------------
+ * TableLexer spends most of its time walking identifiers, indentation,
+ * and comments.  This package provides scanners that find where each
+ * of those runs ends in a contiguous buffer:
+ * - alphaNum      first char that is not a letter, digit, or underscore
+ * - whiteSpace    first char that is not space, tab, \v, \f, or \r
+ * - lineComment   first newline or 0xFF byte
+ * - blockComment  just past the next star-slash or 0xFF byte, counting
+ *                 newlines on the way
+ * - commentOrQuote first slash, quote, or @, the chars that may start
+ *                 a comment or a quoted string
+ * Each comes in a scalar version and, on x86, SSE2 and AVX2 versions
+ * that test 16 or 32 chars with a few vector compares.  runScanners()
+ * returns the best set the CPU supports, chosen once at runtime, so
+ * the binary still runs on CPUs without AVX2.
+ *
+ * Required Files:
+ * ---------------
+ * RunScanners.h, RunScanners.cpp
+ *
+ * Maintenance History
+ * -------------------
+ * ver 1.1 : 19 Oct 2026
+ * - added commentOrQuote, used by TableLexer's pre-scan for newlines
+ *   where a large file can safely be split
+ * ver 1.0 : 19 Oct 2026
+ * - first release
+ */
+
+#include <cstddef>
+
+namespace Lexer
+{
+  enum class SimdLevel { Scalar, SSE2, AVX2 };
+
+  ///////////////////////////////////////////////////////////////////
+  // RunScanners struct
+  // - each scanner starts at p and never reads at or past end
+  // - blockComment starts after the opening slash-star, and returns
+  //   nullptr, having counted all the newlines, if the comment isn't
+  //   closed before end
+
+  struct RunScanners
+  {
+    SimdLevel level;
+    const char* (*alphaNum)(const char* p, const char* end);
+    const char* (*whiteSpace)(const char* p, const char* end);
+    const char* (*lineComment)(const char* p, const char* end);
+    const char* (*blockComment)(const char* p, const char* end, size_t& newLines);
+    const char* (*commentOrQuote)(const char* p, const char* end);
+  };
+
+  SimdLevel bestSimdLevel();                // best level this CPU supports
+  const RunScanners& runScanners();         // currently selected scanners
+  bool selectRunScanners(SimdLevel level);  // for tests and benchmarks, false if not supported
+  const char* simdLevelName(SimdLevel level);
+}
+#endif
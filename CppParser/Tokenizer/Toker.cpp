@@ -1,18 +1,22 @@
 /////////////////////////////////////////////////////////////////////
 // Toker.cpp - Collects words from a stream                        //
-// ver 1.1                                                         //
+// ver 2.0                                                         //
 // Jim Fawcett, CSE687 - Object Oriented Design, Spring 2019       //
 /////////////////////////////////////////////////////////////////////
 
 #include <iostream>
 #include <iomanip>
 #include <string>
+#include <cstring>
+#include <algorithm>
+#include <thread>
 #include "Toker.h"
+#include "RunScanners.h"
 
 namespace Lexer
 {
 
-  TokenContext* ITokenState::pContext_;  // derived classes store context ref here
+  thread_local TokenContext* ITokenState::pContext_;  // derived classes store context ref here
   
   void ITokenState::setContext(TokenContext* pContext)
   {
@@ -52,7 +56,7 @@ namespace Lexer
     pSrc_ = nullptr;
   }
 
-  TokenSourceFile::TokenSourceFile(TokenContext* pContext)
+  TokenSourceFile::TokenSourceFile(TokenContext* pContext) : pNext_(nullptr)
   {
     lineCount(1);
     pContext_ = pContext;
@@ -61,20 +65,21 @@ namespace Lexer
   TokenSourceFile::~TokenSourceFile()
   {
    // std::cout << "\n  TokenSourceFile instance closing";
-    if (fs_.good())
-      fs_.close();
     std::cout << "\n";
   }
-  //----< attempt to open file with ifstream >---------------------
+  //----< attempt to read file into view_ >-----------------------
 
   bool TokenSourceFile::open(std::string path)
   {
     std::cout << "\n  attempting to open " << path;
-    fs_ = std::ifstream(path, std::ios::in);
-    if (fs_.good())
+    charQ_.clear();
+    lineCount(1);
+    if (view_.open(path))
     {
+      pNext_ = view_.begin();
       std::cout << "\n  open successful";
-      ITokenState* pCurr = pContext_->pCurrentState_;
+      skipByteOrderMark();
+      ITokenState* pCurr = pContext_->pWhiteSpaceState_;  // last file may have left none
       ITokenState* pNext = pCurr->nextState();
       pContext_->pCurrentState_ = pNext;
       return true;
@@ -82,17 +87,44 @@ namespace Lexer
     std::cout << "\n  open failed";
     return false;
   }
+  //----< discard UTF-8 byte order mark, if present >--------------
+  /*
+   *  - otherwise the mark is collected with the punctuator that follows
+   *    it, e.g., the # of a leading #include, and both are discarded
+   */
+  void TokenSourceFile::skipByteOrderMark()
+  {
+    if (peek() == 0xEF && peek(1) == 0xBB && peek(2) == 0xBF)
+      charQ_.clear();
+  }
   //----< close file >---------------------------------------------
 
   void TokenSourceFile::close()
   {
-    if(fs_.good())
-      fs_.close();
+    view_.close();
+    pNext_ = nullptr;
+    charQ_.clear();
+  }
+  //----< read next char from view, -1 at end >--------------------
+  /*
+   *  - returns chars as unsigned values, as ifstream::get() did
+   *  - on Windows, a return before a newline is dropped, as it was
+   *    when the file was read through a text mode stream
+   */
+  int TokenSourceFile::read()
+  {
+    if (pNext_ == view_.end())
+      return -1;
+#ifdef _WIN32
+    if (*pNext_ == '\r' && pNext_ + 1 != view_.end() && pNext_[1] == '\n')
+      ++pNext_;
+#endif
+    return static_cast<unsigned char>(*pNext_++);
   }
   //----< extract the next available integer >---------------------
   /*
    *  - checks to see if previously enqueued peeked ints are available
-   *  - if not, reads from stream
+   *  - if not, reads from view
    */
   int TokenSourceFile::next()
   {
@@ -101,7 +133,7 @@ namespace Lexer
     {
       if (end())
         return -1;
-      ch = fs_.get();
+      ch = read();
     }
     else                    // has saved peeked ints, so use the first
     {
@@ -115,8 +147,8 @@ namespace Lexer
   //----< peek n ints into source without extracting them >--------
   /*
    *  - This is an organizing prinicple that makes tokenizing easier
-   *  - We enqueue because file streams only allow peeking at the first int
-   *    and even that isn't always reliable if an error occurred.
+   *  - We enqueue so that peeked chars get the same newline translation,
+   *    and later the same line counting, as chars read by next().
    *  - When we look for two punctuator tokens, like ==, !=, etc. we want
    *    to detect their presence without removing them from the stream.
    */
@@ -130,34 +162,476 @@ namespace Lexer
     {
       for (size_t i = charQ_.size(); i <= n; ++i)
       {
-        if (end())
+        int ch = read();
+        if (ch == -1)
           return -1;
-        charQ_.push_back(fs_.get());  // read and enqueue
+        charQ_.push_back(ch);  // read and enqueue
       }
       return charQ_[n];   // now return the last peeked
     }
   }
-  //----< reached the end of the file stream? >--------------------
-
+  //----< reached the end of the file view? >----------------------
+  /*
+   *  - peeked ints still in the queue have not been consumed, so the
+   *    source is not done until they are gone, even if the view is
+   */
   bool TokenSourceFile::end()
   {
-    return !(fs_.good());
+    return charQ_.size() == 0 && pNext_ == view_.end();
   }
 
-  TokenState::TokenState()
+  //----< char classes and transitions used by TableLexer >--------
+
+  namespace
   {
-    std::unordered_set<std::string> oneTemp
+    enum CharClass : uint8_t
     {
-      "<", ">", "[", "]", "(", ")", "{", "}", ".", ";", "=", "+", "-", "*"
+      WhiteSpaceChar, NewLineChar, AlphaNumChar, SlashChar,
+      DoubleQuoteChar, SingleQuoteChar, AtChar, PunctuationChar,
+      NumCharClasses
     };
-    oneCharTokens_(oneTemp);
 
-    std::unordered_set<std::string> twoTemp
+    // classes agree with the states' tests in the "C" locale, and
+    // every char they don't name, including 0x80 - 0xFF, is punctuation
+
+    struct CharClassTable
     {
-      "<<", ">>", "::", "++", "--", "==", "+=", "-=", "*=", "/=", "&&", "||"
+      uint8_t classOf[256];
     };
+
+    constexpr CharClassTable makeCharClassTable()
+    {
+      CharClassTable table{};
+      for (int ch = 0; ch < 256; ++ch)
+      {
+        uint8_t cls = PunctuationChar;
+        if (ch == ' ' || ch == '\t' || ch == '\v' || ch == '\f' || ch == '\r')
+          cls = WhiteSpaceChar;
+        else if (ch == '\n')
+          cls = NewLineChar;
+        else if (('a' <= ch && ch <= 'z') || ('A' <= ch && ch <= 'Z') || ('0' <= ch && ch <= '9') || ch == '_')
+          cls = AlphaNumChar;
+        else if (ch == '/')
+          cls = SlashChar;
+        else if (ch == '\"')
+          cls = DoubleQuoteChar;
+        else if (ch == '\'')
+          cls = SingleQuoteChar;
+        else if (ch == '@')
+          cls = AtChar;
+        table.classOf[ch] = cls;
+      }
+      return table;
+    }
+
+    constexpr CharClassTable charClasses = makeCharClassTable();
+
+    inline uint8_t classOf(char ch)
+    {
+      return charClasses.classOf[static_cast<unsigned char>(ch)];
+    }
+
+    // kind of token started by each class - a slash or an @ needs the
+    // next char to decide, as // and /* start comments and @" a string
+
+    enum TokenKind : uint8_t
+    {
+      WhiteSpaceTok, NewLineTok, AlphaNumTok, PunctuationTok,
+      LineCommentTok, BlockCommentTok, DoubleQuoteTok, SingleQuoteTok,
+      LookAhead
+    };
+
+    constexpr uint8_t startOf[NumCharClasses] = {
+      WhiteSpaceTok, NewLineTok, AlphaNumTok, LookAhead,
+      DoubleQuoteTok, SingleQuoteTok, LookAhead, PunctuationTok
+    };
+
+    // does a char of each class extend a run of whitespace, newline,
+    // alphanumeric, or punctuation chars?
+
+    enum Step : uint8_t { Stop, Extend, ExtendUnlessStart };
+
+    constexpr uint8_t runStep[PunctuationTok + 1][NumCharClasses] = {
+      { Extend, Stop, Stop,   Stop,              Stop, Stop, Stop,              Stop   },  // whitespace
+      { Stop,   Stop, Stop,   Stop,              Stop, Stop, Stop,              Stop   },  // newline
+      { Stop,   Stop, Extend, Stop,              Stop, Stop, Stop,              Stop   },  // alphanumeric
+      { Stop,   Stop, Stop,   ExtendUnlessStart, Stop, Stop, ExtendUnlessStart, Extend }   // punctuation
+    };
+
+    //----< does text at p start a comment or an @"string"? >------
+
+    inline bool startsCommentOrString(const char* p, const char* end)
+    {
+      if (p + 1 == end)
+        return false;
+      if (p[0] == '/')
+        return p[1] == '/' || p[1] == '*';
+      return p[0] == '@' && p[1] == '\"';
+    }
+    //----< extend run of token kind from p >-----------------------
+
+    inline const char* scanRun(const char* p, const char* end, uint8_t kind)
+    {
+      while (p != end)
+      {
+        uint8_t step = runStep[kind][classOf(*p)];
+        if (step == Stop || (step == ExtendUnlessStart && startsCommentOrString(p, end)))
+          break;
+        ++p;
+      }
+      return p;
+    }
+  }
+
+  TableLexer::TableLexer(const PunctuatorTable& punctuators) : punctuators_(punctuators) {}
+
+  TableLexer::~TableLexer()
+  {
+    close();
+  }
+  //----< view file and skip a UTF-8 byte order mark >-------------
+  /*
+   *  - the file is mapped only if it will be lexed in parallel, as a
+   *    mapped file truncated while it is lexed faults; a smaller one
+   *    is read, and one truncated meanwhile just ends sooner
+   *  - on Windows, a return before a newline is folded out of a copy
+   *    of the text, as TokenSourceFile::read() drops it
+   *  - then, if the text is large enough, workers start on its chunks
+   */
+  bool TableLexer::open(const std::string& path, size_t parallelThreshold, size_t chunks)
+  {
+    std::cout << "\n  attempting to open " << path;
+    close();
+    if (!view_.open(path, parallelThreshold > 0 ? parallelThreshold : FileSystem::FileView::neverMap))
+    {
+      std::cout << "\n  open failed";
+      return false;
+    }
+    std::cout << "\n  open successful";
+    attach(view_.begin(), view_.end());
+#ifdef _WIN32
+    if (std::memchr(pNext_, '\r', view_.size()) != nullptr)
+    {
+      folded_.reserve(view_.size());
+      for (const char* p = pNext_; p != pEnd_; ++p)
+      {
+        if (*p == '\r' && p + 1 != pEnd_ && p[1] == '\n')
+          continue;
+        folded_ += *p;
+      }
+      attach(folded_.data(), folded_.data() + folded_.size());
+    }
+#endif
+    if (pEnd_ - pNext_ >= 3 && static_cast<unsigned char>(pNext_[0]) == 0xEF &&
+      static_cast<unsigned char>(pNext_[1]) == 0xBB && static_cast<unsigned char>(pNext_[2]) == 0xBF)
+      pNext_ += 3;
+    startChunks(parallelThreshold, chunks);
+    return true;
+  }
+  //----< release file, first stopping the workers >---------------
+  /*
+   *  - destroying a future from std::async waits for its worker, so
+   *    the text isn't unmapped while a worker still reads it
+   */
+  void TableLexer::close()
+  {
+    cancel_.store(true, std::memory_order_relaxed);
+    chunks_.clear();
+    cancel_.store(false, std::memory_order_relaxed);
+    nextChunk_ = 0;
+    pChunk_ = nullptr;
+    chunkTokens_ = ChunkTokens();
+    nextToken_ = 0;
+    view_.close();
+    folded_.clear();
+    pNext_ = pEnd_ = nullptr;
+    lineCount_ = 1;
+  }
+  //----< lex text from pBegin to pEnd >---------------------------
+
+  void TableLexer::attach(const char* pBegin, const char* pEnd)
+  {
+    pScanners_ = &runScanners();
+    pNext_ = pBegin;
+    pEnd_ = pEnd;
+  }
+  //----< collect next token into tok >----------------------------
+  /*
+   *  - tok is assigned, not rebuilt, so its storage is reused
+   *  - in a chunk lexed by a worker, the token's end is looked up, and
+   *    its newlines are counted only if the worker found some
+   */
+  bool TableLexer::next(Token& tok)
+  {
+    if (pNext_ == pEnd_)
+      return false;
+    if (nextChunk_ != chunks_.size() && pNext_ == chunks_[nextChunk_].pBegin)
+      takeChunk();
+
+    const char* p;
+    bool unterminated = false;
+    if (nextToken_ != chunkTokens_.ends.size())
+    {
+      uint32_t end = chunkTokens_.ends[nextToken_++];
+      p = pChunk_ + (end & ~hasNewLines);
+      if (end & hasNewLines)
+        lineCount_ += std::count(pNext_, p, '\n');
+      unterminated = chunkTokens_.unterminated && nextToken_ == chunkTokens_.ends.size();
+    }
+    else
+      p = scan(pNext_, unterminated);
+    tok.assign(pNext_, p);
+    if (unterminated)
+      tok += '\xff';  // the end of file marker the states append
+    pNext_ = p;
+    return true;
+  }
+  //----< find end of the token starting at p >--------------------
+  /*
+   *  - a token ends where the states' getTok() would end it, and the
+   *    states' quirks are kept, e.g., a line comment stops at a 0xFF
+   *    byte, which they can't tell from end of file
+   */
+  const char* TableLexer::scan(const char* p, bool& unterminated)
+  {
+    uint8_t kind = startOf[classOf(*p)];
+    if (kind == LookAhead)
+    {
+      if (!startsCommentOrString(p, pEnd_))
+        kind = PunctuationTok;
+      else if (*p == '@')
+        kind = DoubleQuoteTok;
+      else
+        kind = (p[1] == '/') ? LineCommentTok : BlockCommentTok;
+    }
+
+    switch (kind)
+    {
+    case WhiteSpaceTok:
+      return pScanners_->whiteSpace(p + 1, pEnd_);
+    case AlphaNumTok:
+      return pScanners_->alphaNum(p + 1, pEnd_);
+    case NewLineTok:
+      ++lineCount_;
+      return p + 1;
+    case PunctuationTok:
+      return scanPunctuation(p);
+    case LineCommentTok:
+      return pScanners_->lineComment(p + 2, pEnd_);
+    case BlockCommentTok:
+    {
+      size_t newLines = 0;
+      const char* pClose = pScanners_->blockComment(p + 2, pEnd_, newLines);
+      lineCount_ += newLines;
+      unterminated = (pClose == nullptr);
+      return unterminated ? pEnd_ : pClose;
+    }
+    case DoubleQuoteTok:
+      return scanQuote(p, '\"', *p == '@');
+    default:
+      return scanQuote(p, '\'', false);
+    }
+  }
+  //----< special one or two char token, or run of punctuators >---
+
+  const char* TableLexer::scanPunctuation(const char* p)
+  {
+    bool hasSecond = (p + 1 != pEnd_);
+    unsigned char ch0 = static_cast<unsigned char>(p[0]);
+    unsigned char ch1 = hasSecond ? static_cast<unsigned char>(p[1]) : 0xFF;
+    if (hasSecond && punctuators_.hasTwo(ch0, ch1))
+    {
+      if (ch1 == '\n')
+        ++lineCount_;
+      return p + 2;
+    }
+    if (punctuators_.hasOne(ch0))
+      return p + 1;
+    return scanRun(p + 1, pEnd_, PunctuationTok);
+  }
+  //----< quoted char or string, ending at an unescaped quote >----
+  /*
+   *  - verbatim strings, @"...", end at the first quote
+   */
+  const char* TableLexer::scanQuote(const char* p, char quote, bool verbatim)
+  {
+    p += verbatim ? 2 : 1;
+    size_t escapes = 0;  // backslashes just before the current char
+    while (p != pEnd_)
+    {
+      char ch = *p++;
+      if (ch == '\n')
+        ++lineCount_;
+      if (ch == quote && (verbatim || escapes % 2 == 0))
+        break;
+      escapes = (ch == '\\') ? escapes + 1 : 0;
+    }
+    return p;
+  }
+
+  //----< can every newline outside comments and quotes end a token? >
+  /*
+   *  - the pre-scan below looks only for the chars that may start a
+   *    comment or quote, so it would be misled by a special token that
+   *    ends with one of them, or that starts with a newline
+   */
+  bool TableLexer::canSplit() const
+  {
+    const unsigned char starts[] = { '/', '\"', '\'', '@' };
+    for (int ch = 0; ch < 256; ++ch)
+    {
+      if (punctuators_.hasTwo('\n', static_cast<unsigned char>(ch)))
+        return false;
+      for (unsigned char start : starts)
+      {
+        if (punctuators_.hasTwo(static_cast<unsigned char>(ch), start))
+          return false;
+      }
+    }
+    return true;
+  }
+  //----< pre-scan for newlines where the text can be split >------
+  /*
+   *  - jumps from one char that may start a comment or quote to the
+   *    next, and over each comment and quote with the lexer's own
+   *    scanners, so every newline it passes between them is a token
+   *  - returns up to chunks - 1 split points, each just after such a
+   *    newline, about equally spaced
+   */
+  std::vector<const char*> TableLexer::findSplits(size_t chunks)
+  {
+    std::vector<const char*> splits;
+    size_t step = (pEnd_ - pNext_) / chunks;
+    const char* pTarget = pNext_ + step;
+    const char* p = pNext_;
+    size_t lineCount = lineCount_;  // scanQuote counts lines, restored below
+
+    while (p != pEnd_ && splits.size() + 1 < chunks)
+    {
+      const char* q = pScanners_->commentOrQuote(p, pEnd_);
+      while (pTarget < q && splits.size() + 1 < chunks)
+      {
+        const char* pFrom = std::max(p, pTarget);
+        const char* pNewLine = static_cast<const char*>(std::memchr(pFrom, '\n', q - pFrom));
+        if (pNewLine == nullptr)
+          break;
+        splits.push_back(pNewLine + 1);
+        pTarget = pNewLine + 1 + step;
+      }
+      if (q == pEnd_)
+        break;
+      if (!startsCommentOrString(q, pEnd_))
+        p = (*q == '\"' || *q == '\'') ? scanQuote(q, *q, false) : q + 1;
+      else if (*q == '@')
+        p = scanQuote(q, '\"', true);
+      else if (q[1] == '/')
+        p = pScanners_->lineComment(q + 2, pEnd_);
+      else
+      {
+        size_t newLines = 0;
+        p = pScanners_->blockComment(q + 2, pEnd_, newLines);
+        if (p == nullptr)  // unclosed, so nothing after it can be split
+          break;
+      }
+    }
+    lineCount_ = lineCount;
+    if (!splits.empty() && splits.back() == pEnd_)
+      splits.pop_back();
+    return splits;
+  }
+  //----< start a worker for each chunk after the first >----------
+  /*
+   *  - chunks, or if 0 one per hardware thread, each at least minChunkSize,
+   *    and small enough that token ends fit below the hasNewLines bit
+   */
+  void TableLexer::startChunks(size_t parallelThreshold, size_t chunks)
+  {
+    size_t size = pEnd_ - pNext_;
+    if (parallelThreshold == 0 || size < parallelThreshold || !canSplit())
+      return;
+    if (chunks == 0)
+      chunks = std::thread::hardware_concurrency();
+    chunks = std::min<size_t>(chunks, size / minChunkSize);
+    chunks = std::max<size_t>(chunks, size / (hasNewLines / 2) + 1);
+    if (chunks < 2)
+      return;
+
+    std::vector<const char*> splits = findSplits(chunks);
+    splits.push_back(pEnd_);
+    for (size_t i = 0; i + 1 < splits.size(); ++i)
+    {
+      if (size_t(splits[i + 1] - splits[i]) >= hasNewLines)
+        return;  // too far apart to split, so all is lexed here
+    }
+    for (size_t i = 0; i + 1 < splits.size(); ++i)
+    {
+      Chunk chunk;
+      chunk.pBegin = splits[i];
+      chunk.tokens = std::async(std::launch::async, &TableLexer::lexChunk, this, splits[i], splits[i + 1]);
+      chunks_.push_back(std::move(chunk));
+    }
+  }
+  //----< worker - find the end of every token in a chunk >--------
+
+  TableLexer::ChunkTokens TableLexer::lexChunk(const char* pBegin, const char* pEnd)
+  {
+    ChunkTokens chunk;
+    chunk.ends.reserve((pEnd - pBegin) / 4);
+    TableLexer lexer(punctuators_);
+    lexer.attach(pBegin, pEnd);
+    lexer.pScanners_ = pScanners_;
+    const char* p = pBegin;
+    while (p != pEnd && !cancel_.load(std::memory_order_relaxed))
+    {
+      size_t lineCount = lexer.lineCount_;
+      p = lexer.scan(p, chunk.unterminated);
+      uint32_t end = uint32_t(p - pBegin);
+      if (lexer.lineCount_ != lineCount)
+        end |= hasNewLines;
+      chunk.ends.push_back(end);
+    }
+    return chunk;
+  }
+  //----< wait for the next chunk's token ends >-------------------
+
+  void TableLexer::takeChunk()
+  {
+    Chunk& chunk = chunks_[nextChunk_++];
+    chunkTokens_ = chunk.tokens.get();
+    pChunk_ = chunk.pBegin;
+    nextToken_ = 0;
+  }
+
+  //----< initialize special tokens from the defaults >------------
+  /*
+   *  - the default table is built at compile time
+   */
+  TokenState::TokenState()
+  {
+    static constexpr PunctuatorTable defaultTable =
+      makePunctuatorTable(defaultOneCharTokens, defaultTwoCharTokens);
+    punctuators_ = defaultTable;
+
+    std::unordered_set<std::string> oneTemp;
+    for (const char* p = defaultOneCharTokens; *p != '\0'; ++p)
+      oneTemp.insert(std::string(1, *p));
+    oneCharTokens_(oneTemp);
+
+    std::unordered_set<std::string> twoTemp;
+    for (const char* p = defaultTwoCharTokens; p[0] != '\0' && p[1] != '\0'; p += 2)
+      twoTemp.insert(std::string(p, 2));
     twoCharTokens_(twoTemp);
   }
+  //----< make lookup table agree with token sets >----------------
+
+  void ITokenState::rebuildPunctuators()
+  {
+    punctuators_.clear();
+    for (const std::string& tok : oneCharTokens_())
+      punctuators_.addOne((unsigned char)tok[0]);
+    for (const std::string& tok : twoCharTokens_())
+      punctuators_.addTwo((unsigned char)tok[0], (unsigned char)tok[1]);
+  }
 
   void TokenState::setContext(TokenContext* pContext)
   {
@@ -173,7 +647,12 @@ namespace Lexer
 
   bool TokenState::oneCharTokensContains(const std::string& tok)
   {
-    return oneCharTokens().find(tok) != oneCharTokens().end();
+    return tok.size() == 1 && punctuators_.hasOne((unsigned char)tok[0]);
+  }
+
+  bool TokenState::oneCharTokensContains(int ch)
+  {
+    return punctuators_.hasOne((unsigned char)ch);
   }
   //----< return set of twoCharTokens >----------------------------
 
@@ -185,22 +664,30 @@ namespace Lexer
 
   bool TokenState::twoCharTokensContains(const std::string& tok)
   {
-    return twoCharTokens().find(tok) != twoCharTokens().end();
+    return tok.size() == 2 && punctuators_.hasTwo((unsigned char)tok[0], (unsigned char)tok[1]);
+  }
+
+  bool TokenState::twoCharTokensContains(int ch0, int ch1)
+  {
+    return punctuators_.hasTwo((unsigned char)ch0, (unsigned char)ch1);
   }
   //----< add token to special one char tokens >-------------------
 
   bool TokenState::addOneCharToken(const std::string& oneCharTok)
   {
-    if (oneCharTok.size() > 1)
+    if (oneCharTok.size() != 1)
       return false;
     oneCharTokens_.ref().insert(oneCharTok);
+    punctuators_.addOne((unsigned char)oneCharTok[0]);
     return true;
   }
   //----< remove token from special one char tokens >--------------
 
   bool TokenState::removeOneCharToken(const std::string& oneCharTok)
   {
-    return oneCharTokens_.ref().erase(oneCharTok);
+    bool removed = oneCharTokens_.ref().erase(oneCharTok) > 0;
+    rebuildPunctuators();
+    return removed;
   }
   //----< add token to special two char tokens >-------------------
 
@@ -209,13 +696,16 @@ namespace Lexer
     if (twoCharTok.size() != 2)
       return false;
     twoCharTokens_.ref().insert(twoCharTok);
+    punctuators_.addTwo((unsigned char)twoCharTok[0], (unsigned char)twoCharTok[1]);
     return true;
   }
   //----< remove token from special two char tokens >--------------
 
   bool TokenState::removeTwoCharToken(const std::string& twoCharTok)
   {
-    return twoCharTokens_.ref().erase(twoCharTok);
+    bool removed = twoCharTokens_.ref().erase(twoCharTok) > 0;
+    rebuildPunctuators();
+    return removed;
   }
   //----< delegate source opening to context's src >---------------
 
@@ -287,6 +777,8 @@ namespace Lexer
 
   bool TokenState::isPunctuation()
   {
+    if (pContext_->pSrc_->peek() < 0)  // end of file, which (char) would make 0xFF
+      return false;
     bool test = isWhiteSpace() || isNewLine() || isAlphaNum();
     test = test || isSingleLineComment() || isMultiLineComment();
     test = test || isSingleQuote() || isDoubleQuote();
@@ -365,31 +857,46 @@ namespace Lexer
 
   //----< initialize state machine >-------------------------------
 
+  const size_t Toker::defaultParallelThreshold;
+
   Toker::Toker()
   {
     pContext_ = new TokenContext();
     ITokenState::setContext(pContext_);
+    pLexer_ = new TableLexer(pContext_->pPunctuationState_->punctuators());
     doReturnComments(false);
+    doReturnWhiteSpace(false);
+    useStates(false);
+    parallelThreshold(defaultParallelThreshold);
+    parallelChunks(0);
   }
 
   Toker::~Toker()
   {
     //std::cout << "\n  toker destroyed";
+    delete pLexer_;
     delete pContext_;
   }
   //----< attempt to open source of tokens >-----------------------
   /*
-   * If src is successfully opened, it uses TokenState.nextState(context_)
+   * Toker reads through its TableLexer unless useStates is set.  Then,
+   * if src is successfully opened, it uses TokenState.nextState(context_)
    * to set the initial state, based on the source content.
+   * The states share one context per thread, so it is made ours first,
+   * in case another Toker has been created since this one.
    */
   bool Toker::open(const std::string& path)
   {
+    if (!useStates())
+      return pLexer_->open(path, parallelThreshold(), parallelChunks());
+    ITokenState::setContext(pContext_);
     return pContext_->pSrc_->open(path);  // if true, src has set initial state
   }
   //----< close source of tokens >---------------------------------
 
   void Toker::close()
   {
+    pLexer_->close();
     pContext_->pSrc_->close();
   }
   //----< extract a single token from TokenSource >----------------
@@ -397,12 +904,13 @@ namespace Lexer
    * Method promises to:
    * - extract all the text for a single token
    * - leave all the text for the next token in the TokenSource
-   * - discard all whitespace except for newlines
+   * - discard all whitespace except for newlines, unless doReturnWhiteSpace
+   *   is true
    * - discard all comments unless doReturnComments is true
    */
-  bool Toker::overwrite(Token tok)
+  bool Toker::overwrite(const Token& tok)
   {
-    if (isWhiteSpace(tok))
+    if (!doReturnWhiteSpace() && isWhiteSpace(tok))
       return true;
     if (!doReturnComments() && ((isSingleLineComment(tok) || isMultipleLineComment(tok))))
       return true;
@@ -415,6 +923,15 @@ namespace Lexer
   Token Toker::getTok()
   {
     Token tok;
+    if (!useStates())
+    {
+      while (pLexer_->next(tok))
+      {
+        if (!overwrite(tok))
+          break;
+      }
+      return tok;
+    }
     while (!isDone())
     {
       tok = pContext_->pCurrentState_->getTok();
@@ -428,25 +945,35 @@ namespace Lexer
 
   bool Toker::isDone()
   {
+    if (!useStates())
+      return pLexer_->isDone();
     if (pContext_->pCurrentState_ == nullptr)
       return true;
     return pContext_->pCurrentState_->isDone();
   }
   //----< return number of newlines encountered in file >----------
 
-  int Toker::lineCount() { return int(pContext_->pSrc_->lineCount()); }
+  int Toker::lineCount()
+  {
+    if (!useStates())
+      return int(pLexer_->lineCount());
+    return int(pContext_->pSrc_->lineCount());
+  }
 
   //----< return set of oneCharTokens >----------------------------
-
-  Property<std::unordered_set<std::string>>& Toker::oneCharTokens()
+  /*
+   * Change the set with add and remove functions, below, so that the
+   * punctuation state's lookup table is rebuilt.
+   */
+  FastProperty<std::unordered_set<std::string>>& Toker::oneCharTokens()
   {
-    return pContext_->pCurrentState_->oneCharTokens_;
+    return pContext_->pPunctuationState_->oneCharTokens_;
   }
   //----< return set of twoCharTokens >----------------------------
 
-  Property<std::unordered_set<std::string>>& Toker::twoCharTokens()
+  FastProperty<std::unordered_set<std::string>>& Toker::twoCharTokens()
   {
-    return pContext_->pCurrentState_->twoCharTokens_;
+    return pContext_->pPunctuationState_->twoCharTokens_;
   }
   //----< add token to special one char tokens >-------------------
 
@@ -454,14 +981,19 @@ namespace Lexer
   {
     if (oneCharTok.size() != 1)
       return false;
-    pContext_->pCurrentState_->oneCharTokens_.ref().insert(oneCharTok);
+    ITokenState* pState = pContext_->pPunctuationState_;
+    pState->oneCharTokens_.ref().insert(oneCharTok);
+    pState->rebuildPunctuators();
     return true;
   }
   //----< remove token from special one char tokens >--------------
 
   bool Toker::removeOneCharToken(const std::string& oneCharTok)
   {
-    return pContext_->pCurrentState_->oneCharTokens_.ref().erase(oneCharTok);
+    ITokenState* pState = pContext_->pPunctuationState_;
+    bool removed = pState->oneCharTokens_.ref().erase(oneCharTok) > 0;
+    pState->rebuildPunctuators();
+    return removed;
   }
   //----< add token to special two char tokens >-------------------
 
@@ -469,18 +1001,23 @@ namespace Lexer
   {
     if (twoCharTok.size() != 2)
       return false;
-    pContext_->pCurrentState_->twoCharTokens_.ref().insert(twoCharTok);
+    ITokenState* pState = pContext_->pPunctuationState_;
+    pState->twoCharTokens_.ref().insert(twoCharTok);
+    pState->rebuildPunctuators();
     return true;
   }
   //----< remove token from special two char tokens >--------------
 
   bool Toker::removeTwoCharToken(const std::string& twoCharTok)
   {
-    return pContext_->pCurrentState_->twoCharTokens_.ref().erase(twoCharTok);
+    ITokenState* pState = pContext_->pPunctuationState_;
+    bool removed = pState->twoCharTokens_.ref().erase(twoCharTok) > 0;
+    pState->rebuildPunctuators();
+    return removed;
   }
   //----< is this token whitespace? >------------------------------
 
-  bool Toker::isWhiteSpace(Token tok)
+  bool Toker::isWhiteSpace(const Token& tok)
   {
     if (tok.size() == 0)
       return false;
@@ -488,7 +1025,7 @@ namespace Lexer
   }
   //----< is this token a newline? >-------------------------------
 
-  bool Toker::isNewLine(Token tok)
+  bool Toker::isNewLine(const Token& tok)
   {
     if (tok.size() == 0)
       return false;
@@ -496,7 +1033,7 @@ namespace Lexer
   }
   //----< is this token alphanumeric? >----------------------------
 
-  bool Toker::isAlphaNum(Token tok)
+  bool Toker::isAlphaNum(const Token& tok)
   {
     if (tok.size() == 0)
       return false;
@@ -504,7 +1041,7 @@ namespace Lexer
   }
   //----< is this token punctuator? >------------------------------
 
-  bool Toker::isPunctuator(Token tok)
+  bool Toker::isPunctuator(const Token& tok)
   {
     if (tok.size() == 0)
       return false;
@@ -515,7 +1052,7 @@ namespace Lexer
   }
   //----< is this token a single line comment? >-------------------
 
-  bool Toker::isSingleLineComment(Token tok)
+  bool Toker::isSingleLineComment(const Token& tok)
   {
     if (tok.size() < 2)
       return false;
@@ -525,7 +1062,7 @@ namespace Lexer
   }
   //----< is this token a multiple line comment? >-----------------
 
-  bool Toker::isMultipleLineComment(Token tok)
+  bool Toker::isMultipleLineComment(const Token& tok)
   {
     if (tok.size() < 2)
       return false;
@@ -535,7 +1072,7 @@ namespace Lexer
   }
   //----< is this token a double quoted string? >------------------
 
-  bool Toker::isDoubleQuote(Token tok)
+  bool Toker::isDoubleQuote(const Token& tok)
   {
     if (tok.size() == 0)
       return false;
@@ -549,7 +1086,7 @@ namespace Lexer
   }
   //----< is this token a single-quoted character? >---------------
 
-  bool Toker::isSingleQuote(Token tok)
+  bool Toker::isSingleQuote(const Token& tok)
   {
     if (tok.size() == 0)
       return false;
@@ -559,6 +1096,12 @@ namespace Lexer
 
 #ifdef TEST_TOKER
 
+#include <vector>
+#include <utility>
+#include <chrono>
+#include <fstream>
+#include <cstdio>
+
 using namespace Lexer;
 
 class DemoToker
@@ -631,8 +1174,191 @@ public:
   }
 };
 
-int main()
+//----< tokens and line counts from one of the two lexers >--------
+
+std::vector<std::pair<Token, int>> collect(const std::string& path, bool useStates, size_t chunks = 0)
+{
+  std::vector<std::pair<Token, int>> toks;
+  Toker toker;
+  toker.useStates(useStates);
+  toker.parallelThreshold(chunks > 1 ? 1 : 0);
+  toker.parallelChunks(chunks);
+  toker.doReturnComments(true);
+  toker.doReturnWhiteSpace(true);
+  if (!toker.open(path))
+    return toks;
+  while (!toker.isDone())
+  {
+    Token tok = toker.getTok();
+    toks.push_back(std::make_pair(tok, toker.lineCount()));
+  }
+  return toks;
+}
+//----< does the file start with a UTF-16 byte order mark? >-------
+
+bool isUtf16(const std::string& path)
+{
+  std::ifstream in(path, std::ios::binary);
+  int first = in.get();
+  int second = in.get();
+  return (first == 0xFF && second == 0xFE) || (first == 0xFE && second == 0xFF);
+}
+//----< time getTok over all files, with states or TableLexer >----
+
+double nsPerToken(int argc, char* argv[], bool useStates, size_t chunks = 0)
+{
+  const int reps = 20;
+  size_t count = 0;
+  std::chrono::duration<double, std::nano> ns(0);
+  for (int rep = 0; rep < reps; ++rep)
+  {
+    for (int i = 1; i < argc; ++i)
+    {
+      Toker toker;
+      toker.useStates(useStates);
+      toker.parallelThreshold(chunks > 1 ? 1 : 0);
+      toker.parallelChunks(chunks);
+      toker.doReturnComments(true);
+      if (!toker.open(argv[i]))
+        continue;
+      auto start = std::chrono::steady_clock::now();
+      while (!toker.isDone())
+      {
+        toker.getTok();
+        ++count;
+      }
+      ns += std::chrono::steady_clock::now() - start;
+    }
+  }
+  return count == 0 ? 0.0 : ns.count() / count;
+}
+//----< compare TableLexer with the states, then time them >-------
+/*
+ * Usage: Toker file1 file2 ...
+ * - TableLexer is run with each level of RunScanners the CPU has, and
+ *   then with every file of two or more minChunkSize split into chunks
+ * - any file may be given, UTF-16 ones and files ending mid token
+ *   included, and all are compared; the UTF-16 ones are counted
+ */
+int compareLexers(int argc, char* argv[])
+{
+  std::vector<std::vector<std::pair<Token, int>>> expected;
+  size_t tokens = 0, utf16 = 0, mismatches = 0;
+  for (int i = 1; i < argc; ++i)
+  {
+    expected.push_back(collect(argv[i], true));
+    tokens += expected.back().size();
+    utf16 += isUtf16(argv[i]) ? 1 : 0;
+  }
+  double ns = nsPerToken(argc, argv, true);
+  std::cout << "\n\n  states:           " << ns << " ns per token";
+
+  for (int level = 0; level <= int(bestSimdLevel()); ++level)
+  {
+    selectRunScanners(SimdLevel(level));
+    for (int i = 1; i < argc; ++i)
+    {
+      if (collect(argv[i], false) != expected[i - 1])
+      {
+        ++mismatches;
+        std::cout << "\n  token streams differ for " << argv[i] << " with "
+          << simdLevelName(SimdLevel(level)) << " scanners";
+      }
+    }
+    ns = nsPerToken(argc, argv, false);
+    std::cout << "\n  TableLexer, " << std::setw(6) << std::left << simdLevelName(SimdLevel(level))
+      << std::right << ": " << ns << " ns per token";
+  }
+  selectRunScanners(bestSimdLevel());
+
+  const size_t chunks = std::max<size_t>(4, std::thread::hardware_concurrency());
+  for (int i = 1; i < argc; ++i)
+  {
+    if (collect(argv[i], false, chunks) != expected[i - 1])
+    {
+      ++mismatches;
+      std::cout << "\n  token streams differ for " << argv[i] << " lexed in chunks";
+    }
+  }
+  ns = nsPerToken(argc, argv, false, chunks);
+  std::cout << "\n  TableLexer, " << chunks << " chunks: " << ns << " ns per token";
+
+  std::cout << "\n\n  compared " << tokens << " tokens in " << argc - 1
+    << " files, " << utf16 << " of them UTF-16, at each level, " << mismatches << " differences\n\n";
+  return mismatches == 0 ? 0 : 1;
+}
+
+//----< both lexers finish text that stops in the middle of a token >
+/*
+ * - a NUL, a punctuator, or an open quote or comment at end of file
+ *   must end the token stream, with the same tokens from each lexer
+ */
+bool testEndOfFile()
+{
+  const std::string cases[] = {
+    std::string("a\n\0", 3), "a +", "s = \"open", "c = 'x", "/* open"
+  };
+  const std::string path = "TokerEndOfFile.txt";
+  bool ok = true;
+  std::cout << "\n\n  Demonstrating end of file in the middle of a token";
+  for (const auto& text : cases)
+  {
+    std::ofstream(path, std::ios::binary) << text;
+    std::vector<std::pair<Token, int>> states = collect(path, true);
+    bool same = (states == collect(path, false));
+    ok = ok && same;
+    std::cout << "\n  " << states.size() << " tokens, " << (same ? "same" : "DIFFERENT")
+      << " from TableLexer, for " << text.size() << " chars ending with " << int(text.back());
+  }
+  std::remove(path.c_str());
+  std::cout << "\n";
+  return ok;
+}
+
+//----< a file truncated while it is lexed ends the token stream >-
+/*
+ *  an editor may rewrite a file in place while the publisher lexes it;
+ *  the tokens read before are kept and the rest are lost, no fault
+ */
+bool testTruncation()
+{
+  const std::string path = "TokerTruncated.txt";
+  std::cout << "\n\n  Demonstrating a file truncated while it is lexed";
+  bool ok = true;
+  for (bool useStates : { false, true })
+  {
+    {
+      std::ofstream out(path, std::ios::binary);
+      for (size_t i = 0; i < 5 * 1024 * 1024 / 16; ++i)
+        out << "int x" << i % 100000 << " = 0;\n";
+    }
+    Toker toker;
+    toker.useStates(useStates);
+    if (!toker.open(path))
+      return false;
+    size_t count = 0;
+    for (; count < 10 && !toker.isDone(); ++count)
+      toker.getTok();
+    std::ofstream(path, std::ios::binary | std::ios::trunc).close();
+    while (!toker.isDone())
+    {
+      toker.getTok();
+      ++count;
+    }
+    ok = ok && count > 10;
+    std::cout << "\n  " << (useStates ? "states:     " : "TableLexer: ") << count
+      << " tokens, lexed to the end of the text read";
+  }
+  std::remove(path.c_str());
+  std::cout << "\n";
+  return ok;
+}
+
+int main(int argc, char* argv[])
 {
+  if (argc > 1)
+    return compareLexers(argc, argv);
+
   std::cout << "\n  Demonstrate Toker class";
   std::cout << "\n =========================";
 
@@ -651,8 +1377,11 @@ int main()
 
   DemoToker::testTokerWithComments("../Tokenizer/Toker.h");
   DemoToker::testTokerWithoutComments("../Tokenizer/Toker.cpp");
+  bool ok = testEndOfFile();
+  ok = testTruncation() && ok;
 
   std::cout << "\n\n";
+  return ok ? 0 : 1;
 }
 
 #endif
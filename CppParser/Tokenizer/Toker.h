@@ -2,29 +2,81 @@
 #define TOKER_H
 /////////////////////////////////////////////////////////////////////
 // Toker.h - Collects words from a stream                          //
-// ver 1.1                                                         //
+// ver 2.0                                                         //
 // Jim Fawcett, CSE687 - Object Oriented Design, Spring 2019       //
 /////////////////////////////////////////////////////////////////////
 /*
  * Package Operations:
  * -------------------
- * This tokenizer is implemented with the State Pattern, and:
+ * This tokenizer is implemented with the State Pattern, and with an
+ * equivalent table-driven lexer, TableLexer, which Toker uses by default:
  * - Collects words, called tokens, from a stream.  
  * - Discards all whitespace except for newlines which are returned as
  *   single character tokens.
  * - By default, collects and discards all comments, but has an option
  *   to return each comment as a single token.  
+ * - Also has an option to return whitespace tokens, so that a client,
+ *   like a syntax highlighter, can reproduce the source text exactly.
  * - Also returns quoted strings and quoted characters as tokens.
  *   Toker correctly handles the C# string @"...".
  * - This package demonstrates how to build a tokenizer based on the 
- *   State Pattern.  
+ *   State Pattern.  The states are kept as the reference TableLexer is
+ *   tested against, and are used when Toker::useStates is set.
+ * - Files of Toker::parallelThreshold bytes or more, 16 MB by default,
+ *   are lexed in parallelChunks chunks, by default one for each hardware
+ *   thread.  Only these are mapped into memory; if another process
+ *   truncates one while it is lexed, reading the lost pages faults, so
+ *   keep the threshold above the size of files edited in place.
   * 
  * Required Files:
  * ---------------
- * Toker.h, Toker.cpp
+ * Toker.h, Toker.cpp, RunScanners.h, RunScanners.cpp,
+ * FileSystem.h, FileSystem.cpp
  * 
  * Maintenance History
  * -------------------
+ * ver 2.0 : 19 Oct 2026
+ * - files are read into a buffer, not mapped, except those TableLexer
+ *   lexes in parallel, so a file an editor truncates while it is lexed
+ *   ends early instead of faulting
+ * ver 1.9 : 19 Oct 2026
+ * - the states end a punctuator run or a quote at end of file, as
+ *   TableLexer does; a NUL or open quote there made them loop forever
+ * ver 1.8 : 19 Oct 2026
+ * - files of at least Toker::parallelThreshold bytes are split at
+ *   newlines outside comments and quotes, found by a fast pre-scan,
+ *   and the pieces are lexed on worker threads; getTok returns the
+ *   same tokens and line counts as when lexed on one thread
+ * ver 1.7 : 19 Oct 2026
+ * - TableLexer finds the end of identifiers, whitespace, and comments
+ *   with the RunScanners package, which uses SSE2 or AVX2 if the CPU
+ *   has them
+ * ver 1.6 : 19 Oct 2026
+ * - added TableLexer, which classifies chars with a 256 entry table
+ *   built at compile time and scans each token in one loop over the
+ *   mapped file; Toker uses it unless useStates is set
+ * - test stub compares the two token streams over files named on the
+ *   command line and times them
+ * ver 1.5 : 19 Oct 2026
+ * - the states' shared context is per thread, and Toker::open makes its
+ *   own context current and restarts the line count, so a Toker can be
+ *   reused for many files after other Tokers have been created
+ * ver 1.4 : 19 Oct 2026
+ * - TokenSourceFile reads from a FileSystem::FileView, mapped from the
+ *   source file, instead of getting one char at a time from an ifstream
+ * ver 1.3 : 19 Oct 2026
+ * - special one and two char tokens are looked up in PunctuatorTable
+ *   bitmaps, built at compile time for the defaults and rebuilt from
+ *   the token sets when tokens are added or removed
+ * - Toker's special token functions now act on the punctuation state,
+ *   the only state that uses them, instead of the current state
+ * ver 1.2 : 19 Oct 2026
+ * - added doReturnWhiteSpace option, used by the code publisher to
+ *   highlight source directly from the token stream
+ * - fixed loss of the last character of files without a final newline
+ *   and of the first punctuator after a UTF-8 byte order mark
+ * - hot fields, lineCount, the special token sets and the return options,
+ *   are now FastProperty, so accessing them is not a virtual call
  * ver 1.1 : 27 Feb 2019
  * - fixed bugs in toker by checking for end-of-file in getTok() function
  *   in SingleLineCommentState and MultiLineCommentState
@@ -36,10 +88,15 @@
 #include <iostream>
 #include <string>
 #include <deque>
+#include <vector>
+#include <future>
+#include <atomic>
 #include <unordered_set>
 #include <cctype>
 #include <locale>
+#include <cstdint>
 #include "../CppProperties/Properties.h"
+#include "../FileSystem/FileSystem.h"
 
 using namespace Utilities;
 using Token = std::string;
@@ -48,6 +105,62 @@ namespace Lexer
 {
   const std::locale loc;
 
+  // default special tokens: each char of the first string is a token,
+  // and each successive pair of chars of the second string is a token
+
+  constexpr const char* defaultOneCharTokens = "<>[](){}.;=+-*";
+  constexpr const char* defaultTwoCharTokens = "<<>>::++--==+=-=*=/=&&||";
+
+  ///////////////////////////////////////////////////////////////////
+  // PunctuatorTable class
+  // - bitmaps for special one char and two char tokens
+  // - one bit for each of the 256 chars and each of the 64K char pairs,
+  //   so a lookup is a shift and mask, with no string built or hashed
+
+  class PunctuatorTable
+  {
+  public:
+    constexpr PunctuatorTable() : one_(), two_() {}
+
+    constexpr void addOne(unsigned char ch)
+    {
+      one_[ch >> 6] |= (uint64_t(1) << (ch & 63));
+    }
+    constexpr void addTwo(unsigned char ch0, unsigned char ch1)
+    {
+      size_t i = (size_t(ch0) << 8) | ch1;
+      two_[i >> 6] |= (uint64_t(1) << (i & 63));
+    }
+    constexpr bool hasOne(unsigned char ch) const
+    {
+      return (one_[ch >> 6] >> (ch & 63)) & 1;
+    }
+    constexpr bool hasTwo(unsigned char ch0, unsigned char ch1) const
+    {
+      size_t i = (size_t(ch0) << 8) | ch1;
+      return (two_[i >> 6] >> (i & 63)) & 1;
+    }
+    void clear()
+    {
+      *this = PunctuatorTable();
+    }
+  private:
+    uint64_t one_[4];
+    uint64_t two_[1024];
+  };
+
+  //----< build table from strings formatted like the defaults >-----
+
+  constexpr PunctuatorTable makePunctuatorTable(const char* oneChars, const char* twoChars)
+  {
+    PunctuatorTable table;
+    for (size_t i = 0; oneChars[i] != '\0'; ++i)
+      table.addOne((unsigned char)oneChars[i]);
+    for (size_t i = 0; twoChars[i] != '\0' && twoChars[i + 1] != '\0'; i += 2)
+      table.addTwo((unsigned char)twoChars[i], (unsigned char)twoChars[i + 1]);
+    return table;
+  }
+
   ///////////////////////////////////////////////////////////////////
   // ITokenSource interface
   // - Declares operations expected of any source of tokens
@@ -62,7 +175,7 @@ namespace Lexer
     virtual int next() = 0;
     virtual int peek(size_t n = 0) = 0;
     virtual bool end() = 0;
-    Property<size_t> lineCount;
+    FastProperty<size_t> lineCount;
   };
 
   ///////////////////////////////////////////////////////////////////
@@ -82,11 +195,14 @@ namespace Lexer
     virtual bool isPunctuation() = 0;
     virtual bool isDone() = 0;
     virtual ITokenState* nextState() = 0;
-    Property<std::unordered_set<std::string>> oneCharTokens_;
-    Property<std::unordered_set<std::string>> twoCharTokens_;
+    const PunctuatorTable& punctuators() const { return punctuators_; }
+    FastProperty<std::unordered_set<std::string>> oneCharTokens_;
+    FastProperty<std::unordered_set<std::string>> twoCharTokens_;
+    void rebuildPunctuators();  // call after changing the token sets
 
   protected:
-    static TokenContext* pContext_;  // derived classes store context ref here
+    PunctuatorTable punctuators_;
+    static thread_local TokenContext* pContext_;  // derived classes store context ref here
     TokenSourceFile* pSrc_ = nullptr;
   };
 
@@ -120,15 +236,18 @@ namespace Lexer
   // - Streams often use terminators that can't be represented by
   //   a character, so we collect all elements as ints
   // - keeps track of the line number where a token is found
-  // - uses StreamReader which correctly handles byte order mark
-  //   characters and alternate text encodings.
+  // - reads the file through a FileView, into one buffer, and skips a
+  //   UTF-8 byte order mark
 
   class TokenSourceFile : public ITokenSource
   {
   private:
-    std::ifstream fs_;            // physical source of text
+    FileSystem::FileView view_;   // physical source of text
+    const char* pNext_;           // next unread char in view_
     std::deque<int> charQ_;       // enqueing ints but using as chars
     TokenContext* pContext_;
+    void skipByteOrderMark();
+    int read();
 
   public:
     TokenSourceFile(TokenContext* pContext);
@@ -140,6 +259,82 @@ namespace Lexer
     bool end();
   };
 
+  struct RunScanners;
+
+  ///////////////////////////////////////////////////////////////////
+  // TableLexer class
+  // - collects the same tokens as the states, below, from a FileView,
+  //   mapped only when the file is large enough to lex in parallel
+  // - each char is classified by one lookup in a table built at compile
+  //   time, and a small transition table says which classes extend the
+  //   token being collected, so there are no virtual calls or peeks
+  // - identifiers, whitespace, and comments are scanned by RunScanners,
+  //   chosen for the CPU when the file is opened
+  // - uses the punctuation state's PunctuatorTable, so special tokens
+  //   added to the Toker apply here too
+  // - a file of parallelThreshold or more bytes is cut into chunks at
+  //   newlines that can't be inside a token, and every chunk after the
+  //   first is lexed by a worker thread into a list of token ends, while
+  //   the first is lexed as the client asks for tokens
+
+  class TableLexer
+  {
+  public:
+    TableLexer(const PunctuatorTable& punctuators);
+    TableLexer(const TableLexer&) = delete;
+    TableLexer& operator=(const TableLexer&) = delete;
+    ~TableLexer();
+    bool open(const std::string& path, size_t parallelThreshold = 0, size_t chunks = 0);
+    void close();
+    bool next(Token& tok);  // false, leaving tok unchanged, when done
+    bool isDone() const { return pNext_ == pEnd_; }
+    size_t lineCount() const { return lineCount_; }
+    size_t chunkCount() const { return chunks_.size() + 1; }
+
+    static const size_t minChunkSize = 4096;
+
+  private:
+    // token ends of one chunk, as offsets from its start, with the
+    // high bit set on tokens that hold newlines
+
+    struct ChunkTokens
+    {
+      std::vector<uint32_t> ends;
+      bool unterminated = false;  // last token is an unclosed comment
+    };
+    struct Chunk
+    {
+      const char* pBegin;
+      std::future<ChunkTokens> tokens;
+    };
+    static const uint32_t hasNewLines = 0x80000000;
+
+    void attach(const char* pBegin, const char* pEnd);
+    const char* scan(const char* p, bool& unterminated);
+    const char* scanPunctuation(const char* p);
+    const char* scanQuote(const char* p, char quote, bool verbatim);
+    bool canSplit() const;
+    std::vector<const char*> findSplits(size_t chunks);
+    void startChunks(size_t parallelThreshold, size_t chunks);
+    ChunkTokens lexChunk(const char* pBegin, const char* pEnd);
+    void takeChunk();
+
+    FileSystem::FileView view_;
+    std::string folded_;          // text with \r\n folded to \n, _WIN32 only
+    const char* pNext_ = nullptr;
+    const char* pEnd_ = nullptr;
+    size_t lineCount_ = 1;
+    const PunctuatorTable& punctuators_;
+    const RunScanners* pScanners_ = nullptr;
+
+    std::vector<Chunk> chunks_;   // chunks after the first, in order
+    size_t nextChunk_ = 0;
+    const char* pChunk_ = nullptr;     // start of chunk being returned
+    ChunkTokens chunkTokens_;
+    size_t nextToken_ = 0;
+    std::atomic<bool> cancel_{ false };  // tells workers to stop, on close
+  };
+
   ///////////////////////////////////////////////////////////////////
   // TokenState class
   // - base for all the tokenizer states
@@ -155,8 +350,10 @@ namespace Lexer
     static void setContext(TokenContext* pContext);
     std::unordered_set<std::string>& oneCharTokens();
     bool oneCharTokensContains(const std::string& tok);
+    bool oneCharTokensContains(int ch);
     std::unordered_set<std::string>& twoCharTokens();
     bool twoCharTokensContains(const std::string& tok);
+    bool twoCharTokensContains(int ch0, int ch1);
     bool addOneCharToken(const std::string& oneCharTok);
     bool removeOneCharToken(const std::string& oneCharTok);
     bool addTwoCharToken(const std::string& twoCharTok);
@@ -331,7 +528,10 @@ namespace Lexer
 
       while (true)
       {
-        char ch = (char)pContext_->pSrc_->next();
+        int next = pContext_->pSrc_->next();
+        if (next < 0)                 // unterminated at end of file
+          break;
+        char ch = (char)next;
         tok += ch;
         if (ch == '\'' && !isEscaped(tok))
           break;
@@ -358,7 +558,10 @@ namespace Lexer
 
       while (true)
       {
-        char ch = (char)pContext_->pSrc_->next();
+        int next = pContext_->pSrc_->next();
+        if (next < 0)                 // unterminated at end of file
+          break;
+        char ch = (char)next;
         tok += ch;
         if (ch == '\"' && (!isEscaped(tok) || tok[0] == '@'))
           break;
@@ -381,19 +584,18 @@ namespace Lexer
     virtual Token getTok() override
     {
       // is this a two char special token?
-      Token test;
-      test += (char)pContext_->pSrc_->peek();
-      test += (char)pContext_->pSrc_->peek(1);
-      if (twoCharTokensContains(test))
+      int ch0 = pContext_->pSrc_->peek();
+      int ch1 = pContext_->pSrc_->peek(1);
+      Token tok;
+      if (twoCharTokensContains(ch0, ch1))
       {
-        pContext_->pSrc_->next();  // pop peeked char
-        pContext_->pSrc_->next();  // pop peeked char
-        return test;
+        tok += (char)pContext_->pSrc_->next();  // pop peeked char
+        tok += (char)pContext_->pSrc_->next();  // pop peeked char
+        return tok;
       }
       // is this a single char special token?
-      Token tok;
       tok += (char)pContext_->pSrc_->next();       // pop first punctuator
-      if (oneCharTokensContains(tok))
+      if (oneCharTokensContains(ch0))
         return tok;
 
       // not special token, so continue collecting punctuation chars
@@ -418,32 +620,41 @@ namespace Lexer
   {
   private:
     TokenContext* pContext_ = nullptr;   // holds single instance of all states and token source
+    TableLexer* pLexer_ = nullptr;       // default source of tokens
 
   public:
-    Property<bool> doReturnComments;
+    FastProperty<bool> doReturnComments;
+    FastProperty<bool> doReturnWhiteSpace;
+    FastProperty<bool> useStates;        // set before open to tokenize with the states
+    FastProperty<size_t> parallelThreshold;  // files this size or larger are lexed on
+                                             // several threads, 0 for never
+    FastProperty<size_t> parallelChunks;     // most chunks per file, 0 for one per
+                                             // hardware thread
+
+    static const size_t defaultParallelThreshold = 16 * 1024 * 1024;
 
     Toker();
     ~Toker();
     bool open(const std::string& path);
     void close();
-    bool overwrite(Token tok);
+    bool overwrite(const Token& tok);
     Token getTok();
     bool isDone();
     int lineCount();
-    Property<std::unordered_set<std::string>>& oneCharTokens();
-    Property<std::unordered_set<std::string>>& twoCharTokens();
+    FastProperty<std::unordered_set<std::string>>& oneCharTokens();
+    FastProperty<std::unordered_set<std::string>>& twoCharTokens();
     bool addOneCharToken(const std::string& oneCharTok);
     bool removeOneCharToken(const std::string& oneCharTok);
     bool addTwoCharToken(const std::string& twoCharTok);
     bool removeTwoCharToken(const std::string& twoCharTok);
-    static bool isWhiteSpace(Token tok);
-    static bool isNewLine(Token tok);
-    static bool isAlphaNum(Token tok);
-    static bool isPunctuator(Token tok);
-    static bool isSingleLineComment(Token tok);
-    static bool isMultipleLineComment(Token tok);
-    static bool isDoubleQuote(Token tok);
-    static bool isSingleQuote(Token tok);
+    static bool isWhiteSpace(const Token& tok);
+    static bool isNewLine(const Token& tok);
+    static bool isAlphaNum(const Token& tok);
+    static bool isPunctuator(const Token& tok);
+    static bool isSingleLineComment(const Token& tok);
+    static bool isMultipleLineComment(const Token& tok);
+    static bool isDoubleQuote(const Token& tok);
+    static bool isSingleQuote(const Token& tok);
   };
 }
 #endif
@@ -1,6 +1,6 @@
 ///////////////////////////////////////////////////////////////////////////
 // DependencyTable.cpp : defines DependencyTable.h functions             //
-// ver 1.1                                                               //
+// ver 1.5                                                               //
 //                                                                       // 
 // Author:      Sneha Giranje					                         //
 ///////////////////////////////////////////////////////////////////////////
@@ -13,11 +13,17 @@
 #include "../CppParser/Parser/ConfigureParser.h"
 #include "../CppParser/Parser/ActionsAndRules.h"
 #include "../CppParser/Utilities/Utilities.h"
+#include "../CppParser/PerfStats/PerfStats.h"
 #define Util StringHelper
 
 using namespace CodeAnalysis;
 using namespace Utilities1;
 
+namespace
+{
+  const DependencyTable::graph emptyGraph;
+}
+
 // -----< default ctor >---------------------------------------------------
 DependencyTable::DependencyTable(){
   std::cout << "\n  Created instance of DependencyTable using default ctor\n";
@@ -28,8 +34,8 @@ DependencyTable::DependencyTable(){
 DependencyTable::DependencyTable(const files & list)
 {
 	std::cout << "\n  Created instance of DependencyTable given files list\n";
-  table_.reserve(list.size()); // improves performance 
-  for (auto file : list)
+  writableTable().reserve(list.size()); // improves performance 
+  for (const auto& file : list)
     getFileDependencies(file);
 }
 
@@ -38,96 +44,122 @@ DependencyTable::~DependencyTable(){
 	std::cout << "\n  Destroying DependencyTable instance";
 }
 
+// -----< private - graph to read, empty if there is none >---------------
+const DependencyTable::graph & DependencyTable::table() const
+{
+  return table_ ? *table_ : emptyGraph;
+}
+
+// -----< private - graph to change, copied first if it is shared >-------
+/* use_count may still count a copy another thread has just let go,
+   which costs only an unneeded copy of the graph */
+DependencyTable::graph & DependencyTable::writableTable()
+{
+  if (!table_)
+    table_ = std::make_shared<graph>();
+  else if (table_.use_count() > 1)
+    table_ = std::make_shared<graph>(*table_);
+  return *table_;
+}
+
 // -----< has function - searches map for given key >----------------------
-bool DependencyTable::has(const std::string & file)
+bool DependencyTable::has(const std::string & file) const
 {
-  return table_.find(file) != table_.end();
+  return table().find(file) != table().end();
 }
 
 // -----< add dependency function - adds filename to key's vector >--------
-void DependencyTable::addDependency(file filename, file dependency)
+void DependencyTable::addDependency(const file& filename, const file& dependency)
 {
 	std::cout << "\n  Adding dependency from " + filename + " to " + dependency;
   // this will create entry if key didnt exists in the map
-  DependencyTable::dependencies & deps = table_[filename]; 
+  DependencyTable::dependencies & deps = writableTable()[filename]; 
   auto dep = std::find(deps.begin(), deps.end(), dependency);
   if (dep == deps.end()) // don't add depndency if it already exists
     deps.push_back(dependency);
 }
 
 // -----< remove dependency function >-------------------------------------
-void DependencyTable::removeDependency(file filename, file dependency)
+void DependencyTable::removeDependency(const file& filename, const file& dependency)
 {
   std::cout << "\n  Removing dependency from " + filename + " to " + dependency;
-  DependencyTable::dependencies & deps = table_[filename];
+  DependencyTable::dependencies & deps = writableTable()[filename];
   auto dep = std::find(deps.begin(), deps.end(), dependency);
   if (dep != deps.end())
     deps.erase(dep);
 }
 
 // -----< remove entry - removes key/value pair from map >-----------------
-void DependencyTable::removeEntry(file filename)
+void DependencyTable::removeEntry(const file& filename)
 {
 	std::cout << "\n  Removing entry [" + filename + "] from dependency table";
-  auto entry = table_.find(filename);
-  if (entry != table_.end())
-    table_.erase(entry);
+  if (has(filename))
+    writableTable().erase(filename);
 }
 
 // -----< get key's dependencies >-----------------------------------------
-const DependencyTable::dependencies & DependencyTable::getDependencies(file filename) const
+const DependencyTable::dependencies & DependencyTable::getDependencies(const file& filename) const
 {
-  return table_.at(filename);
+  return table().at(filename);
 }
 
 // -----< operator [] to provide easier access >---------------------------
 const DependencyTable::dependencies & DependencyTable::operator[](const file & filename) const
 {
-  return table_.at(filename);
+  return table().at(filename);
+}
+
+// -----< collects files named by #include "file" >----------------------
+namespace
+{
+  class IncludeListener : public IParseListener
+  {
+  public:
+    IncludeListener(std::vector<std::string>& files) : files_(files) {}
+    void include(const std::string& file, bool isSystem, size_t /*line*/) override
+    {
+      if (!isSystem)
+        files_.push_back(file);
+    }
+  private:
+    std::vector<std::string>& files_;
+  };
 }
 
 // -----< extracts dependency and adds dependency to dependency table >---
-void DependencyTable::getFileDependencies(file filename)
+/* the parser streams includes to a listener, building no AST */
+void DependencyTable::getFileDependencies(const file& filename)
 {
+	PerfStats::Timer timer(PerfStats::dependencies, filename);
 	std::string fileSpec;
 	std::string name;
 	fileSpec = FileSystem::Path::getFullFileSpec(filename);
 	std::string msg = "Processing file: " + fileSpec;
 	Util::title(msg);
-	ConfigParseForCodeAnal configure;
-	Parser* pParser = configure.Build();
+	ParserPool::Lease lease = ParserPool::forThisThread().acquire();
+	Parser* pParser = lease->parser();
 
 	try{
 		if (pParser){
 			name = FileSystem::Path::getName(filename);
-			if (!configure.Attach(fileSpec))
+			if (!lease->Attach(fileSpec))
 				std::cout << "\n  could not open file " << name << std::endl;
 		}
 		else
 			std::cout << "\n\n  Parser not built\n\n";
-		Repository* pRepo = Repository::getInstance(); // save current package name
+		Repository* pRepo = lease->repository(); // save current package name
 		pRepo->package() = name;
+		std::vector<std::string> includes;
+		IncludeListener listener(includes);
+		pRepo->listener(&listener);
 		// parse the package
 		while (pParser->next())
 			pParser->parse();
+		pRepo->endOfFile();
 		std::cout << "\n";
-		// final AST operations
-		int count = 0;
-		ASTNode* pGlobalScope = pRepo->getGlobalScope();
-		auto itr = pGlobalScope->statements_.begin();
-		while (itr != pGlobalScope->statements_.end()){
-			std::string depFile = (*itr)->ToString();
-			int pos = depFile.find("\"");
-			if (pos >= 0) {
-				std::string dFile;
-				dFile = depFile.substr(pos + 1, depFile.length() - 1);
-				dFile.erase(std::remove(dFile.begin(), dFile.end(), '"'), dFile.end());
-				addDependency(filename, dFile);
-				count++;
-			}
-			itr++;
-		}
-		if (count == 0) {
+		for (const std::string& dFile : includes)
+			addDependency(filename, dFile);
+		if (includes.size() == 0) {
 			addDependency(filename, " ");
 			std::cout << "None. \nFile has no dependencies.\n";
 		}
@@ -138,33 +170,34 @@ void DependencyTable::getFileDependencies(file filename)
 }
 
 // -----< begin() iterator - allows for loop >-----------------------------
-DependencyTable::iterator DependencyTable::begin()
+DependencyTable::iterator DependencyTable::begin() const
 {
-  return table_.begin();
+  return table().begin();
 }
 
 // -----< end() iterator - allows for loop >-------------------------------
-DependencyTable::iterator DependencyTable::end()
+DependencyTable::iterator DependencyTable::end() const
 {
-  return table_.end();
+  return table().end();
 }
 
 // -----< get keys of map >------------------------------------------------
 DependencyTable::files DependencyTable::getFiles() const
 {
   files list;
-  for (auto entry : table_)
+  list.reserve(table().size());
+  for (const auto& entry : table())
     list.push_back(entry.first);
   return list;
 }
 
 // -----< display entire table in formatted way >--------------------------
-void DependencyTable::display()
+void DependencyTable::display() const
 {
 	std::cout << "\n  Dependency table:";
-  for (auto entry : table_) {
+  for (const auto& entry : table()) {
 	  std::cout << "\n  -- " << entry.first;
-    for (auto dep : entry.second)
+    for (const auto& dep : entry.second)
 	  std::cout << "\n   -> " << dep;
   }
 
@@ -1,7 +1,7 @@
 #pragma once
 ///////////////////////////////////////////////////////////////////////////
 // DependencyTable.h : defines dependency table structure                //
-// ver 1.1                                                               //
+// ver 1.5                                                               //
 //                                                                       // 
 // Author:      Sneha Giranje					                                   //
 ///////////////////////////////////////////////////////////////////////////
@@ -14,6 +14,11 @@
 *  value. Therefore, every file in the analysis will point to a vector
 *  of all the files it depends upon. 
 *
+*  The map is held as a shared graph that is never changed once another
+*  table shares it: copying a table, e.g., into CodeConverter, shares the
+*  graph, and the first change made through either copy works on a copy
+*  of its own.  Iteration is read-only.
+*
 *  Public Interface
 * =======================
 *  Dependency dt;
@@ -27,10 +32,22 @@
 *  Required Files:
 * =======================
 *  DependencyTable.h DependencyTable.cpp AbstrSynTree.h ConfigureParser.h
-*  ActionsAndRules.h Utilities.h Parser.h
+*  ActionsAndRules.h Utilities.h Parser.h PerfStats.h
 *
 *  Maintainence History:
 * =======================
+*  ver 1.5 - 19 Oct 2026
+*  - the map is a shared graph, copied only when a shared table is
+*    changed, so copies are cheap; tables can be moved, iteration is
+*    const and file names are taken by const reference
+*  ver 1.4 - 19 Oct 2026
+*  - getFileDependencies is timed as PerfStats' dependencies stage
+*  ver 1.3 - 19 Oct 2026
+*  - getFileDependencies takes #include "file" names streamed from the
+*    parser, rather than from preprocessor statements kept in the AST
+*  ver 1.2 - 19 Oct 2026
+*  - getFileDependencies leases a parser from the thread's ParserPool
+*    instead of building a new one for every file
 *  ver 1.1 - 27 Feb 2019
 *  - added functionality to fetch dependency from the headers of code and 
 *    add it to the dependency table of the file.
@@ -41,6 +58,7 @@
 #include <unordered_map>
 #include <string>
 #include <vector>
+#include <memory>
 
 class DependencyTable
 {
@@ -48,38 +66,46 @@ public:
   using file = std::string;
   using files = std::vector<file>;
   using dependencies = std::vector<file>;
-  using iterator = std::unordered_map<file, dependencies>::iterator;
+  using graph = std::unordered_map<file, dependencies>;
+  using iterator = graph::const_iterator;
 
 
   DependencyTable();
   DependencyTable(const files& list);
+  DependencyTable(const DependencyTable&) = default;  // shares the graph
+  DependencyTable(DependencyTable&&) = default;
+  DependencyTable& operator=(const DependencyTable&) = default;
+  DependencyTable& operator=(DependencyTable&&) = default;
   ~DependencyTable();
 
-  bool has(const std::string& file);
+  bool has(const std::string& file) const;
 
-  void addDependency(file filename, file dependency);
-  void removeDependency(file filename, file dependency);
+  void addDependency(const file& filename, const file& dependency);
+  void removeDependency(const file& filename, const file& dependency);
 
-  void removeEntry(file filename);
+  void removeEntry(const file& filename);
 
-  const dependencies& getDependencies(file filename) const;
+  const dependencies& getDependencies(const file& filename) const;
   const dependencies& operator[](const file& filename) const;
 
-  void getFileDependencies(file filename);
+  void getFileDependencies(const file& filename);
  
   // these two functions allow 'for' loops in the form of
-  // for(auto entry : dt) {...}
-  iterator begin();
-  iterator end();
+  // for(const auto& entry : dt) {...}
+  iterator begin() const;
+  iterator end() const;
   void clear() {
-	  table_.clear(); 
+	  table_.reset(); 
   }
 
   files getFiles() const;
 
-  void display();
+  void display() const;
 
 private:
-  std::unordered_map<file, dependencies> table_;
+  const graph& table() const;
+  graph& writableTable();
+
+  std::shared_ptr<graph> table_;  // shared by copies, never changed while shared
 };
 
@@ -1,6 +1,6 @@
 ///////////////////////////////////////////////////////////////////////////
 // Executive.cpp : Integrates all the code publisher functionalities     //                                           
-// ver 1.0                                                               //
+// ver 2.1                                                               //
 //                                                                       // 
 // Author:      Sneha Giranje					                         //
 ///////////////////////////////////////////////////////////////////////////
@@ -12,6 +12,25 @@
 *  CodePublisher. 
  Maintainence History:
 * =======================
+  ver 2.1 - 19 Oct 2026
+  --serve serves the pages' script from the output directory's parent
+  ver 2.0 - 19 Oct 2026
+  --publish stages its pages and swaps them into place with StagedOutput;
+    deleteExistingFiles only reclaims old generations
+  ver 1.9 - 19 Oct 2026
+  --Added /serve option and serve; watch's loop is watchSources
+  ver 1.8 - 19 Oct 2026
+  --Added /watch option and watch
+  ver 1.7 - 19 Oct 2026
+  --getConvertedFiles returns the converter's list, not a copy
+  ver 1.6 - 19 Oct 2026
+  --Added /memory option and writeMemory
+  ver 1.5 - 19 Oct 2026
+  --publish shows rule profiles in PROFILE_RULES builds
+  ver 1.4 - 19 Oct 2026
+  --Added /trace option
+  ver 1.3 - 19 Oct 2026
+  --Added /stats option and writeStats
   ver 1.2 - 15 April 2019
   --Added methods to demonstate the project3 requirements
 *
@@ -20,6 +39,14 @@
 */
 
 #include "Executive.h"
+#include <fstream>
+#include <regex>
+#include <unordered_set>
+#include <chrono>
+#include <algorithm>
+#ifdef PROFILE_RULES
+#include "../CppParser/Parser/Parser.h"
+#endif
 
 using namespace Utilitiess;
 using namespace FileSystem;
@@ -47,6 +74,14 @@ bool Executive::processCommandLineArgs(int argc, char ** argv)
 		return false;
 	}
 	dirIn_ = pcl_->path();
+	if (pcl_->hasOption("stats"))
+		PerfStats::enable();
+	if (pcl_->hasOption("trace"))
+		PerfStats::TraceRecorder::instance().start(cconv_.outputDir() + "trace.json");
+	if (pcl_->hasOption("memory"))
+		PerfStats::trackMemory();
+	if (pcl_->hasOption("watch"))
+		cconv_.keepIdentifiers();
 	return true;
 }
 
@@ -61,6 +96,8 @@ void Executive::outputDirectory(const std::string & dir)
 {
 	dirOut_ = dir;
 	cconv_.outputDir(dir);
+	if (PerfStats::tracing())
+		PerfStats::TraceRecorder::instance().path(dir + "trace.json");
 }
 
 // -----< return output directory >--------------------------------------
@@ -72,9 +109,10 @@ const std::string & Executive::outputDirectory() const
 // -----< extract files - after processing cmd >-------------------------
 bool Executive::extractFiles()
 {
+	PerfStats::Timer timer(PerfStats::extract);
 	Loader ld(pcl_->path());
 
-	for (auto patt : pcl_->patterns())
+	for (const auto& patt : pcl_->patterns())
 	{
 		ld.addPattern(patt);
 	}
@@ -89,17 +127,37 @@ bool Executive::extractFiles()
 
 	files_ = ld.filesList();
 
+	if (timer.running())
+	{
+		size_t bytes = 0;
+		for (auto& file : files_)
+			bytes += PerfStats::fileSize(file);
+		timer.files(files_.size());
+		timer.bytes(bytes);
+		PerfStats::Counters::instance().input(files_.size(), bytes);
+	}
 	return res;
 }
 
 
 // -----< publish - files extracted from directory explorer >---------------
+/* pages, and the stats and memory reports, are written to a staging
+  directory that then replaces the output directory as a whole */
 void Executive::publish()
 {
-	convertedFiles_ = cconv_.convert(files_);
+	std::string live = beginStaging();
+	cconv_.convert(files_);
+	if (PerfStats::enabled())
+		writeStats(cconv_.outputDir() + "stats.json");
+	if (PerfStats::trackingMemory())
+		writeMemory(cconv_.outputDir() + "memory.json");
+	commitStaging(live);
+#ifdef PROFILE_RULES
+	CodeAnalysis::Parser::showRuleProfiles();
+#endif
 }
 
-// -----< publish - single file >-------------------------------------------
+// -----< publish - single file, written in place >------------------------
 void Executive::publish(const std::string & file)
 {
 	display_.display(cconv_.convert(file));
@@ -108,7 +166,40 @@ void Executive::publish(const std::string & file)
 // -----< publish - must provide list >-------------------------------------
 void Executive::publish(const std::vector<std::string>& files)
 {
-	display_.display(cconv_.convert(files));
+	std::string live = beginStaging();
+	cconv_.convert(files);
+	commitStaging(live);
+	display_.display(cconv_.convertedFiles());
+}
+
+// -----< private - next pages go to a new generation of the output >------
+/* returns the output directory. If no staging directory can be made
+  the pages are written in place, as before */
+std::string Executive::beginStaging()
+{
+	std::string live = cconv_.outputDir();
+	std::string staging = stage_.begin(live);
+	if (staging.size() > 0)
+		cconv_.outputDir(staging);
+	else
+		std::cout << "\n  Error -- unable to make a staging directory beside " << live << ", publishing in place";
+	return live;
+}
+
+// -----< private - staged pages replace the output directory >------------
+/* if the swap fails the output directory is left as it was, and the
+  pages stay in the staging directory until the next publish */
+void Executive::commitStaging(const std::string& live)
+{
+	if (stage_.staging().size() == 0)
+		return;
+	if (stage_.commit())
+	{
+		cconv_.outputMoved(live);
+		return;
+	}
+	std::cout << "\n  Error -- unable to replace " << live << ", the pages are in " << stage_.staging();
+	cconv_.outputDir(live);
 }
 
 // -----< gets display mode as set by PCL >---------------------------------
@@ -117,8 +208,198 @@ Utilitiess::DisplayMode Executive::displayMode() const
 	return pcl_->displayMode();
 }
 
-std::vector<std::string> Executive::getConvertedFiles() {
-	return convertedFiles_;
+// -----< pages written by the last conversion >---------------------------
+const std::vector<std::string>& Executive::getConvertedFiles() {
+	return cconv_.convertedFiles();
+}
+
+// -----< write PerfStats report as JSON >----------------------------------
+bool Executive::writeStats(const std::string & path)
+{
+	std::ofstream out(path);
+	if (!out.good())
+	{
+		std::cout << "\n  Error -- unable to write stats to " << path;
+		return false;
+	}
+	PerfStats::Counters::instance().writeJson(out);
+	std::cout << "\n  Stats written to: " << Path::getFullFileSpec(path) << "\n";
+	return true;
+}
+
+// -----< write MemStats report as JSON >----------------------------------
+bool Executive::writeMemory(const std::string & path)
+{
+	std::ofstream out(path);
+	if (!out.good())
+	{
+		std::cout << "\n  Error -- unable to write memory report to " << path;
+		return false;
+	}
+	PerfStats::MemStats::instance().writeJson(out);
+	std::cout << "\n  Memory report written to: " << Path::getFullFileSpec(path) << "\n";
+	return true;
+}
+
+// -----< was /watch given? >---------------------------------------------
+bool Executive::watchRequested() const
+{
+	return pcl_->hasOption("watch");
+}
+
+// -----< republish the pages changed sources affect, until killed >-------
+/* events lost by the watcher start a full publish again */
+void Executive::watch()
+{
+	using Clock = FileWatcher::Clock;
+	auto republish = [&](const std::vector<std::string>& changed, const std::vector<std::string>& removed,
+		Clock::time_point firstChange) {
+		Clock::time_point start = Clock::now();
+		std::vector<std::string> pages = cconv_.update(changed, removed);
+
+		Clock::time_point end = Clock::now();
+		auto ms = [](Clock::duration span) {
+			return std::chrono::duration_cast<std::chrono::microseconds>(span).count() / 1000.0;
+		};
+		std::cout << "\n  Republished " << pages.size() << " pages for " << changed.size() << " changed and ";
+		std::cout << removed.size() << " removed files in " << ms(end - start) << " ms, ";
+		std::cout << ms(end - firstChange) << " ms after the first change\n" << std::flush;
+	};
+	auto publishAll = [&]() {
+		std::cout << "\n  Watcher lost events, publishing everything again";
+		publish();
+	};
+	watchSources(republish, publishAll);
+}
+
+// -----< was /serve given? >---------------------------------------------
+bool Executive::serveRequested() const
+{
+	return pcl_->hasOption("serve");
+}
+
+// -----< serve pages, rendering each when it is first requested >--------
+/* nothing is written to the output directory, but the script the pages
+  include is served from its parent, where published pages find it. The
+  port is the number on the command line, 8080 if there is none. Cached
+  pages of changed sources, and the pages they make stale, are dropped
+  as the watcher reports the changes. */
+void Executive::serve()
+{
+	PageServer server(cconv_, files_);
+	std::string pages = cconv_.outputDir();
+	while (pages.size() > 1 && (pages.back() == '/' || pages.back() == '\\'))
+		pages.pop_back();
+	server.staticDir(Path::getPath(pages));  // pages include ../script.js
+	unsigned short port = pcl_->maxItems() > 0 ? (unsigned short)pcl_->maxItems() : 8080;
+	if (!server.start(port))
+	{
+		std::cout << "\n  Error -- unable to serve pages on port " << port << "\n";
+		return;
+	}
+	std::cout << "\n\n  Serving " << files_.size() << " pages at http://localhost:" << server.port() << "/\n";
+
+	auto invalidate = [&](const std::vector<std::string>& changed, const std::vector<std::string>& removed,
+		FileWatcher::Clock::time_point) {
+		server.sourcesChanged(changed, removed);
+		PageServer::Stats stats = server.stats();
+		std::cout << "\n  " << changed.size() << " changed and " << removed.size() << " removed files, ";
+		std::cout << stats.cache.pages << " pages cached, " << stats.hits << " sent from the cache, ";
+		std::cout << stats.renders << " rendered\n" << std::flush;
+	};
+	auto reload = [&]() {
+		std::cout << "\n  Watcher lost events, reloading the sources";
+		server.reload(files_);
+	};
+	watchSources(invalidate, reload);
+}
+
+// -----< private - report changes to the sources, until killed >---------
+/* watches the tree extractFiles searched; files are named as the Loader
+  names them, so they match the converter's tables. A directory that
+  went away takes its files with it. When the watcher lost events the
+  files are searched for again and onRescan is called. */
+void Executive::watchSources(const OnChanges& onChanges, const std::function<void()>& onRescan)
+{
+	FileWatcher watcher(pcl_->path(), pcl_->hasOption("s"));
+	for (const auto& patt : pcl_->patterns())
+		watcher.addPattern(patt);
+	if (!watcher.start())
+	{
+		std::cout << "\n  Error -- unable to watch " << pcl_->path() << "\n";
+		return;
+	}
+	std::vector<std::regex> regexes;
+	for (const auto& regex : pcl_->regexes())
+		regexes.emplace_back(regex);
+	auto selected = [&](const std::string& name) {
+		if (regexes.empty())
+			return true;
+		for (const auto& regex : regexes)
+		{
+			if (std::regex_match(name, regex))
+				return true;
+		}
+		return false;
+	};
+	std::unordered_set<std::string> known(files_.begin(), files_.end());
+
+	std::cout << "\n\n  Watching " << pcl_->path() << (watcher.usingEvents() ? "" : " by polling");
+	std::cout << " for changes, Ctrl-C to stop\n" << std::flush;
+	while (true)
+	{
+		FileWatcher::Changes changes = watcher.wait(std::chrono::seconds(1));
+		if (changes.empty())
+			continue;
+		if (changes[0].kind == FileWatcher::rescan)
+		{
+			extractFiles();
+			onRescan();
+			known = std::unordered_set<std::string>(files_.begin(), files_.end());
+			continue;
+		}
+
+		std::vector<std::string> changed, removed;
+		for (const auto& change : changes)
+		{
+			if (change.isDir)
+			{
+				std::string dir = Path::fileSpec(change.dir, change.name);
+				for (auto iter = known.begin(); iter != known.end(); )
+				{
+					const std::string& file = *iter;
+					bool below = file.size() > dir.size() && file.compare(0, dir.size(), dir) == 0 &&
+						(file[dir.size()] == '\\' || file[dir.size()] == '/');
+					if (below)
+					{
+						removed.push_back(file);
+						files_.erase(std::remove(files_.begin(), files_.end(), file), files_.end());
+						iter = known.erase(iter);
+					}
+					else
+						++iter;
+				}
+				continue;
+			}
+			std::string file = change.path();
+			if (change.kind == FileWatcher::deleted)
+			{
+				if (known.erase(file) == 0)
+					continue;
+				removed.push_back(file);
+				files_.erase(std::remove(files_.begin(), files_.end(), file), files_.end());
+			}
+			else if (selected(change.name))
+			{
+				if (known.insert(file).second)
+					files_.push_back(file);    // kept in the order found, for a full publish
+				changed.push_back(file);
+			}
+		}
+		if (changed.empty() && removed.empty())
+			continue;
+		onChanges(changed, removed, watcher.batchStart());
+	}
 }
 
 // -----< command line usage >----------------------------------------------
@@ -131,6 +412,14 @@ ProcessCmdLine::Usage customUsage()
 	usage += "\n      /s     - walk directory recursively";
 	usage += "\n      /demo  - run in demonstration mode (cannot coexist with /debug)";
 	usage += "\n      /debug - run in debug mode (cannot coexist with /demo)";
+	usage += "\n      /stats - time each stage, writing stats.json to the output directory";
+	usage += "\n      /trace - record a timeline, writing trace.json to the output directory at exit";
+	usage += "\n      /memory - record memory at each stage boundary, writing memory.json to the output";
+	usage += "\n               directory; heap use per stage needs a TRACK_ALLOCATIONS build";
+	usage += "\n      /watch - keep running after publishing, republishing the pages affected";
+	usage += "\n               by each change to the sources";
+	usage += "\n      /serve - publish nothing, serve pages at http://localhost:port/, rendering";
+	usage += "\n               each when first requested; port is a number, 8080 if none is given";
 	//usage += "\n      /h - hide empty directories";
 	//usage += "\n      /a - on stopping, show all files in current directory";
 	usage += "\n    [pattern]* are one or more pattern strings of the form:";
@@ -197,13 +486,13 @@ void Executive::req7()
 	
 }
 
-// ------< Deletes the files from ConvertedWebpages >--------------------------
+// ------< reclaims old generations of the output directory >-----------------
+/* a publish replaces the whole output directory, so nothing needs
+  deleting before it; generations no longer live are removed in the
+  background */
 void Executive::deleteExistingFiles()
 {
-	std::string dirPath = "../ConvertedWebpages";
-	std::vector<std::string> prevFiles = FileSystem::Directory::getFiles(dirPath);
-	for (auto files : prevFiles)
-		FileSystem::File::remove(dirPath + "/" + files);
+	stage_.reclaim(cconv_.outputDir());
 }
 
 
@@ -225,7 +514,14 @@ int main(int argc, char ** argv) {
 		return 0;
 	}
 
+	if (ex.serveRequested()) {
+		ex.serve();
+		return 0;
+	}
+
 	ex.publish();
+	if (ex.watchRequested())
+		ex.watch();
 	return 0;
 }
 
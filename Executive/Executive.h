@@ -1,7 +1,7 @@
 #pragma once
 ///////////////////////////////////////////////////////////////////////////
 // Executive.h :  Integrates all the code publisher functionalities      //
-// ver 1.0                                                               //
+// ver 2.0                                                               //
 //                                                                       // 
 // Author:      Sneha Giranje					                         //
 ///////////////////////////////////////////////////////////////////////////
@@ -21,7 +21,9 @@
 * =======================
 *  Executive.h Executive.cpp CodeUtilities.h
 *  Converter.h Converter.cpp Loader.h loader.cpp
-*  Display.h Display.cpp
+*  Display.h Display.cpp PerfStats.h PerfStats.cpp Trace.h Trace.cpp
+*  MemStats.h MemStats.cpp FileWatcher.h FileWatcher.cpp
+*  PageServer.h PageServer.cpp StagedOutput.h StagedOutput.cpp
 *Public Interface:
 ---------------------
 Executive();
@@ -37,7 +39,13 @@ Executive();
 	void publish();
 	void publish(const std::string& file);
 	void publish(const std::vector<std::string>& files);
-	std::vector<std::string> getConvertedFiles();
+	const std::vector<std::string>& getConvertedFiles();
+	bool writeStats(const std::string& path);
+	bool writeMemory(const std::string& path);
+	bool watchRequested() const;
+	void watch();
+	bool serveRequested() const;
+	void serve();
 
 	void req1();
 	void req2();
@@ -52,6 +60,38 @@ Executive();
 
 *  Maintainence History:
 * =======================
+  ver 2.0 - 19 Oct 2026
+  --publish writes to a staging directory, a new generation of the
+    output directory, and swaps it into place when complete, so readers
+    never see a partly published site; deleteExistingFiles no longer
+    deletes pages one by one, it queues old generations for removal
+    by a background thread
+  ver 1.9 - 19 Oct 2026
+  --Added /serve option: instead of publishing, serve runs a PageServer
+    on localhost that renders each page when it is first requested and
+    caches it, with watched changes to the sources invalidating the
+    cached pages they affect
+  ver 1.8 - 19 Oct 2026
+  --Added /watch option: after publishing, watch keeps running, and
+    each batch of created, modified and deleted sources found by a
+    FileWatcher republishes only the pages it affects
+  ver 1.7 - 19 Oct 2026
+  --getConvertedFiles returns the converter's page list by const
+    reference instead of a copy kept by Executive
+  ver 1.6 - 19 Oct 2026
+  --Added /memory option: live heap bytes and peak RSS are recorded
+    at each stage boundary and publish writes them, with heap use per
+    stage in TRACK_ALLOCATIONS builds, to memory.json
+  ver 1.5 - 19 Oct 2026
+  --publish shows the parser's rule profile table when built with
+    PROFILE_RULES
+  ver 1.4 - 19 Oct 2026
+  --Added /trace option: the PerfStats timers are recorded as a timeline
+    and written to trace.json in the output directory at exit
+  ver 1.3 - 19 Oct 2026
+  --Added /stats option: extractFiles and each stage of publish are
+    timed with PerfStats, and publish writes the JSON report to
+    stats.json in the output directory
   ver 1.2 - 15 April 2019
   --Added methods to demonstate the project3 requirements
 * 
@@ -61,11 +101,18 @@ Executive();
 
 #include <string>
 #include <vector>
+#include <functional>
 #include "IExecutive.h"
 #include "../Converter/Converter.h"
 #include "../Loader/Loader.h"
+#include "../FileWatcher/FileWatcher.h"
+#include "../PageServer/PageServer.h"
+#include "../StagedOutput/StagedOutput.h"
 #include "../Utilities/CodeUtilities/CodeUtilities.h"
 #include "../Display/Display.h"
+#include "../CppParser/PerfStats/PerfStats.h"
+#include "../CppParser/PerfStats/Trace.h"
+#include "../CppParser/PerfStats/MemStats.h"
 
 
 class Executive : public IExecutive
@@ -84,7 +131,13 @@ public:
 	void publish();
 	void publish(const std::string& file);
 	void publish(const std::vector<std::string>& files);
-	std::vector<std::string> getConvertedFiles();
+	const std::vector<std::string>& getConvertedFiles();
+	bool writeStats(const std::string& path);
+	bool writeMemory(const std::string& path);
+	bool watchRequested() const;
+	void watch();
+	bool serveRequested() const;
+	void serve();
 
 	void req1();
 	void req2();
@@ -98,15 +151,21 @@ public:
 	Utilitiess::DisplayMode displayMode() const;
 
 private:
+	using OnChanges = std::function<void(const std::vector<std::string>& changed,
+		const std::vector<std::string>& removed, FileSystem::FileWatcher::Clock::time_point firstChange)>;
+	void watchSources(const OnChanges& onChanges, const std::function<void()>& onRescan);
+	std::string beginStaging();
+	void commitStaging(const std::string& live);
+
 	Utilitiess::ProcessCmdLine *pcl_;
 	CodeConverter cconv_;
+	FileSystem::StagedOutput stage_;
 	Display display_;
 
 	std::string dirIn_;
 	std::string dirOut_;
 
 	std::vector<std::string> files_;
-	std::vector<std::string> convertedFiles_;
 };
 inline IExecutive* IExecutive::createProject()
 {
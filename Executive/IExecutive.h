@@ -2,7 +2,7 @@
 
 ///////////////////////////////////////////////////////////////////////////
 // IExecutive.h : Interface of the Executive class                       //
-// ver 1.0                                                               //
+// ver 1.2                                                               //
 //                                                                       // 
 // Author:      Sneha Giranje					                         //
 ///////////////////////////////////////////////////////////////////////////
@@ -15,18 +15,26 @@
 *
 *  Maintainence History:
 * =======================
+*  ver 1.2 - 19 Oct 2026
+*  - getConvertedFiles returns the list by const reference
+*  ver 1.1 - 19 Oct 2026
+*  - added a virtual destructor, and outputDirectory so clients running
+*    several projects can give each its own output
 *  ver 1.0 - 5 Apr 2019
 *  - first release
 */
 
 #include <vector>
+#include <string>
 class IExecutive {
 public:
+	virtual ~IExecutive() {}
 	virtual bool processCommandLineArgs(int argc, char ** argv) = 0;
 	virtual bool extractFiles() = 0;
 	virtual void publish() = 0;
+	virtual void outputDirectory(const std::string& dir) = 0;
 	virtual void deleteExistingFiles() = 0;
-	virtual std::vector<std::string> getConvertedFiles() = 0;
+	virtual const std::vector<std::string>& getConvertedFiles() = 0;
 	static IExecutive* createProject();
 };
 
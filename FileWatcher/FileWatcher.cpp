@@ -0,0 +1,532 @@
+///////////////////////////////////////////////////////////////////////////
+// FileWatcher.cpp : reports created, modified and deleted source files  //
+// ver 1.1                                                               //
+//                                                                       //
+// Application   : Project Code Publisher                                //
+// Author        : Sneha Giranje                  						 //
+///////////////////////////////////////////////////////////////////////////
+
+#include "FileWatcher.h"
+#include "../Loader/Loader.h"
+#include "../CppParser/FileSystem/FileSystem.h"
+#include <algorithm>
+#include <thread>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+using namespace FileSystem;
+
+namespace
+{
+#ifdef __linux__
+	const uint32_t watchMask = IN_CREATE | IN_DELETE | IN_MODIFY | IN_CLOSE_WRITE |
+		IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_ONLYDIR;
+#endif
+
+	// stop() is noticed at least this often
+	const std::chrono::milliseconds stopCheck(50);
+
+	std::chrono::milliseconds until(FileWatcher::Clock::time_point when)
+	{
+		auto left = std::chrono::duration_cast<std::chrono::milliseconds>(when - FileWatcher::Clock::now());
+		return (std::max)(left, std::chrono::milliseconds(0));
+	}
+}
+
+// -----< name of a changed file as Loader lists it >-----------------------
+
+std::string FileWatcher::Change::path() const
+{
+	return Loader::fileSpec(dir, name);
+}
+
+// -----< merge an event into the batch >-----------------------------------
+/*
+*  created then modified is still created, created then deleted cancels,
+*  deleted then created is an edit.
+*/
+void FileWatcher::Pending::add(const Change& change)
+{
+	if (change.kind == rescan)
+	{
+		overflowed = true;
+		return;
+	}
+	std::string key = change.path();
+	auto iter = byPath.find(key);
+	if (iter == byPath.end())
+	{
+		byPath.emplace(key, change);
+		order.push_back(key);
+		return;
+	}
+	Change& seen = iter->second;
+	if (seen.kind == created && change.kind == deleted)
+		byPath.erase(iter);
+	else if (seen.kind == deleted && change.kind == created)
+		seen.kind = modified;
+	else if (!(seen.kind == created && change.kind == modified))
+		seen.kind = change.kind;
+}
+
+// -----< changes of the batch, one per path >------------------------------
+
+FileWatcher::Changes FileWatcher::Pending::take()
+{
+	Changes changes;
+	if (overflowed)
+	{
+		Change change;
+		change.kind = FileWatcher::rescan;
+		changes.push_back(change);
+	}
+	else
+	{
+		for (const auto& key : order)
+		{
+			auto iter = byPath.find(key);
+			if (iter == byPath.end())
+				continue;   // cancelled, or already taken
+			changes.push_back(std::move(iter->second));
+			byPath.erase(iter);
+		}
+	}
+	byPath.clear();
+	order.clear();
+	overflowed = false;
+	return changes;
+}
+
+// -----< watch root, and its subdirectories when recursing >---------------
+
+FileWatcher::FileWatcher(const std::string& root, bool recurse)
+	: root_(Path::getFullFileSpec(root)), recurse_(recurse) {}
+
+FileWatcher::~FileWatcher()
+{
+#ifdef __linux__
+	if (fd_ >= 0)
+		::close(fd_);
+#endif
+}
+
+// -----< report only files matching these patterns >-----------------------
+
+void FileWatcher::addPattern(const std::string& pattern)
+{
+	patterns_.push_back(pattern);
+}
+
+// -----< quiet time that ends a batch >------------------------------------
+
+void FileWatcher::debounce(std::chrono::milliseconds quiet)
+{
+	debounce_ = quiet;
+}
+
+// -----< longest a batch waits for the tree to be quiet >------------------
+
+void FileWatcher::maxDelay(std::chrono::milliseconds delay)
+{
+	maxDelay_ = delay;
+}
+
+// -----< time between scans when polling >---------------------------------
+
+void FileWatcher::pollInterval(std::chrono::milliseconds interval)
+{
+	pollInterval_ = interval;
+}
+
+bool FileWatcher::matches(const std::string& name) const
+{
+	if (patterns_.empty())
+		return true;
+	for (const auto& pattern : patterns_)
+	{
+		if (Directory::match(name, pattern))
+			return true;
+	}
+	return false;
+}
+
+// -----< begin watching, false if the root can't be read >-----------------
+
+bool FileWatcher::start()
+{
+	if (!Directory::exists(root_))
+		return false;
+	stopping_ = false;
+#ifdef __linux__
+	if (fd_ < 0)
+		fd_ = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (fd_ >= 0)
+	{
+		addDir(root_, nullptr);
+		if (!dirs_.empty())
+			return true;
+		::close(fd_);
+		fd_ = -1;
+	}
+#endif
+	snapshot_.clear();
+	scan(root_, snapshot_);
+	return true;
+}
+
+bool FileWatcher::usingEvents() const
+{
+	return fd_ >= 0;
+}
+
+// -----< end a wait, called from another thread >--------------------------
+
+void FileWatcher::stop()
+{
+	stopping_ = true;
+}
+
+// -----< when the first event of the last batch was seen >-----------------
+
+FileWatcher::Clock::time_point FileWatcher::batchStart() const
+{
+	return batchStart_;
+}
+
+// -----< next batch of changes, empty on timeout or stop >-----------------
+/*
+*  Waits up to timeout for a first event, then collects until nothing
+*  has happened for the debounce interval, or maxDelay has passed since
+*  the first event.
+*/
+FileWatcher::Changes FileWatcher::wait(std::chrono::milliseconds timeout)
+{
+	Pending pending;
+	Clock::time_point deadline = Clock::now() + timeout;
+	bool events = usingEvents();
+
+	while (pending.empty())
+	{
+		if (stopping_ || Clock::now() >= deadline)
+			return Changes();
+		if (events)
+		{
+			if (waitForEvents((std::min)(until(deadline), stopCheck)))
+				readEvents(pending);
+		}
+		else
+		{
+			std::this_thread::sleep_for((std::min)(until(deadline), pollInterval_));
+			poll(pending);
+		}
+	}
+	batchStart_ = Clock::now();
+
+	Clock::time_point last = batchStart_;
+	Clock::time_point cap = batchStart_ + maxDelay_;
+	while (!stopping_)
+	{
+		Clock::time_point quiet = (std::min)(last + debounce_, cap);
+		if (Clock::now() >= quiet)
+			break;
+		if (events)
+		{
+			if (!waitForEvents(until(quiet)))
+				continue;
+			readEvents(pending);
+		}
+		else
+		{
+			std::this_thread::sleep_for(until(quiet));
+			size_t before = pending.order.size();
+			poll(pending);
+			if (pending.order.size() == before)
+				break;
+		}
+		last = Clock::now();
+	}
+	return pending.take();
+}
+
+#ifdef __linux__
+
+// -----< watch dir, and its subdirectories, listing files found >----------
+
+void FileWatcher::addDir(const std::string& dir, Changes* pFound)
+{
+	int wd = ::inotify_add_watch(fd_, dir.c_str(), watchMask);
+	if (wd < 0)
+		return;
+	dirs_[wd] = dir;
+
+	Directory::Listing listing;
+	if (!Directory::list(dir, listing))
+		return;
+	if (pFound != nullptr)
+	{
+		for (const auto& name : listing.files)
+		{
+			if (!matches(name))
+				continue;
+			Change change;
+			change.kind = created;
+			change.dir = dir;
+			change.name = name;
+			pFound->push_back(change);
+		}
+	}
+	if (!recurse_)
+		return;
+	for (const auto& name : listing.dirs)
+		addDir(Path::fileSpec(dir, name), pFound);
+}
+
+// -----< stop watching dir and everything below it >-----------------------
+
+void FileWatcher::dropDir(const std::string& dir)
+{
+	std::string below = Path::fileSpec(dir, "");
+	for (auto iter = dirs_.begin(); iter != dirs_.end(); )
+	{
+		const std::string& path = iter->second;
+		if (path == dir || path.compare(0, below.size(), below) == 0)
+		{
+			::inotify_rm_watch(fd_, iter->first);
+			iter = dirs_.erase(iter);
+		}
+		else
+			++iter;
+	}
+}
+
+bool FileWatcher::waitForEvents(std::chrono::milliseconds timeout)
+{
+	pollfd ready = { fd_, POLLIN, 0 };
+	return ::poll(&ready, 1, (int)timeout.count()) > 0;
+}
+
+// -----< read every queued event into the batch >--------------------------
+
+void FileWatcher::readEvents(Pending& pending)
+{
+	alignas(inotify_event) char buffer[64 * 1024];
+	while (true)
+	{
+		ssize_t length = ::read(fd_, buffer, sizeof(buffer));
+		if (length <= 0)
+			break;
+		for (char* pos = buffer; pos < buffer + length; )
+		{
+			const inotify_event* pEvent = reinterpret_cast<const inotify_event*>(pos);
+			pos += sizeof(inotify_event) + pEvent->len;
+
+			if (pEvent->mask & IN_Q_OVERFLOW)
+			{
+				Change change;
+				change.kind = rescan;
+				pending.add(change);
+				addDir(root_, nullptr);   // pick up directories we missed
+				continue;
+			}
+			if (pEvent->mask & IN_IGNORED)
+			{
+				dirs_.erase(pEvent->wd);
+				continue;
+			}
+			auto iter = dirs_.find(pEvent->wd);
+			if (iter == dirs_.end() || pEvent->len == 0)
+				continue;             // events on the directory itself
+
+			Change change;
+			change.dir = iter->second;
+			change.name = pEvent->name;
+			change.isDir = (pEvent->mask & IN_ISDIR) != 0;
+			if (change.isDir)
+			{
+				if (!recurse_)
+					continue;
+				std::string path = Path::fileSpec(change.dir, change.name);
+				if (pEvent->mask & (IN_CREATE | IN_MOVED_TO))
+				{
+					Changes found;
+					addDir(path, &found);
+					for (const auto& file : found)
+						pending.add(file);
+				}
+				else if (pEvent->mask & (IN_DELETE | IN_MOVED_FROM))
+				{
+					dropDir(path);
+					change.kind = deleted;
+					pending.add(change);
+				}
+				continue;
+			}
+			if (!matches(change.name))
+				continue;
+			if (pEvent->mask & (IN_CREATE | IN_MOVED_TO))
+				change.kind = created;
+			else if (pEvent->mask & (IN_DELETE | IN_MOVED_FROM))
+				change.kind = deleted;
+			else
+				change.kind = modified;
+			pending.add(change);
+		}
+	}
+}
+
+#else
+
+void FileWatcher::addDir(const std::string&, Changes*) {}
+void FileWatcher::dropDir(const std::string&) {}
+bool FileWatcher::waitForEvents(std::chrono::milliseconds) { return false; }
+void FileWatcher::readEvents(Pending&) {}
+
+#endif
+
+// -----< size and modification time of every watched file >----------------
+
+void FileWatcher::scan(const std::string& dir, Snapshot& snapshot) const
+{
+	Directory::Listing listing;
+	if (!Directory::list(dir, listing))
+		return;
+	for (const auto& name : listing.files)
+	{
+		if (!matches(name))
+			continue;
+		std::string path = Path::fileSpec(dir, name);
+#ifdef _WIN32
+		struct _stat64 info;
+		if (::_stat64(path.c_str(), &info) != 0)
+			continue;
+#else
+		struct stat info;
+		if (::stat(path.c_str(), &info) != 0)
+			continue;
+#endif
+		Stamp stamp;
+		stamp.dir = dir;
+		stamp.name = name;
+		stamp.mtime = (int64_t)info.st_mtime;
+		stamp.size = (uint64_t)info.st_size;
+		snapshot[Loader::fileSpec(dir, name)] = stamp;
+	}
+	if (!recurse_)
+		return;
+	for (const auto& name : listing.dirs)
+		scan(Path::fileSpec(dir, name), snapshot);
+}
+
+// -----< compare a new scan with the last one >----------------------------
+
+void FileWatcher::poll(Pending& pending)
+{
+	Snapshot now;
+	scan(root_, now);
+
+	auto report = [&](const Stamp& stamp, Kind kind) {
+		Change change;
+		change.kind = kind;
+		change.dir = stamp.dir;
+		change.name = stamp.name;
+		pending.add(change);
+	};
+	for (const auto& entry : now)
+	{
+		auto iter = snapshot_.find(entry.first);
+		if (iter == snapshot_.end())
+			report(entry.second, created);
+		else if (iter->second.mtime != entry.second.mtime || iter->second.size != entry.second.size)
+			report(entry.second, modified);
+	}
+	for (const auto& entry : snapshot_)
+	{
+		if (now.find(entry.first) == now.end())
+			report(entry.second, deleted);
+	}
+	snapshot_.swap(now);
+}
+
+#ifdef TEST_FILEWATCHER
+
+#include <iostream>
+#include <fstream>
+
+// -----< demonstrate batches of changes in a scratch directory >-----------
+
+int main(int argc, char* argv[])
+{
+	std::cout << "\n  Demonstrating FileWatcher";
+	std::cout << "\n ===========================";
+
+	std::string root = argc > 1 ? argv[1] : "FileWatcherDemo";
+	Directory::create(root);
+
+	FileWatcher watcher(root, true);
+	watcher.addPattern("*.h");
+	watcher.addPattern("*.cpp");
+	watcher.debounce(std::chrono::milliseconds(5));
+	if (!watcher.start())
+	{
+		std::cout << "\n  can't watch " << root << "\n\n";
+		return 1;
+	}
+	std::cout << "\n  watching " << root << (watcher.usingEvents() ? " with inotify" : " by polling");
+
+	std::thread editor([&]() {
+		std::string file = Path::fileSpec(root, "demo.cpp");
+		std::string sub = Path::fileSpec(root, "sub");
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+		std::ofstream(file) << "int main() { return 0; }\n";
+		std::ofstream(file, std::ios::app) << "// edited\n";    // same batch
+		std::this_thread::sleep_for(std::chrono::milliseconds(500));
+		Directory::create(sub);
+		std::ofstream(Path::fileSpec(sub, "demo.h")) << "#pragma once\n";
+		std::ofstream(Path::fileSpec(sub, "notes.txt")) << "not watched\n";
+		std::this_thread::sleep_for(std::chrono::milliseconds(500));
+		File::remove(Path::fileSpec(sub, "demo.h"));
+		File::remove(Path::fileSpec(sub, "notes.txt"));
+		File::remove(file);
+		Directory::remove(sub);
+		std::this_thread::sleep_for(std::chrono::milliseconds(500));
+		watcher.stop();
+	});
+
+	// a file reported created or modified is still there when its batch
+	// arrives, so the path reported must name it, as it will be opened
+
+	const char* kinds[] = { "created", "modified", "deleted", "rescan" };
+	size_t unopened = 0;
+	while (true)
+	{
+		FileWatcher::Changes changes = watcher.wait(std::chrono::seconds(5));
+		if (changes.empty())
+			break;
+		std::cout << "\n\n  batch of " << changes.size() << " changes";
+		for (const auto& change : changes)
+		{
+			std::cout << "\n    " << kinds[change.kind] << (change.isDir ? " dir  " : " file ") << change.path();
+			if (change.isDir || change.kind == FileWatcher::deleted || change.kind == FileWatcher::rescan)
+				continue;
+			if (!std::ifstream(change.path()).good())
+			{
+				std::cout << " - can't be opened";
+				++unopened;
+			}
+		}
+	}
+	editor.join();
+	Directory::remove(root);
+	std::cout << "\n\n  " << (unopened == 0 ? "every changed file reported opens" : "some changed files reported don't open");
+	std::cout << "\n\n";
+	return unopened == 0 ? 0 : 1;
+}
+
+#endif
@@ -0,0 +1,155 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////
+// FileWatcher.h : reports created, modified and deleted source files    //
+// ver 1.1                                                               //
+//                                                                       //
+// Application   : Project Code Publisher                                //
+// Author        : Sneha Giranje                  						 //
+///////////////////////////////////////////////////////////////////////////
+/*
+*  Package Operations:
+* =======================
+*  This package defines FileWatcher, which watches the directory tree a
+*  Loader would search - a root, its subdirectories when recursing, and
+*  files matching the Loader's patterns - and reports what changed there
+*  as batches of changes.
+*
+*  On Linux the watcher uses inotify: one watch per directory, added as
+*  directories appear, so a change is known as soon as the file is
+*  written.  Elsewhere, or if inotify can't be used, it polls, comparing
+*  the size and modification time of every file with the last scan.
+*
+*  Saving a file usually produces a burst of events - an editor may
+*  write a temporary, rename it over the original and touch it again.
+*  wait() debounces: after the first event it keeps collecting until
+*  the tree has been quiet for the debounce interval, or maxDelay has
+*  passed, then merges the events of each file into one change.  A file
+*  created and then deleted within a batch is not reported at all.
+*
+*  Files are named as Loader names them, by the directory's full path
+*  and the file's name, so changes can be looked up in the tables built
+*  from a Loader's file list.  Saving over an existing file by renaming
+*  a temporary onto it is reported as created, so clients should treat
+*  created and modified alike.  With inotify, a deleted or moved away
+*  directory is one change with isDir set, its files are not listed; a
+*  directory that appears is reported with the files found in it.  If
+*  inotify drops events, the batch holds a single rescan change, asking
+*  the client to start again from a full search.
+*
+*  Public Interface:
+* =======================
+*  FileWatcher watcher(root, recurse);
+*  watcher.addPattern("*.h");
+*  watcher.debounce(std::chrono::milliseconds(5));
+*  watcher.start();
+*  FileWatcher::Changes changes = watcher.wait(std::chrono::seconds(1));
+*  watcher.batchStart();    // when the first event of the batch arrived
+*  watcher.stop();          // from another thread, ends a wait
+*
+*  Required Files:
+* =======================
+*  FileWatcher.h FileWatcher.cpp Loader.h Loader.cpp FileSystem.h
+*  FileSystem.cpp
+*
+*  Build Process:
+* =======================
+*  The FileWatcher project defines TEST_FILEWATCHER in Debug|x64,
+*  building a demo that watches a directory and prints each batch,
+*  failing if a file reported created or modified can't be opened:
+*  FileWatcher [dir]
+*
+*  Maintainence History:
+* =======================
+*  ver 1.1 - 19 Oct 2026
+*  - changed files are named with the separator their directory uses,
+*    through Loader::fileSpec, so paths reported on Linux open; the demo
+*    checks that they do
+*  ver 1.0 - 19 Oct 2026
+*  - first release
+*/
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace FileSystem
+{
+	class FileWatcher
+	{
+	public:
+		enum Kind { created, modified, deleted, rescan };
+
+		struct Change
+		{
+			Kind kind = modified;
+			std::string dir;          // full path, as Loader finds it
+			std::string name;
+			bool isDir = false;
+			std::string path() const; // as Loader lists the file
+		};
+		using Changes = std::vector<Change>;
+		using Clock = std::chrono::steady_clock;
+
+		FileWatcher(const std::string& root, bool recurse);
+		~FileWatcher();
+
+		void addPattern(const std::string& pattern);   // *.* when none
+		void debounce(std::chrono::milliseconds quiet);
+		void maxDelay(std::chrono::milliseconds delay);
+		void pollInterval(std::chrono::milliseconds interval);
+
+		bool start();
+		bool usingEvents() const;     // inotify, rather than polling
+		Changes wait(std::chrono::milliseconds timeout);
+		Clock::time_point batchStart() const;
+		void stop();
+
+	private:
+		struct Stamp
+		{
+			std::string dir;
+			std::string name;
+			int64_t mtime = 0;
+			uint64_t size = 0;
+		};
+		using Snapshot = std::unordered_map<std::string, Stamp>;  // by path
+
+		// events of a batch, merged per path, in order of first event
+		struct Pending
+		{
+			std::unordered_map<std::string, Change> byPath;
+			std::vector<std::string> order;
+			bool overflowed = false;
+			void add(const Change& change);
+			bool empty() const { return order.empty() && !overflowed; }
+			Changes take();
+		};
+
+		bool matches(const std::string& name) const;
+		void addDir(const std::string& dir, Changes* pFound);
+		void dropDir(const std::string& dir);
+		bool waitForEvents(std::chrono::milliseconds timeout);
+		void readEvents(Pending& pending);
+		void scan(const std::string& dir, Snapshot& snapshot) const;
+		void poll(Pending& pending);
+
+		std::string root_;
+		bool recurse_;
+		std::vector<std::string> patterns_;
+		std::chrono::milliseconds debounce_{ 5 };
+		std::chrono::milliseconds maxDelay_{ 250 };
+		std::chrono::milliseconds pollInterval_{ 250 };
+		Clock::time_point batchStart_;
+		std::atomic<bool> stopping_{ false };
+
+		int fd_ = -1;                                   // inotify
+		std::unordered_map<int, std::string> dirs_;     // watch to directory
+		Snapshot snapshot_;                             // polling
+
+		FileWatcher(const FileWatcher&) = delete;
+		FileWatcher& operator=(const FileWatcher&) = delete;
+	};
+}
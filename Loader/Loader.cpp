@@ -1,6 +1,6 @@
 /////////////////////////////////////////////////////////////////////
 // Loader.cpp - Naive directory explorer and Loader                //
-// ver 1.2                                                         //
+// ver 1.3                                                         //
 // Source :     Jim Fawcett, CSE687 - Object Oriented Design       //
 /////////////////////////////////////////////////////////////////////
 
@@ -53,21 +53,22 @@ void Loader::find(const std::string& path)
 	std::string fpath = Path::getFullFileSpec(path);
 	doDir(fpath);
 
-	for (auto patt : patterns_)
+	// one scan of the directory serves every pattern
+
+	Directory::Listing listing;
+	Directory::list(fpath, listing);
+	for (auto& patt : patterns_)
 	{
-		std::vector<std::string> files = Directory::getFiles(fpath, patt);
-		for (auto f : files)
+		for (auto& f : listing.files)
 		{
-			doFile(fpath, f);  // show each file in current directory
+			if (Directory::match(f, patt))
+				doFile(fpath, f);  // show each file in current directory
 		}
 	}
 
-	std::vector<std::string> dirs = Directory::getDirectories(fpath);
-	for (auto d : dirs)
+	for (auto& d : listing.dirs)
 	{
-		if (d == "." || d == "..")
-			continue;
-		std::string dpath = fpath + "\\" + d;
+		std::string dpath = Path::fileSpec(fpath, d);
 		if (recurse_)
 		{
 			find(dpath);   // recurse into subdirectories
@@ -122,10 +123,17 @@ bool Loader::match_regexes(const std::vector<std::string>& regexes)
 void Loader::doFile(const std::string& dir, const std::string& filename)
 {
 	++fileCount_;
-	std::string filepath = dir + "\\" + filename;
-	files_.push_back(filepath);
+	files_.push_back(fileSpec(dir, filename));
 	//std::cout << "\n  --   " + filename;
 }
+//----< name of file filename found in directory dir >-------------
+/*
+  joined with the separator dir already uses, so names open on POSIX
+*/
+std::string Loader::fileSpec(const std::string& dir, const std::string& filename)
+{
+	return Path::fileSpec(dir, filename);
+}
 //----< an application changes to enable specific dir ops >--------
 
 void Loader::doDir(const std::string& dirname)
@@ -163,6 +171,7 @@ void Loader::showStats()
 
 #include "../Utilities/StringUtilities/StringUtilities.h"
 #include "../Utilities/CodeUtilities/CodeUtilities.h"
+#include <fstream>
 
 using namespace Utilitiess;
 
@@ -184,7 +193,7 @@ ProcessCmdLine::Usage customUsage()
 
 int main(int argc, char *argv[])
 {
-	Title("Demonstrate Loader, " + DirExplorerN::version());
+	Title("Demonstrate Loader, " + Loader::version());
 
 	ProcessCmdLine pcl(argc, argv);
 	pcl.usage(customUsage());
@@ -218,8 +227,22 @@ int main(int argc, char *argv[])
 		std::cout << "\n\n  Failed to find any files matching patterns and regexes. Terminating..\n\n";
 		return 1;
 	}
-	//std::cout << "\n\n";
-	return 0;
+
+	// every name found must open, as the publisher will open it,
+	// with whichever separator the platform uses
+
+	size_t unopened = 0;
+	for (auto& file : ld.filesList())
+	{
+		std::ifstream in(file);
+		if (!in.good())
+		{
+			std::cout << "\n  can't open " << file;
+			++unopened;
+		}
+	}
+	std::cout << "\n  opened " << ld.filesList().size() - unopened << " of " << ld.filesList().size() << " files found\n\n";
+	return unopened == 0 ? 0 : 1;
 }
 
 #endif
\ No newline at end of file
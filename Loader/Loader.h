@@ -1,7 +1,7 @@
 #pragma once
 /////////////////////////////////////////////////////////////////////
 // Loader.h - Naive directory explorer                             //
-// ver 1.3                                                         //
+// ver 1.7                                                         //
 // Source  : Jim Fawcett, CSE687 - OOD, Fall 2018                  //
 /////////////////////////////////////////////////////////////////////
 /*
@@ -52,6 +52,7 @@
  * ld.match_regexes(std::vector<std::string> regexes);
  * ld.doFile(dir,filename);
  * ld.doDir(dirname);
+ * Loader::fileSpec(dir, filename);  // name of a file, as listed
  * 
  *
  * Required Files:
@@ -63,6 +64,14 @@
  *
  * Maintenance History:
  * --------------------
+ * ver 1.7 : 19 Oct 2026
+ * - fileSpec joins with Path::fileSpec; a backslash made every name
+ *   found on POSIX unopenable
+ * ver 1.6 : 19 Oct 2026
+ * - added fileSpec, so other packages name files as doFile does
+ * ver 1.5 : 19 Oct 2026
+ * - find lists each directory once with Directory::list and matches
+ *   every pattern against that listing
  * ver 1.4 : 11 Feb 2019
  * - Added file containers
  *   Added regex matching
@@ -90,7 +99,7 @@ namespace FileSystem
 		using patterns = std::vector<std::string>;
 		using files = std::vector<std::string>;
 
-		static std::string version() { return "ver 1.4"; }
+		static std::string version() { return "ver 1.7"; }
 
 		Loader(const std::string& path);
 
@@ -109,6 +118,7 @@ namespace FileSystem
 
 		void doFile(const std::string& dir, const std::string& filename);
 		void doDir(const std::string& dirname);
+		static std::string fileSpec(const std::string& dir, const std::string& filename);
 
 		// extract traversal statistics 
 		const files& filesList() const;
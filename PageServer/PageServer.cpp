@@ -0,0 +1,875 @@
+///////////////////////////////////////////////////////////////////////////
+// PageServer.cpp : serves webpages rendered when first requested        //
+// ver 1.2                                                               //
+//                                                                       //
+// Application   : Project Code Publisher                                //
+// Author        : Sneha Giranje                  						 //
+///////////////////////////////////////////////////////////////////////////
+
+#ifdef _WIN32
+#include <winsock2.h>   // before windows.h, which FileSystem.h includes
+#include <ws2tcpip.h>
+#pragma comment(lib, "Ws2_32.lib")
+#else
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+#include "PageServer.h"
+#include "../CppParser/FileSystem/FileSystem.h"
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <cctype>
+
+using namespace FileSystem;
+
+namespace
+{
+	const std::uintptr_t noSocket = ~std::uintptr_t(0);  // ends a worker
+	const size_t maxRequestBytes = 16 * 1024;
+	const int idleMs = 2000;      // a kept alive connection is closed after
+	const int stopCheckMs = 100;  // stop() is noticed at least this often
+
+#ifdef _WIN32
+	using NativeSocket = SOCKET;
+	const int sendFlags = 0;
+
+	void closeSocket(std::uintptr_t s)
+	{
+		::closesocket((SOCKET)s);
+	}
+
+	bool readable(std::uintptr_t s, int ms)
+	{
+		WSAPOLLFD fd = { (SOCKET)s, POLLRDNORM, 0 };
+		return ::WSAPoll(&fd, 1, ms) > 0;
+	}
+#else
+	using NativeSocket = int;
+	const int sendFlags = MSG_NOSIGNAL;   // a closed client is an error, not SIGPIPE
+
+	void closeSocket(std::uintptr_t s)
+	{
+		::close((int)s);
+	}
+
+	bool readable(std::uintptr_t s, int ms)
+	{
+		pollfd fd = { (int)s, POLLIN, 0 };
+		return ::poll(&fd, 1, ms) > 0;
+	}
+#endif
+
+	bool sendAll(std::uintptr_t s, const char* data, size_t size)
+	{
+		while (size > 0)
+		{
+			int sent = ::send((NativeSocket)s, data, (int)(std::min)(size, size_t(1) << 20), sendFlags);
+			if (sent <= 0)
+				return false;
+			data += sent;
+			size -= sent;
+		}
+		return true;
+	}
+
+	std::string lower(std::string text)
+	{
+		for (char& ch : text)
+			ch = (char)std::tolower((unsigned char)ch);
+		return text;
+	}
+
+	// -----< %xx escapes in a request target replaced >--------------------
+	std::string decode(const std::string& target)
+	{
+		std::string text;
+		for (size_t i = 0; i < target.size(); ++i)
+		{
+			if (target[i] == '%' && i + 2 < target.size() &&
+				std::isxdigit((unsigned char)target[i + 1]) && std::isxdigit((unsigned char)target[i + 2]))
+			{
+				text += (char)std::stoi(target.substr(i + 1, 2), nullptr, 16);
+				i += 2;
+			}
+			else
+				text += target[i];
+		}
+		return text;
+	}
+
+	// content type of a file the pages include, nullptr for any other file
+	const char* assetType(const std::string& name)
+	{
+		auto endsWith = [&](const std::string& ext) {
+			return name.size() > ext.size() && name.compare(name.size() - ext.size(), ext.size(), ext) == 0;
+		};
+		if (endsWith(".js"))
+			return "application/javascript";
+		if (endsWith(".css"))
+			return "text/css; charset=utf-8";
+		return nullptr;
+	}
+
+	std::string escapeHtml(const std::string& text)
+	{
+		std::string html;
+		for (char ch : text)
+		{
+			switch (ch)
+			{
+			case '<': html += "&lt;"; break;
+			case '>': html += "&gt;"; break;
+			case '&': html += "&amp;"; break;
+			case '"': html += "&quot;"; break;
+			default: html += ch;
+			}
+		}
+		return html;
+	}
+
+	bool readFile(const std::string& path, std::string& text)
+	{
+		std::ifstream in(path, std::ios::binary);
+		if (!in.good())
+			return false;
+		std::ostringstream content;
+		content << in.rdbuf();
+		text = content.str();
+		return true;
+	}
+}
+
+// -----< PageCache ctor - bounded by the bytes of the pages it holds >-----
+
+PageCache::PageCache(size_t maxBytes) : maxBytes_(maxBytes) {}
+
+void PageCache::maxBytes(size_t bytes)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	maxBytes_ = bytes;
+	evict();
+}
+
+// -----< cached page, made the most recently used, or null >---------------
+
+PageCache::Page PageCache::find(const std::string& name, Stamp* pStamp)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	auto iter = byName_.find(name);
+	if (iter == byName_.end())
+		return nullptr;
+	entries_.splice(entries_.begin(), entries_, iter->second);
+	if (pStamp)
+		*pStamp = iter->second->stamp;
+	return iter->second->page;
+}
+
+// -----< add or replace a page, evicting the least recently used >---------
+/*
+*  A page larger than the whole cache is not kept.
+*/
+void PageCache::insert(const std::string& name, const Page& page, const Stamp& stamp)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	auto iter = byName_.find(name);
+	if (iter != byName_.end())
+	{
+		stats_.bytes -= iter->second->page->size();
+		entries_.erase(iter->second);
+		byName_.erase(iter);
+	}
+	if (page->size() > maxBytes_)
+		return;
+	entries_.push_front(Entry{ name, page, stamp });
+	byName_[name] = entries_.begin();
+	stats_.bytes += page->size();
+	evict();
+}
+
+// -----< source touched but not edited, the page is still good >-----------
+
+void PageCache::restamp(const std::string& name, const Stamp& stamp)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	auto iter = byName_.find(name);
+	if (iter != byName_.end())
+		iter->second->stamp = stamp;
+}
+
+bool PageCache::erase(const std::string& name)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	auto iter = byName_.find(name);
+	if (iter == byName_.end())
+		return false;
+	stats_.bytes -= iter->second->page->size();
+	entries_.erase(iter->second);
+	byName_.erase(iter);
+	return true;
+}
+
+void PageCache::clear()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	entries_.clear();
+	byName_.clear();
+	stats_.bytes = 0;
+}
+
+PageCache::Stats PageCache::stats() const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	Stats stats = stats_;
+	stats.pages = entries_.size();
+	return stats;
+}
+
+// -----< private - drop least recently used pages until under the bound >--
+
+void PageCache::evict()
+{
+	while (stats_.bytes > maxBytes_ && entries_.size() > 0)
+	{
+		stats_.bytes -= entries_.back().page->size();
+		byName_.erase(entries_.back().name);
+		entries_.pop_back();
+		++stats_.evictions;
+	}
+}
+
+// -----< size and modification time of a file, no hash >-------------------
+
+bool PageCache::stamp(const std::string& file, Stamp& stamp)
+{
+#ifdef _WIN32
+	struct _stat64 info;
+	if (::_stat64(file.c_str(), &info) != 0)
+		return false;
+	stamp.mtime = (int64_t)info.st_mtime;
+#else
+	struct stat info;
+	if (::stat(file.c_str(), &info) != 0)
+		return false;
+#ifdef __linux__
+	stamp.mtime = (int64_t)info.st_mtim.tv_sec * 1000000000 + info.st_mtim.tv_nsec;
+#else
+	stamp.mtime = (int64_t)info.st_mtime;
+#endif
+#endif
+	stamp.size = (uint64_t)info.st_size;
+	stamp.hash = 0;
+	return true;
+}
+
+// -----< FNV-1a hash of a file's content, never 0, 0 if unreadable >-------
+
+uint64_t PageCache::hash(const std::string& file)
+{
+	std::ifstream in(file, std::ios::binary);
+	if (!in.good())
+		return 0;
+	uint64_t hash = 14695981039346656037ull;
+	char buffer[64 * 1024];
+	while (in.read(buffer, sizeof(buffer)) || in.gcount() > 0)
+	{
+		std::streamsize count = in.gcount();
+		for (std::streamsize i = 0; i < count; ++i)
+		{
+			hash ^= (unsigned char)buffer[i];
+			hash *= 1099511628211ull;
+		}
+	}
+	return hash == 0 ? 1 : hash;
+}
+
+// -----< PageServer ctor - prepares the converter for files >--------------
+/*
+*  Builds the symbol table of all the files; no page is rendered yet.
+*/
+PageServer::PageServer(CodeConverter& converter, const Files& files) : converter_(converter)
+{
+	load(files);
+}
+
+PageServer::~PageServer()
+{
+	stop();
+}
+
+void PageServer::cacheBytes(size_t bytes)
+{
+	cache_.maxBytes(bytes);
+}
+
+void PageServer::workers(size_t count)
+{
+	workerCount_ = (std::max)(count, size_t(1));
+}
+
+void PageServer::staticDir(const std::string& dir)
+{
+	staticDir_ = dir;
+}
+
+// -----< listen on the loopback interface and start the workers >----------
+
+bool PageServer::start(unsigned short port)
+{
+	if (started_)
+		return true;
+#ifdef _WIN32
+	WSADATA data;
+	if (::WSAStartup(MAKEWORD(2, 2), &data) != 0)
+		return false;
+	SOCKET s = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	bool valid = s != INVALID_SOCKET;
+#else
+	int s = ::socket(AF_INET, SOCK_STREAM, 0);
+	bool valid = s >= 0;
+	int reuse = 1;
+	if (valid)
+		::setsockopt(s, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+#endif
+	sockaddr_in address = {};
+	address.sin_family = AF_INET;
+	address.sin_port = htons(port);
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	socklen_t length = sizeof(address);
+	if (!valid || ::bind(s, (sockaddr*)&address, sizeof(address)) != 0 ||
+		::listen(s, SOMAXCONN) != 0 || ::getsockname(s, (sockaddr*)&address, &length) != 0)
+	{
+		std::cout << "\n  can't listen on port " << port;
+		if (valid)
+			closeSocket((std::uintptr_t)s);
+#ifdef _WIN32
+		::WSACleanup();
+#endif
+		return false;
+	}
+	listener_ = (Socket)s;
+	port_ = ntohs(address.sin_port);
+	started_ = true;
+	stopping_ = false;
+	listenThread_ = std::thread(&PageServer::listen, this);
+	for (size_t i = 0; i < workerCount_; ++i)
+		workerThreads_.push_back(std::thread(&PageServer::work, this));
+	return true;
+}
+
+unsigned short PageServer::port() const
+{
+	return port_;
+}
+
+// -----< stop listening, let the workers finish, and close >---------------
+/*
+*  Connections already accepted are answered once more; idle ones are
+*  closed within stopCheckMs.
+*/
+void PageServer::stop()
+{
+	if (!started_)
+		return;
+	stopping_ = true;
+	listenThread_.join();
+	closeSocket(listener_);
+	for (size_t i = 0; i < workerThreads_.size(); ++i)
+		connections_.enQ(noSocket);
+	for (auto& worker : workerThreads_)
+		worker.join();
+	workerThreads_.clear();
+	started_ = false;
+#ifdef _WIN32
+	::WSACleanup();
+#endif
+}
+
+// -----< take changes a watcher reported into the tables >-----------------
+/*
+*  Files only touched, with the content the tables know, are skipped.
+*/
+void PageServer::sourcesChanged(const Files& changed, const Files& removed)
+{
+	std::lock_guard<std::mutex> lock(renderMutex_);
+	Files edits;
+	for (const auto& file : changed)
+	{
+		PageCache::Stamp now;
+		if (PageCache::stamp(file, now) && edited(file, now))
+			edits.push_back(file);
+	}
+	if (edits.size() > 0 || removed.size() > 0)
+		invalidate(edits, removed);
+}
+
+// -----< start again from the files of a full search >---------------------
+
+void PageServer::reload(const Files& files)
+{
+	std::lock_guard<std::mutex> lock(renderMutex_);
+	load(files);
+}
+
+PageServer::Stats PageServer::stats() const
+{
+	Stats stats;
+	stats.hits = hits_;
+	stats.renders = renders_;
+	stats.cache = cache_.stats();
+	return stats;
+}
+
+// -----< page with the name, rendered if not cached or stale >-------------
+/*
+*  A cached page whose source has the size and time it was rendered
+*  from is returned without taking the render lock.  After taking it,
+*  the cache is checked again, as another worker may have rendered the
+*  page meanwhile.
+*/
+PageCache::Page PageServer::page(const std::string& name)
+{
+	std::string file = sourceOf(name);
+	if (file.size() == 0)
+		return nullptr;
+
+	PageCache::Stamp now;
+	bool exists = PageCache::stamp(file, now);
+	PageCache::Stamp cached;
+	PageCache::Page page = cache_.find(name, &cached);
+	if (page && exists && cached.sameFile(now))
+	{
+		++hits_;
+		return page;
+	}
+
+	std::lock_guard<std::mutex> lock(renderMutex_);
+	if (!exists)
+	{
+		invalidate({}, { file });
+		return nullptr;
+	}
+	if (edited(file, now))
+		invalidate({ file }, {});
+	page = cache_.find(name, &cached);
+	if (page && cached.sameFile(now))
+	{
+		++hits_;
+		return page;
+	}
+
+	PageCache::Stamp& known = tableStamps_[file];
+	if (known.hash == 0)
+		known.hash = PageCache::hash(file);
+	std::string html = converter_.render(file);
+	if (html.size() == 0)
+		return nullptr;
+	++renders_;
+	page = std::make_shared<const std::string>(std::move(html));
+	cache_.insert(name, page, known);
+	return page;
+}
+
+// -----< html list of the pages, linked >----------------------------------
+
+std::string PageServer::index() const
+{
+	std::vector<std::string> names;
+	{
+		std::lock_guard<std::mutex> lock(namesMutex_);
+		names.reserve(sources_.size());
+		for (const auto& entry : sources_)
+			names.push_back(entry.first);
+	}
+	std::sort(names.begin(), names.end());
+	std::string html = "<!DOCTYPE html>\n<html>\n  <head>\n    <title>Code Publisher</title>\n  </head>\n";
+	html += "  <body style=\"font-family: Consolas;\">\n    <h3>" + std::to_string(names.size()) + " pages</h3>\n";
+	for (const auto& name : names)
+	{
+		std::string escaped = escapeHtml(name);
+		html += "    <a href=\"ConvertedWebpages/" + escaped + "\">" + escaped + "</a><br>\n";
+	}
+	html += "  </body>\n</html>\n";
+	return html;
+}
+
+// -----< private - the tables now know files, nothing is rendered >--------
+
+void PageServer::load(const Files& files)
+{
+	converter_.keepIdentifiers();
+	converter_.prepare(files);
+	{
+		std::lock_guard<std::mutex> lock(namesMutex_);
+		sources_.clear();
+		for (const auto& file : files)
+			sources_.emplace(pageName(file), file);
+	}
+	tableStamps_.clear();
+	for (const auto& file : files)
+		PageCache::stamp(file, tableStamps_[file]);
+	cache_.clear();
+}
+
+// -----< private - does file's content differ from what the tables know >--
+/*
+*  A file with the size and time the tables know is unchanged; so is one
+*  with the same hash, whose stamp is then refreshed.  Call with the
+*  render lock held.
+*/
+bool PageServer::edited(const std::string& file, PageCache::Stamp& now)
+{
+	auto iter = tableStamps_.find(file);
+	if (iter == tableStamps_.end())
+		return true;
+	if (iter->second.sameFile(now))
+		return false;
+	now.hash = PageCache::hash(file);
+	if (iter->second.hash == 0 || iter->second.hash != now.hash)
+		return true;
+	iter->second = now;
+	cache_.restamp(pageName(file), now);
+	return false;
+}
+
+// -----< private - tables updated, stale pages evicted >-------------------
+/*
+*  Call with the render lock held.
+*/
+void PageServer::invalidate(const Files& changed, const Files& removed)
+{
+	std::vector<std::string> stale = converter_.stalePages(changed, removed);
+	{
+		std::lock_guard<std::mutex> lock(namesMutex_);
+		for (const auto& file : removed)
+		{
+			tableStamps_.erase(file);
+			std::string name = pageName(file);
+			auto iter = sources_.find(name);
+			if (iter == sources_.end() || iter->second != file)
+				continue;
+			sources_.erase(iter);
+			for (const auto& entry : tableStamps_)
+			{
+				if (pageName(entry.first) == name)  // the page is another file's now
+				{
+					sources_[name] = entry.first;
+					break;
+				}
+			}
+		}
+		for (const auto& file : changed)
+		{
+			sources_.emplace(pageName(file), file);
+			PageCache::Stamp& known = tableStamps_[file];
+			PageCache::stamp(file, known);
+			known.hash = PageCache::hash(file);
+		}
+	}
+	for (const auto& file : removed)
+		cache_.erase(pageName(file));
+	for (const auto& file : stale)
+		cache_.erase(pageName(file));
+}
+
+std::string PageServer::sourceOf(const std::string& name) const
+{
+	std::lock_guard<std::mutex> lock(namesMutex_);
+	auto iter = sources_.find(name);
+	return iter == sources_.end() ? "" : iter->second;
+}
+
+// -----< private - name a page is requested by >---------------------------
+
+std::string PageServer::pageName(const std::string& file)
+{
+	return Path::getName(file) + ".html";
+}
+
+// -----< private - listener thread, queues connections for the workers >---
+
+void PageServer::listen()
+{
+	while (!stopping_)
+	{
+		if (!readable(listener_, stopCheckMs))
+			continue;
+#ifdef _WIN32
+		SOCKET connection = ::accept((SOCKET)listener_, nullptr, nullptr);
+		if (connection == INVALID_SOCKET)
+			continue;
+#else
+		int connection = ::accept((int)listener_, nullptr, nullptr);
+		if (connection < 0)
+			continue;
+#endif
+		connections_.enQ((Socket)connection);
+	}
+}
+
+// -----< private - worker thread, serves a connection at a time >----------
+
+void PageServer::work()
+{
+	while (true)
+	{
+		Socket connection = connections_.deQ();
+		if (connection == noSocket)
+			break;
+		try
+		{
+			serve(connection);
+		}
+		catch (...)  // respond answers 500 for what it can; nothing ends the worker
+		{
+		}
+		closeSocket(connection);
+	}
+}
+
+// -----< private - answer requests until the connection is done >----------
+/*
+*  Request bodies are not expected; each request is its header block.
+*/
+void PageServer::serve(Socket connection)
+{
+	std::string buffer;
+	char chunk[4096];
+	while (true)
+	{
+		size_t end;
+		while ((end = buffer.find("\r\n\r\n")) == std::string::npos)
+		{
+			if (buffer.size() > maxRequestBytes || !awaitRequest(connection))
+				return;
+			int count = ::recv((NativeSocket)connection, chunk, sizeof(chunk), 0);
+			if (count <= 0)
+				return;
+			buffer.append(chunk, count);
+		}
+		std::string request = buffer.substr(0, end + 2);
+		buffer.erase(0, end + 4);
+		if (!respond(connection, request) || stopping_)
+			return;
+	}
+}
+
+// -----< private - wait for the next request on a kept alive connection >--
+/*
+*  Gives up after idleMs, or sooner when other connections are waiting
+*  for a worker.
+*/
+bool PageServer::awaitRequest(Socket connection)
+{
+	for (int waited = 0; waited < idleMs; waited += stopCheckMs)
+	{
+		if (stopping_)
+			return false;
+		if (readable(connection, stopCheckMs))
+			return true;
+		if (connections_.size() > 0)
+			return false;
+	}
+	return false;
+}
+
+// -----< private - route one request and send the response >---------------
+/*
+*  Returns whether the connection is kept alive.
+*/
+bool PageServer::respond(Socket connection, const std::string& request)
+{
+	std::istringstream lines(request);
+	std::string method, target, version;
+	lines >> method >> target >> version;
+
+	bool keepAlive = version == "HTTP/1.1";
+	std::string line;
+	std::getline(lines, line);
+	while (std::getline(lines, line))
+	{
+		line = lower(line);
+		if (line.compare(0, 11, "connection:") != 0)
+			continue;
+		if (line.find("close") != std::string::npos)
+			keepAlive = false;
+		else if (line.find("keep-alive") != std::string::npos)
+			keepAlive = true;
+	}
+
+	std::string status = "200 OK";
+	std::string type = "text/html; charset=utf-8";
+	std::string extra;
+	PageCache::Page page;
+	std::string text;
+	std::string path = decode(target.substr(0, target.find('?')));
+	const std::string pagesDir = "/ConvertedWebpages/";
+	try
+	{
+		if (method.size() == 0 || version.compare(0, 5, "HTTP/") != 0)
+		{
+			status = "400 Bad Request";
+			keepAlive = false;
+		}
+		else if (target.size() == 0 || target[0] != '/')
+		{
+			status = "400 Bad Request";  // origin form only, the routes below assume a leading /
+			keepAlive = false;
+		}
+		else if (method != "GET" && method != "HEAD")
+		{
+			status = "405 Method Not Allowed";
+			extra = "Allow: GET, HEAD\r\n";
+		}
+		else if (path == "/" || path == "/index.html")
+			text = index();
+		else if (path.find_first_of("/\\", 1) == std::string::npos && assetType(path.substr(1)) != nullptr)
+		{
+			type = assetType(path.substr(1));  // pages include ../script.js, which is /script.js here
+			if (!readFile(Path::fileSpec(staticDir_, path.substr(1)), text))
+				status = "404 Not Found";
+		}
+		else if (path.compare(0, pagesDir.size(), pagesDir) == 0 &&
+			path.find_first_of("/\\", pagesDir.size()) == std::string::npos)
+		{
+			page = this->page(path.substr(pagesDir.size()));
+			if (!page)
+				status = "404 Not Found";
+		}
+		else
+			status = "404 Not Found";
+	}
+	catch (std::exception& ex)   // a page that fails to render fails only its request
+	{
+		std::cout << "\n  Error -- " << target << ": " << ex.what();
+		status = "500 Internal Server Error";
+		page = nullptr;
+		keepAlive = false;
+	}
+
+	if (status != "200 OK")
+	{
+		type = "text/plain; charset=utf-8";
+		text = status + "\n";
+	}
+	const std::string& body = page ? *page : text;
+	std::string header = "HTTP/1.1 " + status + "\r\n";
+	header += "Content-Type: " + type + "\r\n";
+	header += "Content-Length: " + std::to_string(body.size()) + "\r\n";
+	header += "Cache-Control: no-cache\r\n";
+	header += extra;
+	header += keepAlive ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n";
+	if (!sendAll(connection, header.data(), header.size()))
+		return false;
+	if (method != "HEAD" && !sendAll(connection, body.data(), body.size()))
+		return false;
+	return keepAlive;
+}
+
+#ifdef TEST_PAGESERVER
+
+// -----< demo client - one request, the response as text >----------------
+
+std::string get(unsigned short port, const std::string& target)
+{
+#ifdef _WIN32
+	SOCKET s = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+#else
+	int s = ::socket(AF_INET, SOCK_STREAM, 0);
+#endif
+	sockaddr_in address = {};
+	address.sin_family = AF_INET;
+	address.sin_port = htons(port);
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	std::string response;
+	if (::connect(s, (sockaddr*)&address, sizeof(address)) == 0)
+	{
+		std::string request = "GET " + target + " HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n";
+		sendAll((std::uintptr_t)s, request.data(), request.size());
+		char chunk[4096];
+		int count;
+		while ((count = ::recv(s, chunk, sizeof(chunk), 0)) > 0)
+			response.append(chunk, count);
+	}
+	closeSocket((std::uintptr_t)s);
+	return response;
+}
+
+void show(const std::string& target, const std::string& response)
+{
+	std::cout << "\n  GET " << target << " -- " << response.substr(0, response.find('\r'))
+		<< ", " << response.size() << " bytes";
+}
+
+// -----< test stub - serves files, edits one, and requests it again >------
+
+int main(int argc, char* argv[])
+{
+	std::cout << "\n  Demonstrating PageServer";
+	std::cout << "\n ==========================";
+
+	std::string edit = "PageServerDemo.h";
+	std::ofstream(edit) << "#pragma once\nclass Demo { };\n";
+	std::vector<std::string> files = { edit, "PageServer.h", "PageServer.cpp" };
+	for (int i = 1; i < argc; ++i)
+		files.push_back(argv[i]);
+
+	CodeConverter converter;
+	PageServer server(converter, files);
+	server.cacheBytes(1 << 20);
+	server.workers(2);
+	if (!server.start(0))
+		return 1;
+	unsigned short port = server.port();
+	std::cout << "\n  serving " << files.size() << " files at http://localhost:" << port << "/";
+
+	std::string response;
+	show("/", get(port, "/"));
+	show("/ConvertedWebpages/PageServer.h.html", get(port, "/ConvertedWebpages/PageServer.h.html"));
+	show("/ConvertedWebpages/PageServer.h.html", get(port, "/ConvertedWebpages/PageServer.h.html"));
+	show("/ConvertedWebpages/missing.h.html", get(port, "/ConvertedWebpages/missing.h.html"));
+	response = get(port, "?x");
+	show("?x", response);
+	bool refused = response.compare(0, 24, "HTTP/1.1 400 Bad Request") == 0;
+	std::cout << (refused ? " -- refused, the server runs on" : " -- not refused!");
+	show(edit, get(port, "/ConvertedWebpages/" + edit + ".html"));
+
+	std::string asset = "PageServerDemo.js";
+	std::ofstream(asset) << "function toggleVisibility(name) { }\n";
+	server.staticDir(".");
+	response = get(port, "/" + asset);
+	show("/" + asset, response);
+	bool served = response.find("toggleVisibility") != std::string::npos;
+	std::cout << (served ? " -- served from the static directory" : " -- not served!");
+	show("/" + edit, get(port, "/" + edit));
+	File::remove(asset);
+
+	std::ofstream(edit, std::ios::app) << "class Edited { };\n";
+	response = get(port, "/ConvertedWebpages/" + edit + ".html");
+	show(edit + " edited", response);
+	std::cout << (response.find("Edited") != std::string::npos ? " -- rendered again" : " -- stale!");
+
+	std::vector<std::thread> clients;
+	for (int i = 0; i < 4; ++i)
+		clients.push_back(std::thread([&]() { get(port, "/ConvertedWebpages/PageServer.cpp.html"); }));
+	for (auto& client : clients)
+		client.join();
+
+	PageServer::Stats stats = server.stats();
+	std::cout << "\n\n  " << stats.hits << " pages sent from the cache, " << stats.renders << " rendered";
+	std::cout << "\n  cache: " << stats.cache.pages << " pages, " << stats.cache.bytes << " bytes, "
+		<< stats.cache.evictions << " evictions";
+	server.stop();
+	File::remove(edit);
+	std::cout << "\n\n";
+	return served && refused ? 0 : 1;
+}
+
+#endif
@@ -0,0 +1,225 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////
+// PageServer.h  : serves webpages rendered when first requested         //
+// ver 1.2                                                               //
+//                                                                       //
+// Application   : Project Code Publisher                                //
+// Author        : Sneha Giranje                  						 //
+///////////////////////////////////////////////////////////////////////////
+/*
+*  Package Operations:
+* =======================
+*  This package defines PageServer, a minimal HTTP/1.1 server on the
+*  loopback interface that renders a source file's webpage the first
+*  time it is requested, instead of converting every file up front,
+*  and PageCache, the size bounded LRU cache holding the pages.
+*
+*  The server uses one CodeConverter, prepared with the symbol table and
+*  page names of all the files; a page's dependencies are parsed when it
+*  is first rendered.  The converter's tables are shared, so rendering
+*  is serialized, but pages found in the cache are served by all the
+*  workers at once.  A listener thread accepts connections and queues
+*  them for a small pool of workers; each worker reads requests from its
+*  connection until the client closes it or sends Connection: close.
+*
+*  Every cached page keeps the size, modification time and hash of its
+*  source as it was rendered.  A request checks the source's size and
+*  time: if they are unchanged the cached page is sent.  Otherwise the
+*  source is hashed, and only if its content changed is it taken into
+*  the converter's tables again, evicting its page and the pages it made
+*  stale - those linking to it or using a definition that moved.  Pages
+*  of other files are invalidated when a watcher reports changes, see
+*  sourcesChanged, or, failing that, when their own source is requested.
+*
+*  Routes:
+*    /                             index of the pages
+*    /ConvertedWebpages/name.html  page of the source file with the name
+*    /name.js, /name.css           files the pages include, as
+*                                  ../script.js, read from the static
+*                                  directory: by default .., the parent
+*                                  of the default output directory
+*  Only GET and HEAD are served, and only targets starting with /.  A
+*  request that fails while its page is rendered is answered 500; no
+*  single request stops the server.
+*
+*  Public Interface:
+* =======================
+*  PageServer server(converter, files);
+*  server.cacheBytes(64 << 20);     // before start
+*  server.workers(4);
+*  server.staticDir("..");          // parent of the pages' directory
+*  server.start(8080);              // 0 picks a free port
+*  server.port();
+*  server.sourcesChanged(changed, removed);
+*  server.reload(files);            // after a full search
+*  server.stats();                  // hits, renders and the cache's size
+*  server.stop();
+*
+*  PageCache cache(bytes);
+*  cache.insert(name, page, stamp);
+*  cache.find(name, &stamp);        // most recently used first
+*  cache.erase(name);
+*
+*  Required Files:
+* =======================
+*  PageServer.h PageServer.cpp Converter.h Converter.cpp
+*  DependencyTable.h DependencyTable.cpp SymbolTable.h SymbolTable.cpp
+*  FileSystem.h FileSystem.cpp Cpp11-BlockingQueue.h, and the parser
+*  packages the converter requires; Ws2_32.lib on Windows
+*
+*  Build Process:
+* =======================
+*  The PageServer project defines TEST_PAGESERVER in Debug|x64,
+*  building a demo that serves the given files, requests pages from
+*  itself and shows a page invalidated by an edit:
+*  PageServer [file]*
+*
+*  Maintainence History:
+* =======================
+*  ver 1.2 - 19 Oct 2026
+*  - targets not starting with / are answered 400, and an exception
+*    while a request is answered is a 500, not the end of the server
+*  ver 1.1 - 19 Oct 2026
+*  - any .js or .css file the pages include is served from the static
+*    directory, not only script.js
+*  ver 1.0 - 19 Oct 2026
+*  - first release
+*/
+
+#include "../Converter/Converter.h"
+#include "../CppParser/Cpp11-BlockingQueue/Cpp11-BlockingQueue.h"
+#include <string>
+#include <vector>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <cstdint>
+#include <unordered_map>
+
+///////////////////////////////////////////////////////////////////////////
+// PageCache class
+// - rendered pages by name, least recently used evicted first
+
+class PageCache
+{
+public:
+	using Page = std::shared_ptr<const std::string>;
+
+	// source of a page, as it was when the page was rendered
+	struct Stamp
+	{
+		int64_t mtime = 0;
+		uint64_t size = 0;
+		uint64_t hash = 0;   // of the content, 0 until needed
+		bool sameFile(const Stamp& other) const { return mtime == other.mtime && size == other.size; }
+	};
+
+	struct Stats
+	{
+		size_t pages = 0;
+		size_t bytes = 0;
+		size_t evictions = 0;
+	};
+
+	PageCache(size_t maxBytes = 64 << 20);
+
+	void maxBytes(size_t bytes);
+	Page find(const std::string& name, Stamp* pStamp = nullptr);
+	void insert(const std::string& name, const Page& page, const Stamp& stamp);
+	void restamp(const std::string& name, const Stamp& stamp);
+	bool erase(const std::string& name);
+	void clear();
+	Stats stats() const;
+
+	static bool stamp(const std::string& file, Stamp& stamp);
+	static uint64_t hash(const std::string& file);
+
+private:
+	struct Entry
+	{
+		std::string name;
+		Page page;
+		Stamp stamp;
+	};
+	void evict();
+
+	mutable std::mutex mutex_;
+	std::list<Entry> entries_;   // most recently used first
+	std::unordered_map<std::string, std::list<Entry>::iterator> byName_;
+	size_t maxBytes_;
+	Stats stats_;
+};
+
+///////////////////////////////////////////////////////////////////////////
+// PageServer class
+// - renders pages on request and serves them over HTTP/1.1
+
+class PageServer
+{
+public:
+	using Files = std::vector<std::string>;
+
+	struct Stats
+	{
+		size_t hits = 0;      // pages sent from the cache
+		size_t renders = 0;
+		PageCache::Stats cache;
+	};
+
+	PageServer(CodeConverter& converter, const Files& files);
+	~PageServer();
+
+	void cacheBytes(size_t bytes);
+	void workers(size_t count);
+	void staticDir(const std::string& dir);  // where the pages' scripts and styles are found
+
+	bool start(unsigned short port);
+	unsigned short port() const;
+	void stop();
+
+	void sourcesChanged(const Files& changed, const Files& removed);
+	void reload(const Files& files);
+	Stats stats() const;
+
+	PageCache::Page page(const std::string& name);   // null if there is none
+	std::string index() const;
+
+private:
+	using Socket = std::uintptr_t;
+
+	void load(const Files& files);
+	bool edited(const std::string& file, PageCache::Stamp& now);
+	void invalidate(const Files& changed, const Files& removed);
+	std::string sourceOf(const std::string& name) const;
+	static std::string pageName(const std::string& file);
+
+	void listen();
+	void work();
+	void serve(Socket connection);
+	bool awaitRequest(Socket connection);
+	bool respond(Socket connection, const std::string& request);
+
+	CodeConverter& converter_;
+	std::mutex renderMutex_;            // converter and tableStamps_
+	mutable std::mutex namesMutex_;     // sources_
+	std::unordered_map<std::string, std::string> sources_;  // page name to file
+	std::unordered_map<std::string, PageCache::Stamp> tableStamps_;  // file as the tables know it
+	PageCache cache_;
+	std::atomic<size_t> hits_{ 0 };
+	std::atomic<size_t> renders_{ 0 };
+	std::string staticDir_ = "..";
+
+	size_t workerCount_ = 4;
+	Socket listener_ = 0;
+	bool started_ = false;
+	unsigned short port_ = 0;
+	std::atomic<bool> stopping_{ false };
+	std::thread listenThread_;
+	std::vector<std::thread> workerThreads_;
+	Async::BlockingQueue<Socket> connections_;
+
+	PageServer(const PageServer&) = delete;
+	PageServer& operator=(const PageServer&) = delete;
+};
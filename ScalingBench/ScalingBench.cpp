@@ -0,0 +1,443 @@
+///////////////////////////////////////////////////////////////////////////
+// ScalingBench.cpp : end-to-end publish throughput - see ScalingBench.h //
+// ver 1.0                                                               //
+//                                                                       //
+// Author:      Sneha Giranje					                         //
+///////////////////////////////////////////////////////////////////////////
+
+#include "ScalingBench.h"
+#include "../Executive/IExecutive.h"
+#include "../Executive/Executive.h"
+#include "../CppParser/FileSystem/FileSystem.h"
+#include "../CppParser/PerfStats/PerfStats.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+using namespace FileSystem;
+
+namespace Scaling
+{
+	namespace
+	{
+#ifdef _WIN32
+		const char* nullDevice = "NUL";
+#else
+		const char* nullDevice = "/dev/null";
+#endif
+		// -----< wall seconds since start >-------------------------------------
+		double secondsSince(std::chrono::steady_clock::time_point start)
+		{
+			return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		}
+
+		// -----< one line chart of a measure, for each thread count >-----------
+		/* x is tree size on a log scale, y starts at zero */
+		void writeChart(std::ostream& out, const std::vector<RunResult>& results,
+			const std::string& title, const std::function<double(const RunResult&)>& measure)
+		{
+			const double width = 640, height = 360, left = 70, right = 110, top = 30, bottom = 40;
+			const char* colors[] = { "#1f77b4", "#d62728", "#2ca02c", "#ff7f0e", "#9467bd", "#8c564b" };
+
+			std::vector<size_t> threads;
+			double minX = 1e300, maxX = 0, maxY = 0;
+			for (const RunResult& r : results)
+			{
+				if (!r.ok)
+					continue;
+				if (std::find(threads.begin(), threads.end(), r.threads) == threads.end())
+					threads.push_back(r.threads);
+				minX = std::min(minX, std::log10(double(r.treeFiles)));
+				maxX = std::max(maxX, std::log10(double(r.treeFiles)));
+				maxY = std::max(maxY, measure(r));
+			}
+			if (threads.size() == 0)
+				return;
+			if (maxX <= minX)
+				maxX = minX + 1;
+			maxY = maxY > 0 ? maxY * 1.1 : 1;
+			auto x = [&](size_t files) { return left + (std::log10(double(files)) - minX) / (maxX - minX) * (width - left - right); };
+			auto y = [&](double value) { return height - bottom - value / maxY * (height - top - bottom); };
+
+			out << "<h3>" << title << "</h3>\n<svg width=\"" << width << "\" height=\"" << height
+				<< "\" font-family=\"sans-serif\" font-size=\"11\">\n"
+				<< "<line x1=\"" << left << "\" y1=\"" << height - bottom << "\" x2=\"" << width - right
+				<< "\" y2=\"" << height - bottom << "\" stroke=\"black\"/>\n"
+				<< "<line x1=\"" << left << "\" y1=\"" << top << "\" x2=\"" << left
+				<< "\" y2=\"" << height - bottom << "\" stroke=\"black\"/>\n";
+			for (int i = 0; i <= 4; ++i)
+			{
+				double value = maxY * i / 4;
+				out << "<text x=\"" << left - 6 << "\" y=\"" << y(value) + 4 << "\" text-anchor=\"end\">"
+					<< std::setprecision(3) << value << "</text>\n";
+			}
+			std::vector<size_t> sizes;
+			for (const RunResult& r : results)
+				if (r.ok && std::find(sizes.begin(), sizes.end(), r.treeFiles) == sizes.end())
+					sizes.push_back(r.treeFiles);
+			for (size_t files : sizes)
+				out << "<text x=\"" << x(files) << "\" y=\"" << height - bottom + 16
+					<< "\" text-anchor=\"middle\">" << files << "</text>\n";
+			out << "<text x=\"" << (left + width - right) / 2 << "\" y=\"" << height - 4
+				<< "\" text-anchor=\"middle\">files in tree</text>\n";
+
+			for (size_t t = 0; t < threads.size(); ++t)
+			{
+				const char* color = colors[t % (sizeof(colors) / sizeof(colors[0]))];
+				out << "<polyline fill=\"none\" stroke=\"" << color << "\" stroke-width=\"2\" points=\"";
+				for (const RunResult& r : results)
+					if (r.ok && r.threads == threads[t])
+						out << x(r.treeFiles) << "," << y(measure(r)) << " ";
+				out << "\"/>\n";
+				out << "<text x=\"" << width - right + 10 << "\" y=\"" << top + 16 * t + 10 << "\" fill=\""
+					<< color << "\">" << threads[t] << (threads[t] == 1 ? " thread" : " threads") << "</text>\n";
+			}
+			out << "</svg>\n";
+		}
+	}
+
+	// -----< ctor - harness writing trees and results below workDir >-------
+	ScalingHarness::ScalingHarness(const std::string& program, const std::string& workDir,
+		const TreeOptions& options) : program_(program), workDir_(workDir), options_(options) {}
+
+	void ScalingHarness::sizes(const std::vector<size_t>& sizes)
+	{
+		sizes_ = sizes;
+	}
+
+	void ScalingHarness::threads(const std::vector<size_t>& threads)
+	{
+		threads_ = threads;
+	}
+
+	// -----< keep published pages instead of removing them after a run >---
+	void ScalingHarness::keepOutput(bool keep)
+	{
+		keep_ = keep;
+	}
+
+	const std::vector<RunResult>& ScalingHarness::results() const
+	{
+		return results_;
+	}
+
+	std::string ScalingHarness::treeDir(size_t files) const
+	{
+		return Path::fileSpec(workDir_, "tree_" + std::to_string(files));
+	}
+
+	// -----< private - options a tree was made with, saved beside it >-----
+	std::string ScalingHarness::optionsLine(size_t files) const
+	{
+		std::ostringstream line;
+		line << "files " << files << " bytes " << options_.fileBytes << " depth " << options_.depth
+			<< " top " << options_.topDirs << " fanout " << options_.dirFanOut
+			<< " classes " << options_.classesPerFile << " functions " << options_.functionsPerClass
+			<< " includes " << options_.includeFanOut << " seed " << options_.seed;
+		return line.str();
+	}
+
+	// -----< private - generate a tree, unless the same one is there >------
+	/* tree.txt holds the options line, then the summary, and is written
+	   last, so a tree cut short by a crash is generated again */
+	bool ScalingHarness::ensureTree(size_t files, TreeSummary& summary)
+	{
+		std::string dir = treeDir(files);
+		std::string info = Path::fileSpec(dir, "tree.txt");
+		{
+			std::ifstream in(info);
+			std::string line;
+			if (std::getline(in, line) && line == optionsLine(files)
+				&& (in >> summary.files >> summary.bytes >> summary.dirs))
+			{
+				std::cout << "\n  Reusing " << dir;
+				return true;
+			}
+		}
+		removeTree(dir);
+		TreeOptions options = options_;
+		options.files = files;
+		std::cout << "\n  Generating " << files << " files in " << dir << std::flush;
+		summary = TreeGenerator(options).generate(dir);
+		if (summary.files != files)
+			return false;
+		std::ofstream out(info);
+		out << optionsLine(files) << "\n" << summary.files << " " << summary.bytes << " " << summary.dirs << "\n";
+		return out.good();
+	}
+
+	// -----< private - remove a directory and everything below it >--------
+	void ScalingHarness::removeTree(const std::string& dir)
+	{
+		Directory::Listing listing;
+		if (!Directory::list(dir, listing))
+			return;
+		for (const std::string& file : listing.files)
+			File::remove(Path::fileSpec(dir, file));
+		for (const std::string& sub : listing.dirs)
+			removeTree(Path::fileSpec(dir, sub));
+		Directory::remove(dir);
+	}
+
+	// -----< private - one measurement, in a child process >----------------
+	RunResult ScalingHarness::runChild(size_t files, size_t threads)
+	{
+		RunResult result;
+		std::string tag = std::to_string(files) + "_" + std::to_string(threads);
+		std::string out = Path::fileSpec(workDir_, "out_" + tag);
+		std::string resultFile = Path::fileSpec(workDir_, "result_" + tag + ".txt");
+		removeTree(out);
+		File::remove(resultFile);
+
+		std::string command = "\"" + program_ + "\" /child \"" + treeDir(files) + "\" \"" + out + "\" "
+			+ std::to_string(threads) + " \"" + resultFile + "\" > " + nullDevice + " 2>&1";
+#ifdef _WIN32
+		command = "\"" + command + "\"";  // cmd strips the outer quotes
+#endif
+		int status = std::system(command.c_str());
+		if (!readResult(resultFile, result) || status != 0)
+			result.ok = false;
+		result.treeFiles = files;
+		result.threads = threads;
+		File::remove(resultFile);
+		if (!keep_)
+			removeTree(out);
+		return result;
+	}
+
+	// -----< every tree size with every thread count >----------------------
+	bool ScalingHarness::run()
+	{
+		bool ok = true;
+		std::cout << "\n  " << std::setw(10) << "files" << std::setw(9) << "threads"
+			<< std::setw(11) << "wall s" << std::setw(11) << "cpu s" << std::setw(12) << "files/s"
+			<< std::setw(10) << "MB/s" << std::setw(13) << "peak RSS MB";
+		for (size_t files : sizes_)
+		{
+			TreeSummary summary;
+			if (!ensureTree(files, summary))
+			{
+				std::cout << "\n  Error -- unable to generate tree of " << files << " files";
+				ok = false;
+				continue;
+			}
+			for (size_t threads : threads_)
+			{
+				RunResult result = runChild(files, threads);
+				result.bytes = summary.bytes;
+				results_.push_back(result);
+				std::cout << "\n  " << std::setw(10) << files << std::setw(9) << threads;
+				if (!result.ok)
+				{
+					std::cout << "   publish failed";
+					ok = false;
+					continue;
+				}
+				std::cout << std::fixed << std::setprecision(2)
+					<< std::setw(11) << result.wallSec << std::setw(11) << result.cpuSec
+					<< std::setprecision(0) << std::setw(12) << result.filesPerSec()
+					<< std::setprecision(2) << std::setw(10) << result.mbPerSec()
+					<< std::setprecision(1) << std::setw(13) << result.peakRss / 1e6
+					<< std::defaultfloat << std::flush;
+			}
+		}
+		std::cout << "\n";
+		return ok;
+	}
+
+	// -----< child - publish tree with threads sharing its top directories >
+	RunResult ScalingHarness::publishTree(const std::string& tree, const std::string& out, size_t threads)
+	{
+		RunResult result;
+		result.threads = threads = std::max<size_t>(threads, 1);
+		Directory::Listing listing;
+		if (!Directory::exists(out))
+			Directory::create(out);
+		if (!Directory::list(tree, listing) || !Directory::exists(out))
+			return result;
+		std::vector<std::string> dirs = listing.dirs;
+		std::sort(dirs.begin(), dirs.end());
+
+		auto start = std::chrono::steady_clock::now();
+		uint64_t cpuStart = PerfStats::processCpuNs();
+		std::vector<size_t> published(threads, 0);
+		std::vector<char> failed(threads, 0);
+		auto work = [&](size_t t) {
+			for (size_t i = t; i < dirs.size(); i += threads)
+			{
+				std::vector<std::string> args = { "ScalingBench", Path::fileSpec(tree, dirs[i]),
+					"/s", "*.h", "*.cpp", "(.*)" };
+				std::vector<char*> argv;
+				for (std::string& arg : args)
+					argv.push_back(&arg[0]);
+				IExecutive* pExec = IExecutive::createProject();
+				if (!pExec->processCommandLineArgs((int)argv.size(), argv.data()))
+					failed[t] = 1;
+				else
+				{
+					pExec->outputDirectory(Path::fileSpec(out, dirs[i]) + "/");
+					if (pExec->extractFiles())
+					{
+						pExec->publish();
+						published[t] += pExec->getConvertedFiles().size();
+					}
+				}
+				delete pExec;
+			}
+		};
+		std::vector<std::thread> workers;
+		for (size_t t = 1; t < threads; ++t)
+			workers.emplace_back(work, t);
+		work(0);
+		for (std::thread& worker : workers)
+			worker.join();
+
+		result.wallSec = secondsSince(start);
+		result.cpuSec = (PerfStats::processCpuNs() - cpuStart) / 1e9;
+		result.peakRss = PerfStats::peakRssBytes();
+		for (size_t t = 0; t < threads; ++t)
+			result.published += published[t];
+		result.ok = std::find(failed.begin(), failed.end(), 1) == failed.end();
+		return result;
+	}
+
+	// -----< child's result, as one line the parent reads back >-----------
+	bool ScalingHarness::writeResult(const RunResult& result, const std::string& path)
+	{
+		std::ofstream out(path);
+		out << std::setprecision(9) << result.ok << " " << result.published << " " << result.wallSec
+			<< " " << result.cpuSec << " " << result.peakRss << "\n";
+		return out.good();
+	}
+
+	bool ScalingHarness::readResult(const std::string& path, RunResult& result)
+	{
+		std::ifstream in(path);
+		return bool(in >> result.ok >> result.published >> result.wallSec >> result.cpuSec >> result.peakRss);
+	}
+
+	// -----< results as CSV, one row per run >------------------------------
+	bool ScalingHarness::writeCsv(const std::string& path) const
+	{
+		std::ofstream out(path);
+		if (!out.good())
+			return false;
+		out << "files,threads,bytes,published,wallSec,cpuSec,filesPerSec,mbPerSec,peakRssMB,ok\n";
+		out << std::fixed;
+		for (const RunResult& r : results_)
+			out << r.treeFiles << "," << r.threads << "," << r.bytes << "," << r.published << ","
+				<< std::setprecision(3) << r.wallSec << "," << r.cpuSec << ","
+				<< std::setprecision(1) << r.filesPerSec() << "," << std::setprecision(3) << r.mbPerSec() << ","
+				<< std::setprecision(1) << r.peakRss / 1e6 << "," << (r.ok ? 1 : 0) << "\n";
+		return out.good();
+	}
+
+	// -----< results as an html page of charts, and the same table >--------
+	bool ScalingHarness::writePlot(const std::string& path) const
+	{
+		std::ofstream out(path);
+		if (!out.good())
+			return false;
+		out << "<!DOCTYPE html>\n<html>\n<head><title>Publisher scaling</title></head>\n"
+			<< "<body style=\"font-family: sans-serif\">\n<h2>Publisher scaling</h2>\n"
+			<< "<p>" << optionsLine(0).substr(optionsLine(0).find("bytes")) << "</p>\n";
+		writeChart(out, results_, "Throughput, files per second",
+			[](const RunResult& r) { return r.filesPerSec(); });
+		writeChart(out, results_, "Peak resident memory, MB",
+			[](const RunResult& r) { return r.peakRss / 1e6; });
+		out << "<h3>Runs</h3>\n<table border=\"1\" cellpadding=\"4\" style=\"border-collapse: collapse\">\n"
+			<< "<tr><th>files</th><th>threads</th><th>MB</th><th>wall s</th><th>cpu s</th>"
+			<< "<th>files/s</th><th>MB/s</th><th>peak RSS MB</th></tr>\n" << std::fixed;
+		for (const RunResult& r : results_)
+		{
+			out << "<tr><td>" << r.treeFiles << "</td><td>" << r.threads << "</td><td>"
+				<< std::setprecision(1) << r.bytes / 1e6 << "</td>";
+			if (!r.ok)
+			{
+				out << "<td colspan=\"5\">failed</td></tr>\n";
+				continue;
+			}
+			out << "<td>" << std::setprecision(2) << r.wallSec << "</td><td>" << r.cpuSec << "</td><td>"
+				<< std::setprecision(0) << r.filesPerSec() << "</td><td>" << std::setprecision(2) << r.mbPerSec()
+				<< "</td><td>" << std::setprecision(1) << r.peakRss / 1e6 << "</td></tr>\n";
+		}
+		out << "</table>\n</body>\n</html>\n";
+		return out.good();
+	}
+}
+
+#ifdef TEST_SCALINGBENCH
+
+using namespace Scaling;
+
+// -----< comma separated list of counts >-------------------------------------
+std::vector<size_t> counts(const std::string& list)
+{
+	std::vector<size_t> result;
+	std::istringstream in(list);
+	std::string item;
+	while (std::getline(in, item, ','))
+		if (item.size() > 0)
+			result.push_back(std::stoul(item));
+	return result;
+}
+
+// -----< harness main, or with /child one measured publish >------------------
+int main(int argc, char* argv[])
+{
+	if (argc == 6 && std::string(argv[1]) == "/child")
+	{
+		RunResult result = ScalingHarness::publishTree(argv[2], argv[3], std::stoul(argv[4]));
+		return ScalingHarness::writeResult(result, argv[5]) && result.ok ? 0 : 1;
+	}
+
+	std::string work = "../scaling";
+	std::vector<size_t> sizes = { 100, 1000, 10000 }, threads = { 1 };
+	bool keep = false;
+	std::vector<char*> treeArgs = { argv[0] };
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		if (arg == "/sizes" && i + 1 < argc)
+			sizes = counts(argv[++i]);
+		else if (arg == "/threads" && i + 1 < argc)
+			threads = counts(argv[++i]);
+		else if (arg == "/work" && i + 1 < argc)
+			work = argv[++i];
+		else if (arg == "/keep")
+			keep = true;
+		else
+			treeArgs.push_back(argv[i]);
+	}
+	TreeOptions options;
+	if (!options.parse((int)treeArgs.size(), treeArgs.data()))
+	{
+		std::cout << "\n  usage: ScalingBench [/sizes 100,1000,...] [/threads 1,2,...] [/work dir] [/keep]"
+			<< "\n                      [/bytes n] [/depth n] [/top n] [/fanout n] [/classes n]"
+			<< "\n                      [/functions n] [/includes n] [/seed n]\n\n";
+		return 1;
+	}
+	if (!Directory::exists(work))
+		Directory::create(work);
+
+	ScalingHarness harness(argv[0], work, options);
+	harness.sizes(sizes);
+	harness.threads(threads);
+	harness.keepOutput(keep);
+	bool ok = harness.run();
+	std::string csv = Path::fileSpec(work, "scaling.csv"), html = Path::fileSpec(work, "scaling.html");
+	if (harness.writeCsv(csv) && harness.writePlot(html))
+		std::cout << "\n  Results written to: " << csv << " and " << html << "\n\n";
+	else
+		std::cout << "\n  Error -- unable to write results to " << work << "\n\n";
+	return ok ? 0 : 1;
+}
+
+#endif
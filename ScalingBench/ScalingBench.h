@@ -0,0 +1,121 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////
+// ScalingBench.h : end-to-end publish throughput against tree size      //
+// ver 1.0                                                               //
+//                                                                       //
+// Application   : Project Code Publisher                                //
+// Author        : Sneha Giranje                  						 //
+///////////////////////////////////////////////////////////////////////////
+/*
+*  Package Operations:
+* =======================
+*  This package defines ScalingHarness, which measures how the publisher
+*  scales.  For each tree size it has TreeGenerator write a synthetic
+*  tree, reusing one left by an earlier run with the same options, and
+*  for each thread count it publishes the whole tree and records wall
+*  and CPU time, files and bytes per second, and peak resident memory.
+*
+*  Every measurement runs in a child process, started from this same
+*  program with /child, so peak memory belongs to that one publish and
+*  the console output of the publisher doesn't slow the parent.  The
+*  child shares the tree's top level directories among its threads and
+*  each thread runs, for each directory it was given, a project made by
+*  IExecutive::createProject() through extractFiles() and publish().
+*  One thread therefore publishes the directories one after another,
+*  so runs with different thread counts do the same work.  Pages link
+*  only to files within their own top level directory.
+*
+*  Results are written as scaling.csv and as scaling.html, which plots
+*  throughput and peak memory against tree size, one line per thread
+*  count.
+*
+*  Public Interface:
+* =======================
+*  ScalingHarness harness(argv[0], "../scaling", treeOptions);
+*  harness.sizes({ 100, 1000, 10000 });
+*  harness.threads({ 1, 2, 4 });
+*  harness.run();
+*  harness.writeCsv("../scaling/scaling.csv");
+*  harness.writePlot("../scaling/scaling.html");
+*  RunResult r = ScalingHarness::publishTree(tree, out, threads);  // in child
+*
+*  Required Files:
+* =======================
+*  ScalingBench.h ScalingBench.cpp TreeGenerator.h TreeGenerator.cpp
+*  IExecutive.h Executive.h Executive.cpp PerfStats.h PerfStats.cpp
+*  FileSystem.h FileSystem.cpp, and the packages Executive uses
+*
+*  Build Process:
+* =======================
+*  The ScalingBench project defines TEST_SCALINGBENCH, building:
+*  ScalingBench [/sizes 100,1000,...] [/threads 1,2,...] [/work dir] [/keep]
+*               [TreeGenerator options]
+*
+*  Maintainence History:
+* =======================
+*  ver 1.0 - 19 Oct 2026
+*  - first release
+*/
+
+#include "../TreeGenerator/TreeGenerator.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace Scaling
+{
+	struct RunResult
+	{
+		size_t treeFiles = 0;
+		size_t threads = 0;
+		uint64_t bytes = 0;          // of the tree's sources
+		size_t published = 0;        // pages written
+		double wallSec = 0;
+		double cpuSec = 0;
+		uint64_t peakRss = 0;        // bytes, of the child process
+		bool ok = false;
+
+		double filesPerSec() const { return wallSec > 0 ? treeFiles / wallSec : 0; }
+		double mbPerSec() const { return wallSec > 0 ? bytes / wallSec / 1e6 : 0; }
+	};
+
+	///////////////////////////////////////////////////////////////////////
+	// ScalingHarness class
+	// - publishes trees of each size with each thread count
+
+	class ScalingHarness
+	{
+	public:
+		ScalingHarness(const std::string& program, const std::string& workDir,
+			const TreeOptions& options);
+
+		void sizes(const std::vector<size_t>& sizes);
+		void threads(const std::vector<size_t>& threads);
+		void keepOutput(bool keep);
+
+		bool run();
+		const std::vector<RunResult>& results() const;
+		bool writeCsv(const std::string& path) const;
+		bool writePlot(const std::string& path) const;
+
+		// child side
+		static RunResult publishTree(const std::string& tree, const std::string& out, size_t threads);
+		static bool writeResult(const RunResult& result, const std::string& path);
+		static bool readResult(const std::string& path, RunResult& result);
+
+	private:
+		bool ensureTree(size_t files, TreeSummary& summary);
+		RunResult runChild(size_t files, size_t threads);
+		std::string treeDir(size_t files) const;
+		std::string optionsLine(size_t files) const;
+		static void removeTree(const std::string& dir);
+
+		std::string program_;
+		std::string workDir_;
+		TreeOptions options_;
+		std::vector<size_t> sizes_{ 100, 1000, 10000 };
+		std::vector<size_t> threads_{ 1 };
+		bool keep_ = false;
+		std::vector<RunResult> results_;
+	};
+}
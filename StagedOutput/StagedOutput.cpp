@@ -0,0 +1,405 @@
+///////////////////////////////////////////////////////////////////////////
+// StagedOutput.cpp : publishes an output directory as a whole           //
+// ver 1.0                                                               //
+//                                                                       //
+// Application   : Project Code Publisher                                //
+// Author        : Sneha Giranje                  						 //
+///////////////////////////////////////////////////////////////////////////
+
+#include "StagedOutput.h"
+#include "../CppParser/FileSystem/FileSystem.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+
+#ifndef _WIN32
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <climits>
+#include <cstdio>
+#endif
+
+using namespace FileSystem;
+
+namespace
+{
+	const char* generationTag = ".gen";
+
+#ifdef _WIN32
+	const char* defaultSep = "\\";
+	const int moveAttempts = 20;       // a file held open blocks a rename for a while
+	const std::chrono::milliseconds moveRetry(50);
+#else
+	const char* defaultSep = "/";
+#endif
+
+	// -----< number of a generation named prefix<digits>, or false >------
+	bool generationNumber(const std::string& name, const std::string& prefix, size_t& number)
+	{
+		if (name.size() <= prefix.size() || name.compare(0, prefix.size(), prefix) != 0)
+			return false;
+		number = 0;
+		for (size_t i = prefix.size(); i < name.size(); ++i)
+		{
+			if (!std::isdigit((unsigned char)name[i]))
+				return false;
+			number = number * 10 + (name[i] - '0');
+		}
+		return true;
+	}
+}
+
+// -----< StagedOutput ctor - the remover starts when first needed >--------
+
+StagedOutput::StagedOutput()
+{
+}
+
+// -----< drop an uncommitted generation, finish removing old ones >-------
+/*
+*  The live directory is already in place, so a process that publishes
+*  once and exits only waits here, after its pages are out.
+*/
+StagedOutput::~StagedOutput()
+{
+	abort();
+	if (remover_.joinable())
+	{
+		toRemove_.enQ("");
+		remover_.join();
+	}
+}
+
+// -----< fresh generation beside live, for the pages of a publish >--------
+/*
+*  Returns the staging directory, ending with a separator as live may,
+*  or "" if it can't be made.  A generation begun but not committed is
+*  dropped.
+*/
+std::string StagedOutput::begin(const std::string& live)
+{
+	abort();
+	place_ = place(live);
+	if (!Directory::exists(place_.parent))
+		Directory::create(place_.parent);
+	size_t number = nextGeneration(place_);
+	for (size_t attempt = 0; attempt < 100; ++attempt, ++number)
+	{
+		std::string name = place_.name + generationTag + std::to_string(number);
+		std::string dir = path(place_, name);
+		if (Directory::exists(dir))
+			continue;
+		Directory::create(dir);
+		if (!Directory::exists(dir))
+			break;
+		stagingName_ = name;
+		staging_ = dir + place_.sep;
+		return staging_;
+	}
+	return "";
+}
+
+// -----< staged generation replaces the live directory >-------------------
+/*
+*  On failure the live directory is as it was, and the staged pages are
+*  kept until the next begin.  On success the generations no longer live
+*  are queued for removal.
+*/
+bool StagedOutput::commit()
+{
+	if (staging_.size() == 0)
+		return false;
+	std::string live = path(place_, place_.name);
+	std::string staged = path(place_, stagingName_);
+#ifdef _WIN32
+	std::string retired;
+	if (Directory::exists(live))
+	{
+		retired = path(place_, place_.name + generationTag + std::to_string(nextGeneration(place_)));
+		if (!move(live, retired))
+			return false;
+	}
+	if (!move(staged, live))
+	{
+		if (retired.size() > 0)
+			move(retired, live);    // the old site goes back
+		return false;
+	}
+#else
+	std::string next = path(place_, place_.name + ".next");
+	::unlink(next.c_str());
+	if (::symlink(stagingName_.c_str(), next.c_str()) != 0)
+		return false;
+	struct stat info;
+	if (::lstat(live.c_str(), &info) == 0 && !S_ISLNK(info.st_mode))
+	{
+		// a directory published before staging is moved aside once
+		std::string retired = path(place_, place_.name + generationTag + std::to_string(nextGeneration(place_)));
+		if (!move(live, retired))
+		{
+			::unlink(next.c_str());
+			return false;
+		}
+	}
+	if (!move(next, live))   // replaces the old link in one step
+	{
+		::unlink(next.c_str());
+		return false;
+	}
+#endif
+	staging_.clear();
+	stagingName_.clear();
+	reclaim(live);
+	return true;
+}
+
+// -----< remove the generation begun, if not committed >-------------------
+
+void StagedOutput::abort()
+{
+	if (staging_.size() == 0)
+		return;
+	removeTree(path(place_, stagingName_));
+	staging_.clear();
+	stagingName_.clear();
+}
+
+const std::string& StagedOutput::staging() const
+{
+	return staging_;
+}
+
+// -----< queue generations of live that are no longer live for removal >--
+/*
+*  Only directories named live.gen<number> are removed, never the one
+*  live links to, nor one being staged.
+*/
+void StagedOutput::reclaim(const std::string& live)
+{
+	Place where = place(live);
+	std::string current = liveGeneration(where);
+	std::string prefix = where.name + generationTag;
+	Directory::Listing listing;
+	if (!Directory::list(where.parent, listing))
+		return;
+	for (const auto& name : listing.dirs)
+	{
+		size_t number;
+		if (!generationNumber(name, prefix, number) || name == current)
+			continue;
+		if (name == stagingName_ && where.parent == place_.parent)
+			continue;
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			++pending_;
+		}
+		if (!remover_.joinable())
+			remover_ = std::thread(&StagedOutput::remove, this);
+		toRemove_.enQ(path(where, name));
+	}
+}
+
+// -----< until the generations queued so far are removed >----------------
+
+void StagedOutput::waitForReclaim()
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+	removed_.wait(lock, [this]() { return pending_ == 0; });
+}
+
+// -----< remove a directory and everything below it >----------------------
+/*
+*  Links found in the tree are removed, not followed.
+*/
+bool StagedOutput::removeTree(const std::string& dir)
+{
+	Directory::Listing listing;
+	if (!Directory::list(dir, listing))
+		return !Directory::exists(dir);
+	for (const auto& name : listing.files)
+		File::remove(Path::fileSpec(dir, name));
+	for (const auto& name : listing.dirs)
+	{
+		std::string sub = Path::fileSpec(dir, name);
+#ifdef _WIN32
+		DWORD attributes = ::GetFileAttributesA(sub.c_str());
+		if (attributes != INVALID_FILE_ATTRIBUTES && (attributes & FILE_ATTRIBUTE_REPARSE_POINT))
+		{
+			::RemoveDirectoryA(sub.c_str());
+			continue;
+		}
+#else
+		struct stat info;
+		if (::lstat(sub.c_str(), &info) == 0 && S_ISLNK(info.st_mode))
+		{
+			::unlink(sub.c_str());
+			continue;
+		}
+#endif
+		removeTree(sub);
+	}
+	Directory::remove(dir);
+	return !Directory::exists(dir);
+}
+
+// -----< private - parent, name and separator of a live path >-------------
+
+StagedOutput::Place StagedOutput::place(const std::string& live)
+{
+	Place where;
+	std::string trimmed = live;
+	while (trimmed.size() > 1 && (trimmed.back() == '/' || trimmed.back() == '\\'))
+		trimmed.pop_back();
+	size_t pos = trimmed.find_last_of("/\\");
+	if (live.size() > trimmed.size())
+		where.sep = live.substr(trimmed.size(), 1);
+	else if (pos != std::string::npos)
+		where.sep = trimmed.substr(pos, 1);
+	else
+		where.sep = defaultSep;
+	where.parent = pos == std::string::npos ? "." : trimmed.substr(0, (std::max)(pos, size_t(1)));
+	where.name = pos == std::string::npos ? trimmed : trimmed.substr(pos + 1);
+	return where;
+}
+
+std::string StagedOutput::path(const Place& where, const std::string& name)
+{
+	return where.parent + where.sep + name;
+}
+
+// -----< private - name of the generation the live path links to >--------
+/*
+*  On Windows the live directory is the generation itself, so "".
+*/
+std::string StagedOutput::liveGeneration(const Place& where)
+{
+#ifdef _WIN32
+	return "";
+#else
+	char target[PATH_MAX];
+	ssize_t length = ::readlink(path(where, where.name).c_str(), target, sizeof(target) - 1);
+	if (length <= 0)
+		return "";
+	std::string name(target, length);
+	size_t pos = name.find_last_of('/');
+	return pos == std::string::npos ? name : name.substr(pos + 1);
+#endif
+}
+
+// -----< private - one more than the highest generation found >-----------
+
+size_t StagedOutput::nextGeneration(const Place& where)
+{
+	Directory::Listing listing;
+	Directory::list(where.parent, listing);
+	std::string prefix = where.name + generationTag;
+	size_t next = 1;
+	for (const auto& name : listing.dirs)
+	{
+		size_t number;
+		if (generationNumber(name, prefix, number) && number >= next)
+			next = number + 1;
+	}
+	return next;
+}
+
+// -----< private - rename a directory or link >----------------------------
+
+bool StagedOutput::move(const std::string& from, const std::string& to)
+{
+#ifdef _WIN32
+	for (int attempt = 0; attempt < moveAttempts; ++attempt)
+	{
+		if (::MoveFileExA(from.c_str(), to.c_str(), 0) != 0)
+			return true;
+		std::this_thread::sleep_for(moveRetry);
+	}
+	return false;
+#else
+	return ::rename(from.c_str(), to.c_str()) == 0;
+#endif
+}
+
+// -----< private - remover thread, removes queued generations >------------
+
+void StagedOutput::remove()
+{
+	while (true)
+	{
+		std::string dir = toRemove_.deQ();
+		if (dir.size() == 0)
+			break;
+		removeTree(dir);
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			--pending_;
+		}
+		removed_.notify_all();
+	}
+}
+
+#ifdef TEST_STAGEDOUTPUT
+
+#include <iostream>
+#include <fstream>
+
+// -----< show what the live directory holds >------------------------------
+
+void show(const std::string& live)
+{
+	std::vector<std::string> files = Directory::getFiles(live);
+	std::cout << "\n    " << live << " holds";
+	for (const auto& file : files)
+	{
+		std::ifstream in(Path::fileSpec(live, file));
+		std::string line;
+		std::getline(in, line);
+		std::cout << " " << file << " (" << line << ")";
+	}
+}
+
+// -----< test stub - publish three generations, reading between them >-----
+
+int main(int argc, char* argv[])
+{
+	std::cout << "\n  Demonstrating StagedOutput";
+	std::cout << "\n ============================";
+
+	std::string live = argc > 1 ? argv[1] : "StagedOutputDemo";
+	StagedOutput stage;
+	for (int generation = 1; generation <= 3; ++generation)
+	{
+		std::string dir = stage.begin(live);
+		if (dir.size() == 0)
+		{
+			std::cout << "\n  can't stage " << live << "\n\n";
+			return 1;
+		}
+		std::cout << "\n\n  publishing into " << dir;
+		for (int page = 0; page < generation; ++page)
+			std::ofstream(dir + "page" + std::to_string(page) + ".html") << "generation " << generation;
+		std::cout << "\n  commit " << (stage.commit() ? "succeeded" : "failed");
+		show(live);
+	}
+
+	std::string dir = stage.begin(live);
+	std::ofstream(dir + "unfinished.html") << "never seen";
+	stage.abort();
+	std::cout << "\n\n  aborted " << dir << ", " << (Directory::exists(dir) ? "still there" : "removed");
+	show(live);
+
+	stage.waitForReclaim();
+	Directory::Listing listing;
+	Directory::list(".", listing);
+	std::cout << "\n\n  left beside " << live << " after reclaiming:";
+	for (const auto& name : listing.dirs)
+	{
+		if (name.compare(0, live.size(), live) == 0)
+			std::cout << " " << name;
+	}
+	std::cout << "\n\n";
+	return 0;
+}
+
+#endif
@@ -0,0 +1,115 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////
+// StagedOutput.h : publishes an output directory as a whole, atomically //
+// ver 1.0                                                               //
+//                                                                       //
+// Application   : Project Code Publisher                                //
+// Author        : Sneha Giranje                  						 //
+///////////////////////////////////////////////////////////////////////////
+/*
+*  Package Operations:
+* =======================
+*  This package defines StagedOutput, which lets a publish write its
+*  pages into a fresh staging directory and then put that directory in
+*  place of the live one in a single step, so readers never see an
+*  empty or half written site, and nothing has to be deleted first.
+*
+*  Each publish is a generation, a sibling of the live directory named
+*  after it: ../ConvertedWebpages.gen7 for ../ConvertedWebpages.
+*
+*  On POSIX the live path is a symbolic link to the current generation.
+*  commit makes a new link to the staged generation and renames it over
+*  the live path, which replaces the old link atomically.  A live path
+*  that is still a real directory, from before staging, is first moved
+*  aside as an old generation.
+*
+*  On Windows a directory link can't be replaced atomically, so commit
+*  renames the live directory aside and the staged one into its place:
+*  for the moment between the two renames the path is missing, but it
+*  is never incomplete.  A rename that fails, as when a file in the
+*  live directory is held open, is retried for a short while.
+*
+*  Generations that are no longer live are removed by a background
+*  thread, started when there is first something to remove, so a
+*  publish takes no delete pass.  The StagedOutput's destructor waits
+*  for the removals already queued.
+*  Only one StagedOutput should publish to a live directory at a time.
+*
+*  Public Interface:
+* =======================
+*  StagedOutput stage;
+*  std::string dir = stage.begin("../ConvertedWebpages/");  // write here
+*  stage.commit();         // dir is live, old generations are reclaimed
+*  stage.abort();          // or drop the staged generation
+*  stage.reclaim(live);    // remove generations no longer live
+*  stage.waitForReclaim(); // until the queued removals are done
+*
+*  Required Files:
+* =======================
+*  StagedOutput.h StagedOutput.cpp FileSystem.h FileSystem.cpp
+*  Cpp11-BlockingQueue.h
+*
+*  Build Process:
+* =======================
+*  The StagedOutput project defines TEST_STAGEDOUTPUT in Debug|x64,
+*  building a demo that publishes three generations of a directory:
+*  StagedOutput [dir]
+*
+*  Maintainence History:
+* =======================
+*  ver 1.0 - 19 Oct 2026
+*  - first release
+*/
+
+#include "../CppParser/Cpp11-BlockingQueue/Cpp11-BlockingQueue.h"
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace FileSystem
+{
+	class StagedOutput
+	{
+	public:
+		StagedOutput();
+		~StagedOutput();
+
+		std::string begin(const std::string& live);
+		bool commit();
+		void abort();
+		const std::string& staging() const;
+
+		void reclaim(const std::string& live);
+		void waitForReclaim();
+
+		static bool removeTree(const std::string& dir);
+
+	private:
+		struct Place
+		{
+			std::string parent;   // directory holding the live path
+			std::string name;     // of the live path
+			std::string sep;      // separator the caller uses
+		};
+		static Place place(const std::string& live);
+		static std::string path(const Place& place, const std::string& name);
+		static std::string liveGeneration(const Place& place);
+		static size_t nextGeneration(const Place& place);
+		static bool move(const std::string& from, const std::string& to);
+		void remove();
+
+		Place place_;
+		std::string staging_;        // staged generation, with separator
+		std::string stagingName_;
+
+		Async::BlockingQueue<std::string> toRemove_;
+		std::thread remover_;
+		std::mutex mutex_;
+		std::condition_variable removed_;
+		size_t pending_ = 0;         // queued and not yet removed
+
+		StagedOutput(const StagedOutput&) = delete;
+		StagedOutput& operator=(const StagedOutput&) = delete;
+	};
+}
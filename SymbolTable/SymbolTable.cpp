@@ -0,0 +1,519 @@
+///////////////////////////////////////////////////////////////////////////
+// SymbolTable.cpp : defines SymbolTable.h functions                     //
+// ver 1.5                                                               //
+//                                                                       //
+// Author:      Sneha Giranje					                         //
+///////////////////////////////////////////////////////////////////////////
+
+#include "SymbolTable.h"
+#include <cctype>
+#include <algorithm>
+#include <unordered_set>
+#include <fstream>
+#include <functional>
+#include "../CppParser/FileSystem/FileSystem.h"
+
+#include "../CppParser/AbstractSyntaxTree/AbstrSynTree.h"
+#include "../CppParser/Parser/ConfigureParser.h"
+#include "../CppParser/Parser/ActionsAndRules.h"
+#include "../CppParser/Utilities/Utilities.h"
+#include "../CppParser/PerfStats/PerfStats.h"
+#define Util StringHelper
+
+using namespace CodeAnalysis;
+using namespace Utilities1;
+
+namespace
+{
+  const size_t maxHeaderLines = 16;  // from a definition's name to its brace
+
+  bool isIdentifierChar(char ch)
+  {
+    return std::isalnum((unsigned char)ch) || ch == '_';
+  }
+
+  // -----< position of name as a whole word in text, npos if absent >-----
+  /* a function's name must be followed by its parameter list */
+  size_t findName(const std::string& text, const std::string& name, bool isFunction)
+  {
+    size_t pos = 0;
+    while ((pos = text.find(name, pos)) != text.npos) {
+      size_t end = pos + name.size();
+      bool whole = (pos == 0 || !isIdentifierChar(text[pos - 1])) &&
+        (end == text.size() || !isIdentifierChar(text[end]));
+      if (whole && isFunction) {
+        size_t next = text.find_first_not_of(" \t", end);
+        whole = (next != text.npos && text[next] == '(');
+      }
+      if (whole)
+        return pos;
+      pos = end;
+    }
+    return text.npos;
+  }
+
+  // -----< line of a definition's name, searching back from its brace >--
+  /* falls back to the brace's line if the name isn't found near it */
+  size_t nameLine(const std::vector<std::string>& lines, const std::string& name,
+    bool isFunction, size_t braceLine)
+  {
+    size_t last = (std::min)(braceLine, lines.size());
+    for (size_t line = last; line > 0 && line + maxHeaderLines > last; --line) {
+      if (findName(lines[line - 1], name, isFunction) != std::string::npos)
+        return line;
+    }
+    return braceLine;
+  }
+
+  // -----< class named before a member's name, as X in X::name, or "" >-
+  /* template arguments of the class, as in X<T>::name, are skipped */
+  std::string qualifierOf(const std::string& text, const std::string& name)
+  {
+    size_t pos = findName(text, name, true);
+    if (pos == text.npos || pos == 0)
+      return "";
+    size_t end = text.find_last_not_of(" \t", pos - 1);
+    if (end == text.npos || end < 2 || text.compare(end - 1, 2, "::") != 0)
+      return "";
+    end = text.find_last_not_of(" \t", end - 2);
+    if (end != text.npos && text[end] == '>') {
+      size_t depth = 0;
+      for (; end != text.npos; --end) {
+        if (text[end] == '>')
+          ++depth;
+        else if (text[end] == '<' && --depth == 0)
+          break;
+        if (end == 0)
+          return "";
+      }
+      if (end == text.npos || end == 0)
+        return "";
+      end = text.find_last_not_of(" \t", end - 1);
+    }
+    if (end == text.npos || !isIdentifierChar(text[end]))
+      return "";
+    size_t start = end + 1;
+    while (start > 0 && isIdentifierChar(text[start - 1]))
+      --start;
+    return text.substr(start, end + 1 - start);
+  }
+
+  std::vector<std::string> readLines(const std::string& filename)
+  {
+    std::vector<std::string> lines;
+    std::ifstream in(filename);
+    std::string line;
+    while (std::getline(in, line))
+      lines.push_back(line);
+    return lines;
+  }
+}
+
+// -----< default ctor >---------------------------------------------------
+SymbolTable::SymbolTable() {}
+
+// -----< files initializer ctor >-----------------------------------------
+/* collects the definitions of every file in the list */
+SymbolTable::SymbolTable(const files & list)
+{
+  for (auto& file : list)
+    getFileSymbols(file);
+}
+
+// -----< has function - searches map for given symbol >-------------------
+bool SymbolTable::has(const symbol & name) const
+{
+  return table_.find(name) != table_.end();
+}
+
+// -----< find definition - returns nullptr if symbol is unknown >---------
+/* name is a key: Class::member for a member, the name alone otherwise */
+const SymbolTable::Definition* SymbolTable::find(const symbol & name) const
+{
+  auto iter = table_.find(name);
+  if (iter == table_.end())
+    return nullptr;
+  return &iter->second;
+}
+
+// -----< definition an identifier names, given the qualifier before it >-
+/* with a qualifier naming a class, only that class's member; with one
+   naming anything else, e.g. a namespace, only a definition at namespace
+   scope. An unqualified name is a definition at namespace scope, or a
+   member of the one class defining the name - when several classes do,
+   which is meant can't be told here, and nullptr is returned. X::X, a
+   constructor, names its class, as constructors do in addDefinition */
+const SymbolTable::Definition* SymbolTable::lookup(const symbol & name, const symbol & qualifier) const
+{
+  if (qualifier == name)
+    return lookup(name);
+  if (qualifier.size() > 0) {
+    const Definition* pDef = find(qualifier + "::" + name);
+    if (pDef != nullptr || isType(qualifier))
+      return pDef;
+    return find(name);
+  }
+  const Definition* pDef = find(name);
+  if (pDef != nullptr)
+    return pDef;
+  auto iter = members_.find(name);
+  if (iter == members_.end() || iter->second.size() != 1)
+    return nullptr;
+  return find(iter->second[0]);
+}
+
+// -----< name of a definition, without its class >-----------------------
+SymbolTable::symbol SymbolTable::nameOf(const symbol & key)
+{
+  size_t pos = key.rfind("::");
+  return pos == key.npos ? key : key.substr(pos + 2);
+}
+
+// -----< add definition - types win over functions of the same name >----
+/* the first definition of a name is kept, except that a class, struct or
+   interface replaces a function, so constructors link to their class */
+void SymbolTable::addDefinition(const symbol & name, const Definition & def)
+{
+  auto iter = table_.find(name);
+  if (iter == table_.end()) {
+    put(name, def);
+    return;
+  }
+  if (iter->second.type_ == "function" && def.type_ != "function")
+    iter->second = def;
+}
+
+// -----< walk AST collecting named definitions >--------------------------
+void SymbolTable::addSymbols(ASTNode * pGlobalScope, const file & filename)
+{
+  fileDefinitions defs;
+  collect(pGlobalScope, filename, defs);
+  size_t id = fileId(filename);
+  for (auto& def : defs)
+    addDefinition(def.first, def.second);
+  fileDefinitions& kept = byFile_[id];
+  kept.insert(kept.end(), defs.begin(), defs.end());
+  index(id);
+}
+
+// -----< parses file and adds its definitions to the table >--------------
+void SymbolTable::getFileSymbols(file filename)
+{
+  fileDefinitions defs;
+  if (!parseFile(filename, defs))
+    return;
+  size_t id = fileId(filename);
+  for (auto& def : defs)
+    addDefinition(def.first, def.second);
+  fileDefinitions& kept = byFile_[id];
+  kept.insert(kept.end(), defs.begin(), defs.end());
+  index(id);
+}
+
+// -----< parses file again, returns names whose definition changed >-----
+/* a file that can't be read no longer defines anything */
+std::vector<SymbolTable::symbol> SymbolTable::updateFile(const file & filename)
+{
+  fileDefinitions defs;
+  parseFile(filename, defs);
+  size_t id = fileId(filename);
+  std::vector<symbol> names = unindex(id);
+  byFile_[id].swap(defs);
+  for (auto& def : byFile_[id])
+    names.push_back(def.first);
+  index(id);
+  return settle(names);
+}
+
+// -----< drops file's definitions, returns names that changed >-----------
+std::vector<SymbolTable::symbol> SymbolTable::removeFile(const file & filename)
+{
+  auto iter = ids_.find(filename);
+  if (iter == ids_.end())
+    return std::vector<symbol>();
+  size_t id = iter->second;
+  ids_.erase(iter);
+  std::vector<symbol> names = unindex(id);
+  byFile_[id].clear();
+  return settle(names);
+}
+
+void SymbolTable::clear()
+{
+  table_.clear();
+  members_.clear();
+  ids_.clear();
+  byFile_.clear();
+  definedIn_.clear();
+}
+
+// -----< private - parse file collecting its definitions >----------------
+bool SymbolTable::parseFile(const file & filename, fileDefinitions & defs)
+{
+  PerfStats::Timer timer(PerfStats::symbols, filename);
+  std::string fileSpec = FileSystem::Path::getFullFileSpec(filename);
+  std::string name;
+  ParserPool::Lease lease = ParserPool::forThisThread().acquire();
+  Parser* pParser = lease->parser();
+
+  try {
+    if (pParser) {
+      name = FileSystem::Path::getName(filename);
+      if (!lease->Attach(fileSpec)) {
+        std::cout << "\n  could not open file " << name << std::endl;
+        return false;
+      }
+    }
+    else {
+      std::cout << "\n\n  Parser not built\n\n";
+      return false;
+    }
+    Repository* pRepo = lease->repository();
+    pRepo->package() = name;
+    while (pParser->next())
+      pParser->parse();
+    collect(pRepo->getGlobalScope(), filename, defs);
+    return true;
+  }
+  catch (std::exception& ex) {
+    std::cout << "\n\n    " << ex.what() << "\n\n";
+    return false;
+  }
+}
+
+// -----< private - named definitions of an AST, in the order walked >-----
+/* the parser gives the line of a definition's opening brace, so the line
+   of its name is found in the source, above or on the brace's line. A
+   member is keyed Class::name, by the class it is declared in, or for a
+   function defined outside its class, by the qualifier before its name */
+void SymbolTable::collect(ASTNode * pGlobalScope, const file & filename, fileDefinitions & defs)
+{
+  std::vector<std::string> lines = readLines(filename);
+  std::function<void(ASTNode*, const std::string&)> walk = [&](ASTNode* pScope, const std::string& scope) {
+    for (ASTNode* pNode : pScope->children_) {
+      const std::string& type = pNode->type_;
+      bool isClass = (type == "class" || type == "struct" || type == "interface");
+      if ((isClass || type == "function") && isIdentifier(pNode->name_)) {
+        Definition def;
+        def.file_ = filename;
+        def.type_ = type;
+        def.line_ = nameLine(lines, pNode->name_, !isClass, pNode->startLineCount_);
+        def.scope_ = scope;
+        if (scope.size() == 0 && !isClass && def.line_ <= lines.size())
+          def.scope_ = qualifierOf(lines[def.line_ - 1], pNode->name_);
+        defs.emplace_back(def.scope_.size() > 0 ? def.scope_ + "::" + pNode->name_ : pNode->name_, def);
+      }
+      if (isClass)
+        walk(pNode, pNode->name_);
+      else
+        walk(pNode, type == "namespace" ? "" : scope);
+    }
+  };
+  walk(pGlobalScope, "");
+}
+
+// -----< private - position of file in the order files were added >------
+size_t SymbolTable::fileId(const file & filename)
+{
+  auto iter = ids_.find(filename);
+  if (iter != ids_.end())
+    return iter->second;
+  size_t id = byFile_.size();
+  ids_[filename] = id;
+  byFile_.emplace_back();
+  return id;
+}
+
+// -----< private - note the names file id defines >-----------------------
+void SymbolTable::index(size_t id)
+{
+  for (auto& def : byFile_[id]) {
+    std::vector<size_t>& ids = definedIn_[def.first];
+    auto pos = std::lower_bound(ids.begin(), ids.end(), id);
+    if (pos == ids.end() || *pos != id)
+      ids.insert(pos, id);
+  }
+}
+
+// -----< private - forget the names file id defines, returns them >------
+std::vector<SymbolTable::symbol> SymbolTable::unindex(size_t id)
+{
+  std::vector<symbol> names;
+  for (auto& def : byFile_[id]) {
+    names.push_back(def.first);
+    auto iter = definedIn_.find(def.first);
+    if (iter == definedIn_.end())
+      continue;
+    std::vector<size_t>& ids = iter->second;
+    ids.erase(std::remove(ids.begin(), ids.end(), id), ids.end());
+    if (ids.empty())
+      definedIn_.erase(iter);
+  }
+  return names;
+}
+
+// -----< private - choose each name's definition again >------------------
+/* replays addDefinition over the files defining the name, in the order
+   they were added, so the table is as a full build would make it */
+std::vector<SymbolTable::symbol> SymbolTable::settle(const std::vector<symbol>& names)
+{
+  std::vector<symbol> changed;
+  std::unordered_set<symbol> seen;
+  for (const auto& name : names) {
+    if (!seen.insert(name).second)
+      continue;
+    const Definition* pChosen = nullptr;
+    auto iter = definedIn_.find(name);
+    if (iter != definedIn_.end()) {
+      for (size_t id : iter->second) {
+        for (const auto& def : byFile_[id]) {
+          if (def.first != name)
+            continue;
+          if (pChosen == nullptr || (pChosen->type_ == "function" && def.second.type_ != "function"))
+            pChosen = &def.second;
+        }
+      }
+    }
+    auto entry = table_.find(name);
+    if (pChosen == nullptr) {
+      if (entry != table_.end()) {
+        drop(name);
+        changed.push_back(name);
+      }
+      continue;
+    }
+    if (entry != table_.end() && entry->second.file_ == pChosen->file_ &&
+      entry->second.type_ == pChosen->type_ && entry->second.line_ == pChosen->line_)
+      continue;
+    put(name, *pChosen);
+    changed.push_back(name);
+  }
+  return changed;
+}
+
+// -----< private - enter a definition, noting the names of members >-----
+void SymbolTable::put(const symbol & key, const Definition & def)
+{
+  if (def.scope_.size() > 0 && table_.find(key) == table_.end())
+    members_[nameOf(key)].push_back(key);
+  table_[key] = def;
+}
+
+// -----< private - remove a definition >----------------------------------
+void SymbolTable::drop(const symbol & key)
+{
+  auto iter = members_.find(nameOf(key));
+  if (iter != members_.end()) {
+    std::vector<symbol>& keys = iter->second;
+    keys.erase(std::remove(keys.begin(), keys.end(), key), keys.end());
+    if (keys.empty())
+      members_.erase(iter);
+  }
+  table_.erase(key);
+}
+
+// -----< private - does name name a class, struct or interface? >--------
+bool SymbolTable::isType(const symbol & name) const
+{
+  const Definition* pDef = find(name);
+  if (pDef != nullptr && pDef->type_ != "function")
+    return true;
+  auto iter = members_.find(name);   // nested in another class
+  if (iter == members_.end())
+    return false;
+  for (const auto& key : iter->second) {
+    if (find(key)->type_ != "function")
+      return true;
+  }
+  return false;
+}
+
+// -----< relative link to the page and line of a definition >------------
+/* pages are all written to the same output directory, so the link only
+   needs the page name and the line anchor, e.g., Converter.h.html#L51 */
+std::string SymbolTable::linkTo(const symbol & name) const
+{
+  const Definition* pDef = find(name);
+  if (pDef == nullptr)
+    return "";
+  return linkTo(*pDef);
+}
+
+std::string SymbolTable::linkTo(const Definition & def)
+{
+  return FileSystem::Path::getName(def.file_) + ".html#L" + std::to_string(def.line_);
+}
+
+// -----< begin() iterator - allows for loop >-----------------------------
+SymbolTable::iterator SymbolTable::begin()
+{
+  return table_.begin();
+}
+
+// -----< end() iterator - allows for loop >-------------------------------
+SymbolTable::iterator SymbolTable::end()
+{
+  return table_.end();
+}
+
+// -----< display entire table in formatted way >--------------------------
+void SymbolTable::display()
+{
+  std::cout << "\n  Symbol table:";
+  for (auto& entry : table_) {
+    std::cout << "\n  -- " << entry.first << " (" << entry.second.type_ << ")";
+    std::cout << "\n   -> " << entry.second.file_ << " : " << entry.second.line_;
+  }
+}
+
+// -----< private - lambdas and operators are not linkable names >---------
+bool SymbolTable::isIdentifier(const symbol & name)
+{
+  if (name.size() == 0 || std::isdigit((unsigned char)name[0]))
+    return false;
+  for (char ch : name) {
+    if (!std::isalnum((unsigned char)ch) && ch != '_')
+      return false;
+  }
+  return true;
+}
+
+
+#ifdef TEST_SYMBOLTABLE
+
+#include <iostream>
+#include <iomanip>
+
+// ----< test stub for symbol table package >-------------------------------
+int main(int argc, char ** argv) {
+  std::cout << "Testing SymbolTable Operations";
+
+  SymbolTable st;
+  st.getFileSymbols("SymbolTable.h");
+  st.getFileSymbols("SymbolTable.cpp");
+  st.display();
+
+  std::cout << "\n\n  link to SymbolTable: " << st.linkTo("SymbolTable");
+  std::cout << "\n  link to unknown:     " << st.linkTo("unknown");
+
+  auto show = [&](const std::string& qualifier, const std::string& name) {
+    const SymbolTable::Definition* pDef = st.lookup(name, qualifier);
+    std::cout << "\n  " << std::setw(14) << std::left << (qualifier.size() > 0 ? qualifier + "::" : "")
+      << std::setw(8) << name << " -> " << (pDef != nullptr ? SymbolTable::linkTo(*pDef) : "not linked");
+  };
+  std::cout << "\n\n  identifiers looked up with the qualifier before them:";
+  show("SymbolTable", "clear");   // the member
+  show("", "clear");              // only SymbolTable defines it
+  show("std", "find");            // std is no class here, find is a member
+  show("Definition", "find");     // a class without a member named find
+
+  std::cout << "\n\n  names changed by parsing SymbolTable.cpp again: ";
+  std::cout << st.updateFile("SymbolTable.cpp").size();
+  std::cout << "\n  names changed by removing SymbolTable.h: ";
+  for (auto& name : st.removeFile("SymbolTable.h"))
+    std::cout << name << " ";
+  std::cout << "\n\n";
+  return 0;
+}
+
+#endif
@@ -0,0 +1,136 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////
+// SymbolTable.h : defines cross-reference symbol table                  //
+// ver 1.5                                                               //
+//                                                                       //
+// Author:      Sneha Giranje					                                   //
+///////////////////////////////////////////////////////////////////////////
+/*
+*  Package Operations:
+* =======================
+*  This package defines SymbolTable class which holds the definitions of
+*  classes, structs, interfaces and functions found in all the files of a
+*  publish. It is a wrapper around std::unordered_map keyed by qualified
+*  name - Class::member for members, the name alone at namespace scope -
+*  so that the converter can turn each identifier it writes into a link
+*  to the page and line of its definition with a hashed lookup or two,
+*  keeping the linking pass linear in the number of tokens.  lookup
+*  takes the qualifier written before an identifier, if any, so that
+*  std::find or Other::clear don't link to a member of an unrelated
+*  class of the same name.
+*
+*  The definitions of each file are kept too, in the order files were
+*  added, so one file can be parsed again, or removed, without parsing
+*  the others.  updateFile and removeFile settle again only the names the
+*  file defines, or used to, and return those whose definition changed,
+*  so a client knows which pages link to a moved definition.
+*
+*  Public Interface
+* =======================
+*  SymbolTable st(files);
+*  addDefinition(name, definition);
+*  has(name);
+*  find(name);                     // by key, e.g. SymbolTable::find
+*  lookup(name, qualifier);         // what an identifier written so names
+*  SymbolTable::nameOf(key);        // key without its class
+*  getFileSymbols(filename);
+*  addSymbols(pGlobalScope, filename);
+*  updateFile(filename);            // parse again, names that changed
+*  removeFile(filename);
+*  linkTo(name);
+*  display();
+*
+*  Required Files:
+* =======================
+*  SymbolTable.h SymbolTable.cpp AbstrSynTree.h ConfigureParser.h
+*  ActionsAndRules.h Utilities.h Parser.h FileSystem.h PerfStats.h
+*
+*  Maintainence History:
+* =======================
+*  ver 1.5 - 19 Oct 2026
+*  - definitions are keyed by qualified name, and added lookup, which
+*    resolves an identifier by the qualifier written before it
+*  ver 1.4 - 19 Oct 2026
+*  - a definition's line is the line of its name, not of its opening
+*    brace, so links land on the declaration and the converter can tell
+*    a definition's own name from a use of it
+*  ver 1.3 - 19 Oct 2026
+*  - definitions are kept per file, and added updateFile and removeFile
+*  ver 1.2 - 19 Oct 2026
+*  - getFileSymbols is timed as PerfStats' symbols stage
+*  ver 1.1 - 19 Oct 2026
+*  - getFileSymbols leases a parser from the thread's ParserPool instead
+*    of building a new one for every file
+*  ver 1.0 - 19 Oct 2026
+*  - first release
+*/
+
+#include <unordered_map>
+#include <string>
+#include <vector>
+#include <utility>
+
+namespace CodeAnalysis { struct ASTNode; }
+
+class SymbolTable
+{
+public:
+  using symbol = std::string;
+  using file = std::string;
+  using files = std::vector<file>;
+
+  struct Definition
+  {
+    file file_;         // full path of defining file
+    std::string type_;  // class, struct, interface, or function
+    size_t line_ = 0;   // line of the definition's name
+    std::string scope_; // class of a member, "" at namespace scope
+  };
+
+  using iterator = std::unordered_map<symbol, Definition>::iterator;
+
+  SymbolTable();
+  SymbolTable(const files& list);
+
+  bool has(const symbol& name) const;
+  const Definition* find(const symbol& name) const;
+  const Definition* lookup(const symbol& name, const symbol& qualifier = "") const;
+  static symbol nameOf(const symbol& key);
+
+  void addDefinition(const symbol& name, const Definition& def);
+  void getFileSymbols(file filename);
+  void addSymbols(CodeAnalysis::ASTNode* pGlobalScope, const file& filename);
+
+  std::vector<symbol> updateFile(const file& filename);
+  std::vector<symbol> removeFile(const file& filename);
+
+  std::string linkTo(const symbol& name) const;
+  static std::string linkTo(const Definition& def);
+
+  iterator begin();
+  iterator end();
+  size_t size() const { return table_.size(); }
+  void clear();
+
+  void display();
+
+private:
+  using fileDefinitions = std::vector<std::pair<symbol, Definition>>;
+
+  static bool isIdentifier(const symbol& name);
+  bool parseFile(const file& filename, fileDefinitions& defs);
+  void collect(CodeAnalysis::ASTNode* pGlobalScope, const file& filename, fileDefinitions& defs);
+  size_t fileId(const file& filename);
+  void index(size_t id);
+  std::vector<symbol> unindex(size_t id);
+  std::vector<symbol> settle(const std::vector<symbol>& names);
+  void put(const symbol& key, const Definition& def);
+  void drop(const symbol& key);
+  bool isType(const symbol& name) const;
+
+  std::unordered_map<symbol, Definition> table_;
+  std::unordered_map<file, size_t> ids_;               // position in files added
+  std::vector<fileDefinitions> byFile_;                // by id
+  std::unordered_map<symbol, std::vector<size_t>> definedIn_;  // ids, ascending
+  std::unordered_map<symbol, std::vector<symbol>> members_;    // name to keys in table_
+};
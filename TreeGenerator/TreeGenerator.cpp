@@ -0,0 +1,282 @@
+///////////////////////////////////////////////////////////////////////////
+// TreeGenerator.cpp : writes synthetic C++ source trees                 //
+// ver 1.0                                                               //
+//                                                                       //
+// Author:      Sneha Giranje					                         //
+///////////////////////////////////////////////////////////////////////////
+
+#include "TreeGenerator.h"
+#include "../CppParser/FileSystem/FileSystem.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+
+using namespace FileSystem;
+
+namespace Scaling
+{
+	namespace
+	{
+		std::string moduleName(size_t module)
+		{
+			return "mod" + std::to_string(module);
+		}
+
+		std::string className(size_t module, size_t index)
+		{
+			return "Class" + std::to_string(module) + "_" + std::to_string(index);
+		}
+
+		// -----< body of a function, one of a few shapes picked by rng >------
+		void writeBody(std::ostringstream& out, std::mt19937& rng)
+		{
+			switch (rng() % 4)
+			{
+			case 0:
+				out << "\t\tint total = 0;\n"
+					"\t\tfor (int i = 0; i < value; ++i)\n\t\t{\n"
+					"\t\t\tif (i % 3 == 0)\n\t\t\t\ttotal += i;  // every third\n"
+					"\t\t\telse\n\t\t\t\ttotal -= 1;\n\t\t}\n"
+					"\t\treturn total;\n";
+				break;
+			case 1:
+				out << "\t\tstd::vector<int> values;\n"
+					"\t\twhile (value > 0)\n\t\t{\n"
+					"\t\t\tvalues.push_back(value % 10);\n\t\t\tvalue /= 10;\n\t\t}\n"
+					"\t\treturn (int)values.size();\n";
+				break;
+			case 2:
+				out << "\t\t/* map a value onto a small range */\n"
+					"\t\tswitch (value & 3)\n\t\t{\n"
+					"\t\tcase 0: return value * 2;\n\t\tcase 1: return value + 7;\n"
+					"\t\tdefault: break;\n\t\t}\n"
+					"\t\treturn value < 0 ? -value : value;\n";
+				break;
+			default:
+				out << "\t\tstd::string text = \"value: \" + std::to_string(value);\n"
+					"\t\tif (text.size() > 8 && text[0] == 'v')\n\t\t{\n"
+					"\t\t\ttry\n\t\t\t{\n\t\t\t\treturn std::stoi(text.substr(7));\n\t\t\t}\n"
+					"\t\t\tcatch (std::exception&)\n\t\t\t{\n\t\t\t\treturn 0;\n\t\t\t}\n\t\t}\n"
+					"\t\treturn (int)text.size();\n";
+			}
+		}
+	}
+
+	// -----< parse /name value options, false on an unknown one >----------
+	bool TreeOptions::parse(int argc, char* argv[], int first)
+	{
+		for (int i = first; i < argc; ++i)
+		{
+			std::string option = argv[i];
+			if (i + 1 == argc)
+				return false;
+			size_t value = 0;
+			try {
+				value = std::stoul(argv[++i]);
+			}
+			catch (std::exception&) {
+				return false;
+			}
+			if (option == "/files") files = value;
+			else if (option == "/bytes") fileBytes = value;
+			else if (option == "/depth") depth = value;
+			else if (option == "/top") topDirs = std::max<size_t>(value, 1);
+			else if (option == "/fanout") dirFanOut = std::max<size_t>(value, 1);
+			else if (option == "/classes") classesPerFile = value;
+			else if (option == "/functions") functionsPerClass = value;
+			else if (option == "/includes") includeFanOut = value;
+			else if (option == "/seed") seed = (unsigned)value;
+			else return false;
+		}
+		return true;
+	}
+
+	// -----< ctor - lays out the directories >------------------------------
+	TreeGenerator::TreeGenerator(const TreeOptions& options) : options_(options)
+	{
+		for (size_t i = 0; i < options_.topDirs; ++i)
+			addDirs("t" + std::to_string(i), 0);
+	}
+
+	// -----< private - directory and its subtree, leaves at depth >---------
+	void TreeGenerator::addDirs(const std::string& dir, size_t level)
+	{
+		dirs_.push_back(dir);
+		if (level == options_.depth)
+		{
+			leaves_.push_back(dir);
+			return;
+		}
+		for (size_t i = 0; i < options_.dirFanOut; ++i)
+			addDirs(dir + "/d" + std::to_string(i), level + 1);
+	}
+
+	const std::vector<std::string>& TreeGenerator::leafDirs() const
+	{
+		return leaves_;
+	}
+
+	// -----< modules included by a header, all numbered lower >-------------
+	std::vector<size_t> TreeGenerator::includes(size_t module) const
+	{
+		std::vector<size_t> result;
+		size_t count = std::min(options_.includeFanOut, module);
+		if (count == module)
+		{
+			for (size_t i = 0; i < module; ++i)
+				result.push_back(i);
+			return result;
+		}
+		std::mt19937 rng(options_.seed * 7919u + (unsigned)module);
+		while (result.size() < count)
+		{
+			size_t pick = rng() % module;
+			if (std::find(result.begin(), result.end(), pick) == result.end())
+				result.push_back(pick);
+		}
+		std::sort(result.begin(), result.end());
+		return result;
+	}
+
+	// -----< text of modN.h - class declarations >--------------------------
+	std::string TreeGenerator::header(size_t module) const
+	{
+		std::string name = moduleName(module);
+		std::string guard = "MOD" + std::to_string(module) + "_H";
+		std::ostringstream out;
+		out << "/////////////////////////////////////////////////////////////////////\n"
+			<< "// " << name << ".h - generated by TreeGenerator\n"
+			<< "/////////////////////////////////////////////////////////////////////\n"
+			<< "#ifndef " << guard << "\n#define " << guard << "\n\n";
+		for (size_t dep : includes(module))
+			out << "#include \"" << moduleName(dep) << ".h\"\n";
+		out << "#include <string>\n#include <vector>\n\nnamespace " << name << "\n{\n";
+		for (size_t c = 0; c < options_.classesPerFile; ++c)
+		{
+			std::string cls = className(module, c);
+			out << "\t///////////////////////////////////////////////////////////////////\n"
+				<< "\t// " << cls << " class\n\n"
+				<< "\tclass " << cls << "\n\t{\n\tpublic:\n"
+				<< "\t\t" << cls << "();\n";
+			for (size_t f = 0; f < options_.functionsPerClass; ++f)
+				out << "\t\tint function" << f << "(int value) const;\n";
+			out << "\t\tstd::string name() const { return name_; }\n"
+				<< "\tprivate:\n\t\tstd::string name_;\n\t\tstd::vector<int> values_;\n\t};\n\n";
+		}
+		out << "}\n#endif\n";
+		return out.str();
+	}
+
+	// -----< text of modN.cpp - member definitions, then helpers to size >--
+	std::string TreeGenerator::source(size_t module) const
+	{
+		std::mt19937 rng(options_.seed * 104729u + (unsigned)module);
+		std::string name = moduleName(module);
+		std::ostringstream out;
+		out << "/////////////////////////////////////////////////////////////////////\n"
+			<< "// " << name << ".cpp - generated by TreeGenerator\n"
+			<< "/////////////////////////////////////////////////////////////////////\n\n"
+			<< "#include \"" << name << ".h\"\n#include <iostream>\n\nnamespace " << name << "\n{\n";
+		for (size_t c = 0; c < options_.classesPerFile; ++c)
+		{
+			std::string cls = className(module, c);
+			out << "\t//----< constructor >----------------------------------------------\n\n"
+				<< "\t" << cls << "::" << cls << "() : name_(\"" << cls << "\") {}\n\n";
+			for (size_t f = 0; f < options_.functionsPerClass; ++f)
+			{
+				out << "\t//----< function " << f << " >---------------------------------------\n\n"
+					<< "\tint " << cls << "::function" << f << "(int value) const\n\t{\n";
+				writeBody(out, rng);
+				out << "\t}\n\n";
+			}
+		}
+		for (size_t h = 0; (size_t)out.tellp() + 16 < options_.fileBytes; ++h)
+		{
+			out << "\t//----< helper " << h << " >-----------------------------------------\n\n"
+				<< "\tint helper" << h << "(int value)\n\t{\n";
+			writeBody(out, rng);
+			out << "\t}\n\n";
+		}
+		out << "}\n";
+		return out.str();
+	}
+
+	// -----< private - create path and any missing parents >----------------
+	/* checks for the directory afterwards, rather than trusting the
+	   return of Directory::create */
+	bool TreeGenerator::createDir(const std::string& path)
+	{
+		for (size_t pos = path.find_first_of("/\\", 1); ; pos = path.find_first_of("/\\", pos + 1))
+		{
+			std::string dir = path.substr(0, pos);
+			if (dir.size() > 0 && dir.back() != ':' && dir != ".." && dir != "." && !Directory::exists(dir))
+				Directory::create(dir);
+			if (pos == std::string::npos)
+				break;
+		}
+		return Directory::exists(path);
+	}
+
+	// -----< write the tree below root >------------------------------------
+	TreeSummary TreeGenerator::generate(const std::string& root)
+	{
+		TreeSummary summary;
+		if (!createDir(root))
+		{
+			std::cout << "\n  Error -- unable to create " << root;
+			return summary;
+		}
+		for (const std::string& dir : dirs_)
+		{
+			if (!createDir(Path::fileSpec(root, dir)))
+			{
+				std::cout << "\n  Error -- unable to create " << Path::fileSpec(root, dir);
+				return summary;
+			}
+		}
+		summary.dirs = dirs_.size();
+
+		size_t modules = (options_.files + 1) / 2;
+		for (size_t m = 0; m < modules; ++m)
+		{
+			std::string dir = Path::fileSpec(root, leaves_[m % leaves_.size()]);
+			std::string path = Path::fileSpec(dir, moduleName(m));
+			std::string text = header(m);
+			std::ofstream(path + ".h", std::ios::binary) << text;
+			summary.bytes += text.size();
+			++summary.files;
+			if (summary.files == options_.files)
+				break;
+			text = source(m);
+			std::ofstream(path + ".cpp", std::ios::binary) << text;
+			summary.bytes += text.size();
+			++summary.files;
+		}
+		return summary;
+	}
+}
+
+#ifdef TEST_TREEGENERATOR
+
+using namespace Scaling;
+
+// -----< generator main - writes one tree >----------------------------------
+int main(int argc, char* argv[])
+{
+	TreeOptions options;
+	if (argc < 2 || !options.parse(argc, argv, 2))
+	{
+		std::cout << "\n  usage: TreeGenerator root [/files n] [/bytes n] [/depth n] [/top n]"
+			<< "\n                        [/fanout n] [/classes n] [/functions n] [/includes n] [/seed n]\n\n";
+		return 1;
+	}
+	std::cout << "\n  Generating " << options.files << " files below " << argv[1];
+	TreeSummary summary = TreeGenerator(options).generate(argv[1]);
+	std::cout << "\n  Wrote " << summary.files << " files, " << summary.bytes << " bytes, in "
+		<< summary.dirs << " directories\n\n";
+	return summary.files == options.files ? 0 : 1;
+}
+
+#endif
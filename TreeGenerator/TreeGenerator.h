@@ -0,0 +1,103 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////
+// TreeGenerator.h : writes synthetic C++ source trees for scaling tests //
+// ver 1.0                                                               //
+//                                                                       //
+// Application   : Project Code Publisher                                //
+// Author        : Sneha Giranje                  						 //
+///////////////////////////////////////////////////////////////////////////
+/*
+*  Package Operations:
+* =======================
+*  This package defines TreeGenerator, which writes a tree of C++ files
+*  shaped by TreeOptions: how many files, about how large each is, how
+*  deep the directories nest, how many classes and member functions a
+*  file holds, and how many other headers each file includes.
+*
+*  Files come in pairs, modN.h declaring classes and modN.cpp defining
+*  their members, spread evenly over the leaf directories.  The tree
+*  has topDirs top level directories, each the root of a subtree
+*  dirFanOut wide and depth levels deep, so a scaling harness can
+*  share the top level directories among threads.  Each header includes
+*  includeFanOut headers of lower numbered modules, so the includes form
+*  a graph without cycles, and every name in an include is unique.
+*
+*  Output depends only on the options, seed included, so a tree of a
+*  given size can be generated again to compare two runs.
+*
+*  Public Interface:
+* =======================
+*  TreeOptions options;
+*  options.files = 10000;
+*  TreeGenerator gen(options);
+*  TreeSummary summary = gen.generate("../scaling/tree_10000");
+*  std::string header = gen.header(7);       // text of mod7.h
+*
+*  Required Files:
+* =======================
+*  TreeGenerator.h TreeGenerator.cpp FileSystem.h FileSystem.cpp
+*
+*  Build Process:
+* =======================
+*  The TreeGenerator project defines TEST_TREEGENERATOR, building:
+*  TreeGenerator root [/files n] [/bytes n] [/depth n] [/top n] [/fanout n]
+*                     [/classes n] [/functions n] [/includes n] [/seed n]
+*
+*  Maintainence History:
+* =======================
+*  ver 1.0 - 19 Oct 2026
+*  - first release
+*/
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace Scaling
+{
+	struct TreeOptions
+	{
+		size_t files = 1000;             // .h and .cpp files together
+		size_t fileBytes = 4096;         // approximate size of a .cpp file
+		size_t depth = 2;                // directory levels below a top directory
+		size_t topDirs = 8;
+		size_t dirFanOut = 4;            // subdirectories of each directory
+		size_t classesPerFile = 2;
+		size_t functionsPerClass = 4;
+		size_t includeFanOut = 4;        // headers included by each header
+		unsigned seed = 1;
+
+		bool parse(int argc, char* argv[], int first = 1);  // /files n ... options
+	};
+
+	struct TreeSummary
+	{
+		size_t files = 0;
+		size_t dirs = 0;
+		uint64_t bytes = 0;
+	};
+
+	///////////////////////////////////////////////////////////////////////
+	// TreeGenerator class
+	// - writes the tree described by its options
+
+	class TreeGenerator
+	{
+	public:
+		TreeGenerator(const TreeOptions& options);
+
+		TreeSummary generate(const std::string& root);
+		std::string header(size_t module) const;
+		std::string source(size_t module) const;
+		std::vector<size_t> includes(size_t module) const;
+		const std::vector<std::string>& leafDirs() const;  // relative to root
+
+	private:
+		void addDirs(const std::string& dir, size_t level);
+		static bool createDir(const std::string& path);
+
+		TreeOptions options_;
+		std::vector<std::string> dirs_;      // all of them, parents first
+		std::vector<std::string> leaves_;
+	};
+}